@@ -99,6 +99,126 @@
  */
 #define NETWORK_TASK_CORE 0
 
+/**
+ * @brief RS485 Worker Task
+ *
+ * RS485Manager and the bridge worker state machine run in their own task,
+ * exchanging requests and responses with the network side through
+ * lock-free rings. Set RS485_WORKER_TASK_ENABLED to 0 to run them from the
+ * main loop instead.
+ */
+#define RS485_WORKER_TASK_ENABLED 1  ///< Run RS485 + bridge worker in a dedicated task
+#define RS485_WORKER_TASK_CORE 1     ///< Core for the RS485 worker task (-1 = no pinning)
+#define RS485_WORKER_TASK_PRIORITY 3 ///< Above loopTask (1) so bus timing is not starved
+#define RS485_WORKER_TASK_STACK 8192 ///< Stack size in bytes
+#define RS485_WORKER_IDLE_WAIT_MS 2  ///< Max sleep between worker steps without RX events
+
+/**
+ * @brief Bridge Read Coalescing
+ *
+ * Reads queued by several clients share bus transactions: identical reads
+ * ride on one in flight, and reads that touch or overlap are merged into
+ * one bus read widened to whole register banks. Each client still gets
+ * exactly the range it asked for.
+ */
+#define BRIDGE_SINGLE_FLIGHT 1   ///< Identical queued reads share one RS485 transaction
+#define BRIDGE_READ_MERGE 1      ///< Adjacent/overlapping queued reads share one bus read
+#define BRIDGE_MERGE_WINDOW_MS 0 ///< Hold a lone queued read for merge partners (0 = off)
+#define BRIDGE_BANK_ALIGN 1      ///< Widen bus reads to whole canonical register banks
+#define BRIDGE_BANK_SIZE 40      ///< Canonical bank size (Luxpower polls 40-register blocks)
+
+/**
+ * @brief Write Combining
+ *
+ * Queued single-register writes to the same or neighbouring registers go
+ * out as one bus write; each client is acknowledged with its own value.
+ */
+#define BRIDGE_WRITE_COMBINE 1      ///< Fold queued 0x06 writes into one 0x06/0x10 bus write
+#define BRIDGE_WRITE_COMBINE_MAX 16 ///< Registers one combined write may span
+
+/**
+ * @brief Poll Prefetch
+ *
+ * The bridge learns each client's poll cadence and reads the polled banks
+ * just before they are asked for, so the poll is answered from the cache.
+ */
+#define BRIDGE_PREFETCH 1           ///< Learn client poll cadence, read banks just before polls
+#define PREFETCH_LEAD_MS 400        ///< Prefetch this long before the predicted poll
+#define PREFETCH_MIN_CONFIDENCE 3   ///< Matching poll intervals before a pattern is prefetched
+#define PREFETCH_MIN_PERIOD_MS 1000 ///< Shorter repeats of a read are not separate polls
+#define PREFETCH_BACKOFF_MS 10000   ///< No prefetching this long after foreign-master traffic
+
+/**
+ * @brief Bridge Scheduling
+ *
+ * Queued requests go to the bus by priority rather than arrival, and a
+ * request its client has already given up on is answered busy instead of
+ * being sent. Client timeouts are learned from their retries.
+ */
+#define BRIDGE_PRIORITY_SCHEDULING 1 ///< Writes, then interactive reads, then bank polls/prefetch
+#define BRIDGE_BULK_READ_REGS 32     ///< Reads of at least this many registers are bank polls
+#define CLIENT_PATIENCE_MS 5000      ///< Assumed client response timeout until one is observed
+#define CLIENT_PATIENCE_MIN_MS 1000  ///< Re-sends sooner than this are pipelining, not retries
+#define CLIENT_PATIENCE_MAX_MS 15000 ///< Upper bound for the learned client timeout
+#define BRIDGE_DEADLINE_GUARD_MS 300 ///< Drop a queued request with less than this left to go
+
+/**
+ * @brief Circuit Breaker
+ *
+ * After repeated bus timeouts, reads are answered from the cache or with a
+ * gateway exception at once, until a periodic probe is answered again.
+ */
+#define BRIDGE_CIRCUIT_BREAKER 1    ///< Fail fast while the inverter does not answer
+#define BREAKER_TIMEOUT_THRESHOLD 3 ///< Consecutive bus timeouts that open the breaker
+#define BREAKER_OPEN_MS 5000        ///< Open time before one request may probe the bus
+
+/**
+ * @brief Bridge Queue and Fair Queuing
+ *
+ * The request queue grows with free heap, and each connected client may
+ * hold an equal share of it for reads.
+ */
+#define BRIDGE_FAIR_QUEUING 1     ///< Equal queue share and round-robin dispatch per client
+#define BRIDGE_QUEUE_MIN_DEPTH 4  ///< Bridge queue depth when the heap is tight
+#define BRIDGE_QUEUE_MAX_DEPTH 16 ///< Bridge queue slots (power of two)
+#define QUEUE_HEAP_RESERVE 32768  ///< Free heap kept before the queue grows past the minimum
+#define QUEUE_HEAP_PER_SLOT 2048  ///< Heap budgeted per queued request (buffers + TCP send)
+
+/**
+ * @brief Read Cache
+ *
+ * Reads younger than their TTL are answered without touching the bus.
+ * Past the TTL, stale data is still served while a background read
+ * refreshes it.
+ */
+#define BRIDGE_CACHE_FIRST 1       ///< Answer reads younger than their TTL from the cache
+#define CACHE_TTL_INPUT_MS 1500    ///< Cache-first TTL for live data (input regs, clock)
+#define CACHE_TTL_HOLDING_MS 15000 ///< Cache-first TTL for settings (holding regs)
+#define CACHE_SWR_ENABLED 1        ///< Serve reads past their TTL, refresh in the background
+#define CACHE_SWR_TTL_FACTOR 4     ///< Hard TTL (stale still served) as a multiple of the TTL
+
+/**
+ * @brief Register Shadow
+ *
+ * Every register read or written is kept per function code. The shadow
+ * backs the read cache and the timeout fallback, and its span follows free
+ * heap.
+ */
+#define SHADOW_REGISTER_COUNT 512 ///< Registers shadowed per table with heap to spare
+#define SHADOW_MIN_REGISTERS 256  ///< Registers per table kept however tight the heap is
+#define SHADOW_HEAP_RESERVE 49152 ///< Free heap kept before the shadow grows past the minimum
+#define SHADOW_RESIZE_MS 10000    ///< How often the shadow span is fitted to free heap
+
+/**
+ * @brief Negative Cache
+ *
+ * Read ranges the inverter refused with a Modbus exception are answered
+ * with the same exception locally for a while.
+ */
+#define NEGATIVE_CACHE_ENABLED 1     ///< Answer reads known to raise an exception locally
+#define NEGATIVE_CACHE_TTL_MS 600000 ///< How long a refused read range is remembered
+#define NEGATIVE_CACHE_SIZE 8        ///< Refused read ranges remembered
+
 /**
  * @brief WiFi TX Power
  *
@@ -285,7 +405,10 @@
 #define RS485_PROBE_BACKOFF_BASE_MS 5000           ///< Initial backoff for RS485 probe retry
 #define RS485_PROBE_BACKOFF_MAX_MS (5 * 60 * 1000) ///< Max backoff for RS485 probe retry
 #define RS485_UART_RX_BUFFER_SIZE 1024 ///< UART RX ring buffer for full 125-register frames
+#define RS485_UART_TX_BUFFER_SIZE 512  ///< UART TX ring so write() never waits for the FIFO
 #define RS485_MIN_REQUEST_GAP_MS 120   ///< Quiet time between serialized RS485 requests
+#define RS485_RX_IDLE_SYMBOLS 4        ///< UART RX timeout (character times) marking a frame end
+#define RS485_TIMEOUT_QUIET_MS 10      ///< Bus left alone after a response timeout (non-blocking)
 #define RS485_FOREIGN_IDLE_TAIL_MS \
     450 ///< Idle-tail: bus stays "busy" until the line is quiet this long after a foreign frame.
         ///< Bridges the foreign request->response turnaround so we never transmit into the gap.
@@ -27,6 +27,7 @@
 #include "modules/ntp_manager.h"
 #include "modules/protocol_bridge.h"
 #include "modules/rs485_manager.h"
+#include "modules/rs485_port.h"
 #include "modules/system_manager.h"
 #include "modules/tcp_server.h"
 
@@ -62,6 +63,7 @@ SystemManager& sys = SystemManager::getInstance();
 NetworkManager& network = NetworkManager::getInstance();
 NTPManager& ntp = NTPManager::getInstance();
 RS485Manager& rs485 = RS485Manager::getInstance();
+UartRS485Port rs485_port;
 TCPServer& tcp_server = TCPServer::getInstance();
 ProtocolBridge& bridge = ProtocolBridge::getInstance();
 
@@ -154,8 +156,10 @@ void loop() {
     ntp.loop();
 #endif
 
-    // Update RS485 manager (handles timeouts and parsing)
-    rs485.loop();
+    // Update RS485 manager (handles timeouts and parsing) unless its task owns it
+    if (!bridge.has_worker_task()) {
+        rs485.loop();
+    }
 
     // Update TCP server (handles client connections)
     tcp_server.loop();
@@ -441,11 +445,19 @@ void setupRS485() {
     LOGI(TAG, "Initializing RS485...");
 
     // Initialize RS485
-    rs485.begin(Serial1, RS485_TX_PIN, RS485_RX_PIN, RS485_DE_PIN, RS485_BAUD_RATE);
+    rs485_port.begin(Serial1, RS485_TX_PIN, RS485_RX_PIN, RS485_DE_PIN, RS485_BAUD_RATE);
+    rs485.begin(rs485_port);
 
     // Read inverter serial to validate RS485 link
     // rs485.probe_inverter_serial();
 
+#if RS485_WORKER_TASK_ENABLED
+    // From here on the RS485 bus and the bridge worker run in their own task;
+    // requests start flowing once the bridge is set up on network connect.
+    bridge.set_rs485_manager(&rs485);
+    bridge.start_worker_task();
+#endif
+
     LOGI(TAG, "✓ RS485 initialized");
     Serial.println();
 }
@@ -131,6 +131,8 @@ void CommandManager::registerCoreCommands() {
                         msg += String(rs.get_ignored_packets());
                         msg += " EXTERNAL#";
                         msg += String(rs.get_external_requests_detected());
+                        msg += " EARLY#";
+                        msg += String(rs.get_early_completions());
                         msg += "]";
                         msg += "\nRS485 SN: ";
                         msg += rs.get_detected_inverter_serial();
@@ -278,6 +280,35 @@ void CommandManager::registerCoreCommands() {
                         msg += String(bridge.get_queue_drops());
                         msg += " client_gone=";
                         msg += String(bridge.get_client_gone_count());
+                        msg += " coalesced=";
+                        msg += String(bridge.get_coalesced_requests());
+                        msg += " merged=";
+                        msg += String(bridge.get_merged_requests());
+                        msg += "(refused ";
+                        msg += String(bridge.get_merge_refusals());
+                        msg += ")";
+                        msg += " bank_aligned=";
+                        msg += String(bridge.get_bank_aligned_reads());
+                        msg += "(+";
+                        msg += String(bridge.get_bank_padding_registers());
+                        msg += " regs, refused ";
+                        msg += String(bridge.get_bank_refusals());
+                        msg += ")";
+                        msg += " writes_combined=";
+                        msg += String(bridge.get_combined_writes());
+                        msg += "/";
+                        msg += String(bridge.get_superseded_writes());
+                        msg += " breaker=";
+                        msg += bridge.get_breaker_state_name();
+                        msg += "(opens ";
+                        msg += String(bridge.get_breaker_opens());
+                        msg += ", fast ";
+                        msg += String(bridge.get_breaker_fast_fails());
+                        msg += ")";
+                        msg += " reordered=";
+                        msg += String(bridge.get_reordered_requests());
+                        msg += " expired=";
+                        msg += String(bridge.get_deadline_drops());
                         msg += " last=#";
                         msg += String(bridge.get_last_finished_request_id());
                         msg += "/";
@@ -642,18 +673,20 @@ void CommandManager::registerCoreCommands() {
     // ========== Cache Commands ==========
 
     // cache_status: show fallback cache statistics
-    registerCommand("cache_status", "Show fallback cache statistics (hits, misses, size)",
+    registerCommand("cache_status", "Show cache and prefetch statistics",
                     [](const std::vector<String>&) -> CommandResult {
                         auto& bridge = ProtocolBridge::getInstance();
 
                         String out;
-                        out.reserve(200);
+                        out.reserve(512);
                         out += "Fallback Cache Status:\n";
                         out += "  Size: ";
                         out += String(bridge.get_cache_size());
                         out += " / ";
                         out += String(bridge.get_cache_capacity());
-                        out += " entries\n";
+                        out += " registers (";
+                        out += String(bridge.get_cache_resizes());
+                        out += " heap resizes)\n";
                         out += "  Hits: ";
                         out += String(bridge.get_cache_hits());
                         out += "\n  Misses: ";
@@ -663,8 +696,49 @@ void CommandManager::registerCoreCommands() {
                         out += "%\n";
                         out += "  Evictions: ";
                         out += String(bridge.get_cache_invalidations());
-
-                        uint32_t total = bridge.get_cache_hits() + bridge.get_cache_misses();
+                        out += "\n  Write-through: ";
+                        out += String(bridge.get_cache_write_updates());
+                        out += " registers";
+                        out += "\nCache-first:\n";
+                        out += "  Hits: ";
+                        out += String(bridge.get_cache_first_hits());
+                        out += "\n  Misses: ";
+                        out += String(bridge.get_cache_first_misses());
+                        out += "\n  Hit age: avg ";
+                        out += String(bridge.get_cache_first_avg_age_ms());
+                        out += "ms, max ";
+                        out += String(bridge.get_cache_first_max_age_ms());
+                        out += "ms\n  Stale served: ";
+                        out += String(bridge.get_cache_stale_hits());
+                        out += " (refreshes ";
+                        out += String(bridge.get_stale_refreshes());
+                        out += ")";
+
+                        const PollPredictor& predictor = bridge.get_poll_predictor();
+                        out += "\nPrefetch:\n";
+                        out += "  Patterns: ";
+                        out += String(predictor.get_confident_count());
+                        out += " confident / ";
+                        out += String(predictor.get_pattern_count());
+                        out += " tracked (admitted ";
+                        out += String(predictor.get_admissions());
+                        out += ", rejected as one-off ";
+                        out += String(predictor.get_admission_rejects());
+                        out += ")\n  Prediction accuracy: ";
+                        out += String(predictor.get_prediction_hits());
+                        out += "/";
+                        out += String(predictor.get_predictions());
+                        out += "\n  Prefetches: ";
+                        out += String(predictor.get_prefetches());
+                        out += " (used ";
+                        out += String(predictor.get_prefetch_used());
+                        out += ", wasted ";
+                        out += String(predictor.get_prefetch_wasted());
+                        out += ")";
+
+                        uint32_t total = bridge.get_cache_hits() + bridge.get_cache_misses() +
+                                         bridge.get_cache_first_hits() +
+                                         bridge.get_cache_first_misses();
                         if (total == 0) {
                             out += "\n\n[No cache activity yet]";
                         }
@@ -680,8 +754,35 @@ void CommandManager::registerCoreCommands() {
                         return CommandResult{true, "Fallback cache cleared"};
                     });
 
-    // cache_info: show detailed cache entry info
-    registerCommand("cache_info", "Show detailed fallback cache entries",
+    // exception_cache [clear]
+    registerCommand("exception_cache",
+                    "List reads answered locally with a known exception (add 'clear' to reset)",
+                    [](const std::vector<String>& args) -> CommandResult {
+                        auto& bridge = ProtocolBridge::getInstance();
+                        if (!args.empty() && args[0].equalsIgnoreCase("clear")) {
+                            const size_t dropped = bridge.clear_negative_cache();
+                            return CommandResult{true, "Exception cache cleared (" +
+                                                           String(dropped) + " entries)"};
+                        }
+
+                        String out;
+                        out.reserve(512);
+                        out += "Exception cache: ";
+                        out += String(bridge.get_negative_cache_size());
+                        out += " ranges, ";
+                        out += String(bridge.get_negative_cache_hits());
+                        out += " local answers, ";
+                        out += String(bridge.get_negative_cache_stores());
+                        out += " exceptions stored\n";
+                        bridge.print_negative_entries([&out](const String& line) {
+                            out += line;
+                            out += "\n";
+                        });
+                        return CommandResult{true, out};
+                    });
+
+    // cache_info: show cached register ranges
+    registerCommand("cache_info", "Show cached register ranges and their ages",
                     [](const std::vector<String>&) -> CommandResult {
                         auto& bridge = ProtocolBridge::getInstance();
 
@@ -691,8 +792,8 @@ void CommandManager::registerCoreCommands() {
                         }
 
                         String out;
-                        out.reserve(cache_size * 100);
-                        out += "Cached Entries:\n";
+                        out.reserve(512);
+                        out += "Cached register ranges:\n";
                         bridge.print_cache_entries([&out](const String& line) {
                             out += line;
                             out += "\n";
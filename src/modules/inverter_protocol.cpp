@@ -24,6 +24,11 @@ uint16_t InverterProtocol::calculate_crc16(const uint8_t* data, size_t length) {
     return CRC16::calculate(data, length);
 }
 
+// Compile-time CRC must agree with the runtime table (zero-serial SN probe frame)
+static_assert(InverterFrames::zero_serial_request_crc(0x04, MODBUS_INVERTER_SN_START_REG,
+                                                      MODBUS_INVERTER_SN_REG_COUNT) == 0x27A3,
+              "constexpr CRC16 mismatch");
+
 // ============================================================================
 // SECTION 2: Byte Order Helpers
 // ============================================================================
@@ -64,6 +69,52 @@ String InverterProtocol::format_hex(const uint8_t* data, size_t length) {
     return result;
 }
 
+const char* InverterProtocol::error_to_string(ParseError error) {
+    switch (error) {
+        case ParseError::NONE:
+            return "OK";
+        case ParseError::INVALID_PACKET:
+            return "Invalid response packet";
+        case ParseError::TOO_SHORT:
+            return "Response packet too short";
+        case ParseError::CRC_MISMATCH:
+            return "CRC mismatch";
+        case ParseError::UNKNOWN_FUNCTION:
+            return "Unknown function code in response";
+        case ParseError::MODBUS_EXCEPTION:
+            return "Modbus Exception";
+        case ParseError::MALFORMED_EXCEPTION:
+            return "Modbus exception (malformed response)";
+        case ParseError::INVALID_FRAME:
+            return "Invalid response frame";
+        case ParseError::NO_FRAMES:
+            return "No valid frames found in response";
+        case ParseError::RESPONSE_NOT_FOUND:
+            return "Response not found (traffic from other master?)";
+        case ParseError::TIMEOUT:
+            return "Timeout";
+        default:
+            return "Unknown error";
+    }
+}
+
+const char* InverterProtocol::exception_to_string(uint8_t exception_code) {
+    switch (exception_code) {
+        case 0x01:
+            return "Illegal function";
+        case 0x02:
+            return "Illegal data address";
+        case 0x03:
+            return "Illegal data value";
+        case 0x04:
+            return "Slave device failure";
+        case 0x0B:
+            return "Gateway Target Device Failed to Respond";
+        default:
+            return "Unknown exception";
+    }
+}
+
 // ============================================================================
 // SECTION 5: Request Creation - Read
 // ============================================================================
@@ -113,6 +164,60 @@ bool InverterProtocol::create_read_request(std::vector<uint8_t>& packet, ModbusF
     return true;
 }
 
+void RequestTemplate::set_serial(const String& serial) {
+    SerialUtils::write_serial(serial_, MODBUS_SERIAL_NUMBER_LENGTH, serial);
+
+    const ModbusFunctionCode funcs[] = {ModbusFunctionCode::READ_HOLDING,
+                                        ModbusFunctionCode::READ_INPUT,
+                                        ModbusFunctionCode::WRITE_SINGLE};
+    for (ModbusFunctionCode func : funcs) {
+        uint16_t crc = CRC16::update(CRC16::init(), MODBUS_DEVICE_ADDR_REQUEST);
+        crc = CRC16::update(crc, static_cast<uint8_t>(func));
+        prefix_crc_[slot(func)] = CRC16::update(crc, serial_, MODBUS_SERIAL_NUMBER_LENGTH);
+    }
+}
+
+size_t RequestTemplate::slot(ModbusFunctionCode func) {
+    switch (func) {
+        case ModbusFunctionCode::READ_HOLDING:
+            return 0;
+        case ModbusFunctionCode::READ_INPUT:
+            return 1;
+        default:
+            return 2;
+    }
+}
+
+void RequestTemplate::build(uint8_t* frame, ModbusFunctionCode func, uint16_t start_reg,
+                            uint16_t count_or_value) const {
+    frame[InverterProtocolOffsets::ADDR] = MODBUS_DEVICE_ADDR_REQUEST;
+    frame[InverterProtocolOffsets::FUNC] = static_cast<uint8_t>(func);
+    memcpy(&frame[InverterProtocolOffsets::SERIAL_NUM], serial_, MODBUS_SERIAL_NUMBER_LENGTH);
+    InverterProtocol::write_little_endian_uint16(frame, InverterProtocolOffsets::START_REG,
+                                                 start_reg);
+    InverterProtocol::write_little_endian_uint16(frame, InverterProtocolOffsets::COUNT_OR_VALUE,
+                                                 count_or_value);
+
+    // Only the 4 variable bytes are folded into the precomputed prefix state
+    const uint16_t crc = CRC16::finalize(
+        CRC16::update(prefix_crc_[slot(func)], &frame[InverterProtocolOffsets::START_REG], 4));
+    InverterProtocol::write_little_endian_uint16(frame, InverterProtocolOffsets::CRC_MIN_PACKET,
+                                                 crc);
+}
+
+bool InverterProtocol::create_read_request(std::vector<uint8_t>& packet,
+                                           const RequestTemplate& prefix, ModbusFunctionCode func,
+                                           uint16_t start_reg, uint16_t count) {
+    if (count == 0 || count > MODBUS_MAX_REGISTERS) {
+        LOGE(TAG, "Invalid register count: %d (max %d)", count, MODBUS_MAX_REGISTERS);
+        return false;
+    }
+
+    packet.resize(MODBUS_MIN_REQUEST_SIZE);
+    prefix.build(packet.data(), func, start_reg, count);
+    return true;
+}
+
 // ============================================================================
 // SECTION 6: Request Creation - Write
 // ============================================================================
@@ -154,9 +259,9 @@ static bool create_write_single_request(std::vector<uint8_t>& packet, uint16_t s
  * @brief Create a write multiple registers request (function 0x10)
  */
 static bool create_write_multi_request(std::vector<uint8_t>& packet, uint16_t start_reg,
-                                       const std::vector<uint16_t>& values,
-                                       const String& serial_number) {
-    const size_t byte_count = values.size() * 2;
+                                       const uint16_t* values, size_t count,
+                                       const uint8_t* serial) {
+    const size_t byte_count = count * 2;
     const size_t packet_size = 17 + byte_count + 2; // Header(17) + data + CRC(2)
 
     packet.resize(packet_size);
@@ -165,22 +270,17 @@ static bool create_write_multi_request(std::vector<uint8_t>& packet, uint16_t st
     packet[InverterProtocolOffsets::FUNC] = static_cast<uint8_t>(ModbusFunctionCode::WRITE_MULTI);
 
     // Serial number
-    if (serial_number.length() == 0) {
-        memset(&packet[InverterProtocolOffsets::SERIAL_NUM], 0x00, MODBUS_SERIAL_NUMBER_LENGTH);
-    } else {
-        SerialUtils::write_serial(&packet[InverterProtocolOffsets::SERIAL_NUM],
-                                  MODBUS_SERIAL_NUMBER_LENGTH, serial_number);
-    }
+    memcpy(&packet[InverterProtocolOffsets::SERIAL_NUM], serial, MODBUS_SERIAL_NUMBER_LENGTH);
 
     // Register range
     InverterProtocol::write_little_endian_uint16(&packet[0], InverterProtocolOffsets::START_REG,
                                                  start_reg);
     InverterProtocol::write_little_endian_uint16(
-        &packet[0], InverterProtocolOffsets::COUNT_OR_VALUE, values.size());
+        &packet[0], InverterProtocolOffsets::COUNT_OR_VALUE, count);
 
     // Byte count and values
     packet[InverterProtocolOffsets::BYTE_COUNT] = byte_count & 0xFF;
-    for (size_t i = 0; i < values.size(); i++) {
+    for (size_t i = 0; i < count; i++) {
         InverterProtocol::write_little_endian_uint16(
             &packet[0], InverterProtocolOffsets::DATA_START + (i * 2), values[i]);
     }
@@ -193,20 +293,93 @@ static bool create_write_multi_request(std::vector<uint8_t>& packet, uint16_t st
 }
 
 bool InverterProtocol::create_write_request(std::vector<uint8_t>& packet, uint16_t start_reg,
-                                            const std::vector<uint16_t>& values,
+                                            const uint16_t* values, size_t count,
                                             const String& serial_number) {
-    if (values.empty() || values.size() > MODBUS_MAX_REGISTERS) {
-        LOGE(TAG, "Invalid register count: %d (max %d)", values.size(), MODBUS_MAX_REGISTERS);
+    if (values == nullptr || count == 0 || count > MODBUS_MAX_REGISTERS) {
+        LOGE(TAG, "Invalid register count: %d (max %d)", count, MODBUS_MAX_REGISTERS);
         return false;
     }
 
     packet.clear();
 
-    if (values.size() == 1) {
+    if (count == 1) {
         return create_write_single_request(packet, start_reg, values[0], serial_number);
     } else {
-        return create_write_multi_request(packet, start_reg, values, serial_number);
+        uint8_t serial[MODBUS_SERIAL_NUMBER_LENGTH];
+        SerialUtils::write_serial(serial, MODBUS_SERIAL_NUMBER_LENGTH, serial_number);
+        return create_write_multi_request(packet, start_reg, values, count, serial);
+    }
+}
+
+bool InverterProtocol::create_write_request(std::vector<uint8_t>& packet,
+                                            const RequestTemplate& prefix, uint16_t start_reg,
+                                            const uint16_t* values, size_t count) {
+    if (values == nullptr || count == 0 || count > MODBUS_MAX_REGISTERS) {
+        LOGE(TAG, "Invalid register count: %d (max %d)", count, MODBUS_MAX_REGISTERS);
+        return false;
+    }
+
+    if (count == 1) {
+        packet.resize(MODBUS_MIN_REQUEST_SIZE);
+        prefix.build(packet.data(), ModbusFunctionCode::WRITE_SINGLE, start_reg, values[0]);
+        return true;
+    }
+    return create_write_multi_request(packet, start_reg, values, count, prefix.serial());
+}
+
+/**
+ * @brief Create a read response (function 0x03 or 0x04)
+ *
+ * Same layout parse_read_response() expects: address 0x01, function code,
+ * serial, echoed start register, byte count, little-endian data, CRC16.
+ */
+bool InverterProtocol::create_read_response(std::vector<uint8_t>& packet, ModbusFunctionCode func,
+                                            const uint8_t* serial, uint16_t start_reg,
+                                            const uint16_t* values, size_t count) {
+    if (values == nullptr || count == 0 || count > MODBUS_MAX_REGISTERS) {
+        LOGE(TAG, "Invalid register count: %d (max %d)", count, MODBUS_MAX_REGISTERS);
+        return false;
+    }
+
+    const size_t byte_count = count * 2;
+    const size_t data_offset = InverterProtocolOffsets::COUNT_OR_VALUE + 1;
+    packet.resize(MODBUS_MIN_RESPONSE_SIZE + byte_count);
+
+    packet[InverterProtocolOffsets::ADDR] = MODBUS_DEVICE_ADDR_RESPONSE;
+    packet[InverterProtocolOffsets::FUNC] = static_cast<uint8_t>(func);
+    memcpy(&packet[InverterProtocolOffsets::SERIAL_NUM], serial, MODBUS_SERIAL_NUMBER_LENGTH);
+    write_little_endian_uint16(&packet[0], InverterProtocolOffsets::START_REG, start_reg);
+    packet[InverterProtocolOffsets::COUNT_OR_VALUE] = static_cast<uint8_t>(byte_count);
+
+    for (size_t i = 0; i < count; i++) {
+        write_little_endian_uint16(&packet[0], data_offset + (i * 2), values[i]);
     }
+
+    const size_t crc_offset = data_offset + byte_count;
+    write_little_endian_uint16(&packet[0], crc_offset, calculate_crc16(&packet[0], crc_offset));
+    return true;
+}
+
+/**
+ * @brief Create a write single acknowledgement (function 0x06)
+ *
+ * Same layout as the request, with the response address: the inverter
+ * echoes register and value.
+ */
+bool InverterProtocol::create_write_single_response(std::vector<uint8_t>& packet,
+                                                    const uint8_t* serial, uint16_t reg,
+                                                    uint16_t value) {
+    packet.resize(MODBUS_MIN_REQUEST_SIZE);
+
+    packet[InverterProtocolOffsets::ADDR] = MODBUS_DEVICE_ADDR_RESPONSE;
+    packet[InverterProtocolOffsets::FUNC] = static_cast<uint8_t>(ModbusFunctionCode::WRITE_SINGLE);
+    memcpy(&packet[InverterProtocolOffsets::SERIAL_NUM], serial, MODBUS_SERIAL_NUMBER_LENGTH);
+    write_little_endian_uint16(&packet[0], InverterProtocolOffsets::START_REG, reg);
+    write_little_endian_uint16(&packet[0], InverterProtocolOffsets::COUNT_OR_VALUE, value);
+
+    const size_t crc_offset = MODBUS_MIN_REQUEST_SIZE - 2;
+    write_little_endian_uint16(&packet[0], crc_offset, calculate_crc16(&packet[0], crc_offset));
+    return true;
 }
 
 // ============================================================================
@@ -283,8 +456,9 @@ static ParseResult parse_exception_response(const uint8_t* data, size_t length)
 
     // Safety check: need at least 12 bytes for header
     if (length < 12) {
-        result.error_message = "Exception response too short to read header";
-        LOGE(TAG, "%s: got %d bytes, need at least 12", result.error_message.c_str(), length);
+        result.error = ParseError::MALFORMED_EXCEPTION;
+        LOGE(TAG, "Exception response too short to read header: got %d bytes, need at least 12",
+             length);
         return result;
     }
 
@@ -299,35 +473,12 @@ static ParseResult parse_exception_response(const uint8_t* data, size_t length)
         result.start_address = failed_register;
         const uint8_t exception_code = data[InverterProtocolOffsets::EXCEPTION_CODE];
 
-        // Map exception code to message
-        const char* exception_msg;
-        switch (exception_code) {
-            case 0x01:
-                exception_msg = "Illegal function";
-                break;
-            case 0x02:
-                exception_msg = "Illegal data address";
-                break;
-            case 0x03:
-                exception_msg = "Illegal data value";
-                break;
-            case 0x04:
-                exception_msg = "Slave device failure";
-                break;
-            case 0x0B:
-                exception_msg = "Gateway Target Device Failed to Respond";
-                break;
-            default:
-                exception_msg = "Unknown exception";
-                break;
-        }
-
-        result.error_message = String("Modbus Exception 0x") + String(exception_code, HEX) + ": " +
-                               exception_msg + " (register " + String(failed_register) + ")";
+        result.error = ParseError::MODBUS_EXCEPTION;
+        result.exception_code = exception_code;
         LOGE(TAG, "Inverter exception: func=0x%02X, reg=%d, code=0x%02X (%s)", func_byte,
-             failed_register, exception_code, exception_msg);
+             failed_register, exception_code, InverterProtocol::exception_to_string(exception_code));
     } else {
-        result.error_message = "Modbus exception (malformed response)";
+        result.error = ParseError::MALFORMED_EXCEPTION;
         LOGE(TAG, "Exception response too short: %d bytes", length);
     }
 
@@ -371,9 +522,10 @@ static ParseResult parse_read_response(const uint8_t* data, size_t length, uint8
 
     // Safety check: need at least 15 bytes to read header including byte_count
     if (length < 15) {
-        result.error_message = "Response packet too short to read header";
-        LOGE(TAG, "%s: got %d bytes, need at least 15 for func 0x%02X",
-             result.error_message.c_str(), length, func_byte);
+        result.error = ParseError::TOO_SHORT;
+        LOGE(TAG, "Response packet too short to read header: got %d bytes, need at least 15 for "
+                  "func 0x%02X",
+             length, func_byte);
         return result;
     }
 
@@ -388,9 +540,10 @@ static ParseResult parse_read_response(const uint8_t* data, size_t length, uint8
 
     // Verify we have complete frame
     if (length < frame_length) {
-        result.error_message = "Response packet too short";
+        result.error = ParseError::TOO_SHORT;
         LOGE(TAG, "%s: got %d, expected %d for func 0x%02X (byte_count=%d)",
-             result.error_message.c_str(), length, frame_length, func_byte, byte_count);
+             InverterProtocol::error_to_string(result.error), length, frame_length, func_byte,
+             byte_count);
         return result;
     }
 
@@ -406,9 +559,9 @@ static ParseResult parse_read_response(const uint8_t* data, size_t length, uint8
     LOGD(TAG, "CRC Check: calculated=0x%04X, received=0x%04X", calculated_crc, received_crc);
 
     if (calculated_crc != received_crc) {
-        result.error_message = "CRC mismatch";
-        LOGW(TAG, "%s: calculated=0x%04X, received=0x%04X", result.error_message.c_str(),
-             calculated_crc, received_crc);
+        result.error = ParseError::CRC_MISMATCH;
+        LOGW(TAG, "%s: calculated=0x%04X, received=0x%04X",
+             InverterProtocol::error_to_string(result.error), calculated_crc, received_crc);
         LOGW(TAG, "   Packet [%d bytes]: %s", length,
              InverterProtocol::format_hex(data, std::min(length, (size_t) 32)).c_str());
         return result;
@@ -416,7 +569,6 @@ static ParseResult parse_read_response(const uint8_t* data, size_t length, uint8
 
     // Extract register values
     result.register_count = byte_count / 2;
-    result.register_values.reserve(result.register_count);
 
     const size_t data_offset = InverterProtocolOffsets::COUNT_OR_VALUE + 1;
     for (size_t i = 0; i < result.register_count; i++) {
@@ -442,9 +594,9 @@ static ParseResult parse_write_single_response(const uint8_t* data, size_t lengt
 
     const size_t expected_length = 18;
     if (length < expected_length) {
-        result.error_message = "Response packet too short";
-        LOGE(TAG, "%s: got %d, expected %d for func 0x06", result.error_message.c_str(), length,
-             expected_length);
+        result.error = ParseError::TOO_SHORT;
+        LOGE(TAG, "%s: got %d, expected %d for func 0x06",
+             InverterProtocol::error_to_string(result.error), length, expected_length);
         return result;
     }
 
@@ -459,15 +611,14 @@ static ParseResult parse_write_single_response(const uint8_t* data, size_t lengt
     const uint16_t received_crc = InverterProtocol::parse_little_endian_uint16(data, length - 2);
     LOGD(TAG, "CRC Check: calculated=0x%04X, received=0x%04X", calculated_crc, received_crc);
     if (calculated_crc != received_crc) {
-        result.error_message = "CRC mismatch";
-        LOGW(TAG, "%s: calculated=0x%04X, received=0x%04X", result.error_message.c_str(),
-             calculated_crc, received_crc);
+        result.error = ParseError::CRC_MISMATCH;
+        LOGW(TAG, "%s: calculated=0x%04X, received=0x%04X",
+             InverterProtocol::error_to_string(result.error), calculated_crc, received_crc);
         return result;
     }
 
     // Extract value
     result.register_count = 1;
-    result.register_values.reserve(1);
     const uint16_t value =
         InverterProtocol::parse_little_endian_uint16(data, InverterProtocolOffsets::COUNT_OR_VALUE);
     result.register_values.push_back(value);
@@ -485,9 +636,9 @@ static ParseResult parse_write_multi_response(const uint8_t* data, size_t length
 
     const size_t expected_length = 18;
     if (length < expected_length) {
-        result.error_message = "Response packet too short";
-        LOGE(TAG, "%s: got %d, expected %d for func 0x10", result.error_message.c_str(), length,
-             expected_length);
+        result.error = ParseError::TOO_SHORT;
+        LOGE(TAG, "%s: got %d, expected %d for func 0x10",
+             InverterProtocol::error_to_string(result.error), length, expected_length);
         return result;
     }
 
@@ -502,9 +653,9 @@ static ParseResult parse_write_multi_response(const uint8_t* data, size_t length
     const uint16_t received_crc = InverterProtocol::parse_little_endian_uint16(data, length - 2);
     LOGD(TAG, "CRC Check: calculated=0x%04X, received=0x%04X", calculated_crc, received_crc);
     if (calculated_crc != received_crc) {
-        result.error_message = "CRC mismatch";
-        LOGW(TAG, "%s: calculated=0x%04X, received=0x%04X", result.error_message.c_str(),
-             calculated_crc, received_crc);
+        result.error = ParseError::CRC_MISMATCH;
+        LOGW(TAG, "%s: calculated=0x%04X, received=0x%04X",
+             InverterProtocol::error_to_string(result.error), calculated_crc, received_crc);
         return result;
     }
 
@@ -522,8 +673,8 @@ static ParseResult parse_write_multi_response(const uint8_t* data, size_t length
 ParseResult InverterProtocol::parse_response(const uint8_t* data, size_t length) {
     if (!is_valid_response(data, length)) {
         ParseResult invalid;
-        invalid.error_message = "Invalid response packet";
-        LOGE(TAG, "%s", invalid.error_message.c_str());
+        invalid.error = ParseError::INVALID_PACKET;
+        LOGE(TAG, "%s", error_to_string(invalid.error));
         return invalid;
     }
 
@@ -548,8 +699,8 @@ ParseResult InverterProtocol::parse_response(const uint8_t* data, size_t length)
             result = parse_write_multi_response(data, length);
             break;
         default:
-            result.error_message = "Unknown function code in response";
-            LOGE(TAG, "%s: 0x%02X", result.error_message.c_str(), func_byte);
+            result.error = ParseError::UNKNOWN_FUNCTION;
+            LOGE(TAG, "%s: 0x%02X", error_to_string(result.error), func_byte);
             return result;
     }
 
@@ -566,125 +717,217 @@ ParseResult InverterProtocol::parse_response(const uint8_t* data, size_t length)
 // SECTION 12: Multi-Frame Handling
 // ============================================================================
 
+static bool is_known_function(uint8_t func) {
+    return func == static_cast<uint8_t>(ModbusFunctionCode::READ_HOLDING) ||
+           func == static_cast<uint8_t>(ModbusFunctionCode::READ_INPUT) ||
+           func == static_cast<uint8_t>(ModbusFunctionCode::WRITE_SINGLE) ||
+           func == static_cast<uint8_t>(ModbusFunctionCode::WRITE_MULTI);
+}
+
 /**
- * @brief Calculate frame length based on function code
+ * @brief Calculate frame length from the header, or 0 if it cannot start a frame
+ *
+ * This is the resync pre-filter: address, function code, byte count and
+ * (for responses, when known) the inverter serial are checked before any
+ * CRC is computed. The returned length may exceed @p available.
  */
-size_t InverterProtocol::calculate_frame_length(const uint8_t* frame, size_t available) {
+size_t InverterProtocol::calculate_frame_length(const uint8_t* frame, size_t available,
+                                                const uint8_t* expected_serial) {
     if (available < 2)
         return 0;
 
-    const uint8_t addr = frame[0];
-    const uint8_t func = frame[1] & 0x7F;
+    const uint8_t addr = frame[InverterProtocolOffsets::ADDR];
+    const uint8_t func = frame[InverterProtocolOffsets::FUNC] & 0x7F;
+
+    if (!is_known_function(func))
+        return 0;
 
-    // Request: always 18 bytes
+    // Request: always 18 bytes (any master, any serial)
     if (addr == MODBUS_DEVICE_ADDR_REQUEST) {
-        return 18;
+        return (frame[InverterProtocolOffsets::FUNC] & 0x80) ? 0 : MODBUS_MIN_REQUEST_SIZE;
+    }
+
+    if (addr != MODBUS_DEVICE_ADDR_RESPONSE)
+        return 0;
+
+    // Responses carry the inverter serial; reject mismatches once it is known
+    if (expected_serial != nullptr &&
+        available >= InverterProtocolOffsets::SERIAL_NUM + MODBUS_SERIAL_NUMBER_LENGTH &&
+        memcmp(&frame[InverterProtocolOffsets::SERIAL_NUM], expected_serial,
+               MODBUS_SERIAL_NUMBER_LENGTH) != 0) {
+        return 0;
     }
 
     // Exception response: 17 bytes
-    if (frame[1] & 0x80) {
+    if (frame[InverterProtocolOffsets::FUNC] & 0x80) {
         return MODBUS_MIN_EXCEPTION_SIZE;
     }
 
-    // Read response: 17 + byte_count
+    // Read response: 17 + byte_count (whole registers, within protocol limits)
     if (func == 0x03 || func == 0x04) {
-        if (available >= 15) {
-            return 17 + frame[14];
-        }
-        return 0;
+        if (available < 15)
+            return 0;
+        const uint8_t byte_count = frame[InverterProtocolOffsets::COUNT_OR_VALUE];
+        if (byte_count == 0 || (byte_count & 1) || byte_count > MODBUS_MAX_REGISTERS * 2)
+            return 0;
+        return 17 + byte_count;
     }
 
     // Write response: 18 bytes
-    if (func == 0x06 || func == 0x10) {
-        return 18;
+    return 18;
+}
+
+/**
+ * @brief Offset of the first plausible frame start at or after @p from
+ * @return Offset, or @p length if no candidate remains
+ */
+size_t InverterProtocol::find_frame_candidate(const uint8_t* data, size_t length, size_t from,
+                                              const uint8_t* expected_serial) {
+    for (size_t i = from; i + 2 <= length; i++) {
+        // Cheapest test first: only 0x00/0x01 can start a frame
+        if (data[i] > MODBUS_DEVICE_ADDR_RESPONSE)
+            continue;
+        if (calculate_frame_length(data + i, length - i, expected_serial) > 0)
+            return i;
     }
+    return length;
+}
 
-    return 0;
+/**
+ * @brief Decode the header of a complete frame into a view (no register values)
+ */
+static void decode_frame_header(const uint8_t* frame, size_t offset, size_t frame_len,
+                                FrameKind kind, bool crc_valid, FrameView& view) {
+    view.offset = offset;
+    view.length = frame_len;
+    view.kind = kind;
+    view.crc_valid = crc_valid;
+    view.function_code = frame[InverterProtocolOffsets::FUNC] & 0x7F;
+    view.start_address =
+        InverterProtocol::parse_little_endian_uint16(frame, InverterProtocolOffsets::START_REG);
+
+    switch (kind) {
+        case FrameKind::REQUEST:
+            view.register_count =
+                (view.function_code == static_cast<uint8_t>(ModbusFunctionCode::WRITE_SINGLE))
+                    ? 1
+                    : InverterProtocol::parse_little_endian_uint16(
+                          frame, InverterProtocolOffsets::COUNT_OR_VALUE);
+            break;
+        case FrameKind::EXCEPTION:
+            view.register_count = 0;
+            break;
+        case FrameKind::RESPONSE:
+            if (view.function_code == static_cast<uint8_t>(ModbusFunctionCode::WRITE_SINGLE)) {
+                view.register_count = 1;
+            } else if (view.function_code ==
+                       static_cast<uint8_t>(ModbusFunctionCode::WRITE_MULTI)) {
+                view.register_count = InverterProtocol::parse_little_endian_uint16(
+                    frame, InverterProtocolOffsets::COUNT_OR_VALUE);
+            } else {
+                view.register_count = frame[InverterProtocolOffsets::COUNT_OR_VALUE] / 2;
+            }
+            break;
+    }
 }
 
 /**
- * @brief Parse all frames in the buffer
+ * @brief Prefix CRC state over data_[0, index)
  *
- * This handles the case where we receive concatenated frames from
- * multiple masters on the shared RS485 bus.
+ * Folds forward lazily; offsets only move forward, so the window always
+ * still holds the state for the current candidate.
  */
-std::vector<FrameInfo> InverterProtocol::parse_all_frames(const std::vector<uint8_t>& data) {
-    std::vector<FrameInfo> frames;
-    size_t offset = 0;
+uint16_t FrameIterator::prefix_at(size_t index) {
+    while (prefix_end_ < index) {
+        prefix_[(prefix_end_ + 1) & (PREFIX_WINDOW - 1)] =
+            CRC16::update(prefix_[prefix_end_ & (PREFIX_WINDOW - 1)], data_[prefix_end_]);
+        prefix_end_++;
+    }
+    return prefix_[index & (PREFIX_WINDOW - 1)];
+}
 
-    while (offset < data.size()) {
-        if (data.size() - offset < 2)
+/**
+ * @brief Advance to the next frame in the buffer
+ *
+ * This handles the case where we receive concatenated frames from
+ * multiple masters on the shared RS485 bus. Bytes that do not start a
+ * plausible, complete frame are skipped (resync).
+ */
+bool FrameIterator::next(FrameView& frame) {
+    while (offset_ + 2 <= length_) {
+        offset_ = InverterProtocol::find_frame_candidate(data_, length_, offset_, expected_serial_);
+        if (offset_ >= length_)
             break;
 
-        const uint8_t* frame_start = data.data() + offset;
-        const size_t remaining = data.size() - offset;
-        const uint8_t addr = frame_start[0];
-
-        // Handle request (addr=0x00). Validate CRC so zero-filled payload data
-        // is not misclassified as external-master request traffic.
-        if (addr == MODBUS_DEVICE_ADDR_REQUEST && is_request(frame_start, remaining)) {
-            size_t frame_len = calculate_frame_length(frame_start, remaining);
-            if (frame_len > 0 && frame_len <= remaining) {
-                FrameInfo info = {offset, frame_len, true, {}};
-                frames.push_back(info);
-                LOGD(TAG, "Frame[%d]: REQUEST at offset %d, len=%d", frames.size() - 1, offset,
-                     frame_len);
-                offset += frame_len;
-            } else {
-                offset++;
-            }
+        const uint8_t* frame_start = data_ + offset_;
+        const size_t remaining = length_ - offset_;
+        const size_t frame_len =
+            InverterProtocol::calculate_frame_length(frame_start, remaining, expected_serial_);
+
+        if (frame_len > remaining) {
+            // Incomplete frame, skip
+            offset_++;
             continue;
         }
 
-        // Handle response (addr=0x01)
-        if (addr == MODBUS_DEVICE_ADDR_RESPONSE) {
-            size_t frame_len = calculate_frame_length(frame_start, remaining);
-            if (frame_len > 0 && frame_len <= remaining) {
-                FrameInfo info;
-                info.offset = offset;
-                info.length = frame_len;
-                info.is_request = false;
-                info.result = parse_response(frame_start, frame_len);
-                frames.push_back(info);
-                LOGD(TAG,
-                     "Frame[%d]: RESPONSE at offset %d, len=%d, func=0x%02X, start=%d, regs=%d",
-                     frames.size() - 1, offset, frame_len,
-                     static_cast<uint8_t>(info.result.function_code), info.result.start_address,
-                     info.result.register_count);
-                offset += frame_len;
-            } else {
-                offset++;
+        const size_t crc_offset = frame_len - 2;
+        const uint16_t received_crc =
+            InverterProtocol::parse_little_endian_uint16(frame_start, crc_offset);
+
+        if (frame_start[InverterProtocolOffsets::ADDR] == MODBUS_DEVICE_ADDR_REQUEST) {
+            // Validate CRC so zero-filled payload data is not misclassified as
+            // external-master request traffic.
+            const uint16_t begin_state = prefix_at(offset_);
+            const uint16_t crc =
+                CRC16::span16_from_prefix(begin_state, prefix_at(offset_ + crc_offset));
+            if (crc != received_crc) {
+                offset_++;
+                continue;
             }
-            continue;
+            decode_frame_header(frame_start, offset_, frame_len, FrameKind::REQUEST, true, frame);
+        } else {
+            const FrameKind kind = (frame_start[InverterProtocolOffsets::FUNC] & 0x80)
+                                       ? FrameKind::EXCEPTION
+                                       : FrameKind::RESPONSE;
+            const bool crc_valid = CRC16::calculate(frame_start, crc_offset) == received_crc;
+            decode_frame_header(frame_start, offset_, frame_len, kind, crc_valid, frame);
         }
 
-        // Unknown byte, skip
-        offset++;
+        offset_ += frame_len;
+        return true;
     }
 
-    return frames;
+    offset_ = length_;
+    return false;
 }
 
 /**
- * @brief Find the response matching our request
- * @return Index of matching frame, or -1 if not found
+ * @brief Check whether the buffer holds at least one response frame
  */
-int InverterProtocol::find_matching_response_index(const std::vector<FrameInfo>& frames,
-                                                   ModbusFunctionCode expected_func,
-                                                   uint16_t expected_start_reg,
-                                                   uint16_t expected_register_count) {
-    for (size_t i = 0; i < frames.size(); i++) {
-        const FrameInfo& frame = frames[i];
-
-        if (frame.is_request)
-            continue;
+bool InverterProtocol::contains_response(const uint8_t* data, size_t length,
+                                         const uint8_t* expected_serial) {
+    FrameIterator frames(data, length, expected_serial);
+    FrameView frame;
+    while (frames.next(frame)) {
+        if (!frame.is_request())
+            return true;
+    }
+    return false;
+}
 
-        if (frame.result.success && frame.result.function_code == expected_func &&
-            frame.result.start_address == expected_start_reg &&
-            (expected_register_count == 0 ||
-             frame.result.register_count == expected_register_count)) {
-            return static_cast<int>(i);
-        }
+/**
+ * @brief Check whether a frame is the (valid) response to our request
+ */
+bool InverterProtocol::is_matching_response(const FrameView& frame,
+                                            ModbusFunctionCode expected_func,
+                                            uint16_t expected_start_reg,
+                                            uint16_t expected_register_count) {
+    if (frame.is_request() || !frame.crc_valid ||
+        frame.function_code != static_cast<uint8_t>(expected_func) ||
+        frame.start_address != expected_start_reg) {
+        return false;
     }
-    return -1;
+    // An exception refuses the request as a whole and carries no count
+    return frame.kind == FrameKind::EXCEPTION || expected_register_count == 0 ||
+           frame.register_count == expected_register_count;
 }
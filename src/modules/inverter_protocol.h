@@ -20,8 +20,12 @@
 
 #pragma once
 
+#include "utils/crc16.h"
+#include "utils/fixed_vector.h"
+
 #include <Arduino.h>
 
+#include <array>
 #include <cstring>
 #include <vector>
 
@@ -46,6 +50,8 @@ static constexpr size_t MODBUS_MIN_REQUEST_SIZE = 18;     // Minimum request pac
 static constexpr size_t MODBUS_MIN_RESPONSE_SIZE = 17;    // Minimum response size (no data)
 static constexpr size_t MODBUS_MIN_EXCEPTION_SIZE = 17;   // Exception response size
 static constexpr size_t MODBUS_MAX_RX_BUFFER_SIZE = 1024; // Maximum receive buffer
+static constexpr size_t MODBUS_MAX_FRAME_SIZE =
+    17 + (MODBUS_MAX_REGISTERS * 2) + 2; // Largest single frame (write multi request)
 
 // Timing
 static constexpr uint32_t MODBUS_RESPONSE_TIMEOUT_MS = 800;
@@ -88,8 +94,28 @@ enum class ModbusFunctionCode : uint8_t {
 // Result Structures
 // ============================================================================
 
+/**
+ * @brief Reason a response could not be used
+ */
+enum class ParseError : uint8_t {
+    NONE = 0,
+    INVALID_PACKET,      // Bad address/function code
+    TOO_SHORT,           // Fewer bytes than the header/byte count requires
+    CRC_MISMATCH,        // Frame CRC does not match
+    UNKNOWN_FUNCTION,    // Function code not handled by the parser
+    MODBUS_EXCEPTION,    // Inverter answered with an exception (see exception_code)
+    MALFORMED_EXCEPTION, // Exception frame too short to decode
+    INVALID_FRAME,       // RX buffer held no usable frame
+    NO_FRAMES,           // No complete frame found in RX buffer
+    RESPONSE_NOT_FOUND,  // Frames found, none matching our request
+    TIMEOUT,             // No response within the response timeout
+};
+
 /**
  * @brief Result of parsing a Inverter response
+ *
+ * Uses inline storage only, so results can be copied around the
+ * RX/bridge path without heap allocations.
  */
 struct ParseResult {
     bool success = false;
@@ -97,24 +123,111 @@ struct ParseResult {
     uint16_t start_address = 0;
     uint16_t register_count = 0;
     uint8_t serial_number[MODBUS_SERIAL_NUMBER_LENGTH];
-    std::vector<uint16_t> register_values;
-    String error_message;
+    FixedVector<uint16_t, MODBUS_MAX_REGISTERS> register_values;
+    ParseError error = ParseError::NONE;
+    uint8_t exception_code = 0; // Valid when error == MODBUS_EXCEPTION
 
     ParseResult() { memset(serial_number, 0, MODBUS_SERIAL_NUMBER_LENGTH); }
 };
 
 /**
- * @brief Frame information for multi-frame parsing
+ * @brief Kind of frame found on the bus
+ */
+enum class FrameKind : uint8_t {
+    REQUEST,   // Address 0x00 (request from any master)
+    RESPONSE,  // Address 0x01, normal response
+    EXCEPTION, // Address 0x01, function code with 0x80 bit set
+};
+
+/**
+ * @brief Non-owning view of one frame inside an RX buffer
  *
  * When the RS485 bus has multiple masters (OpenLux + WiFi dongle),
  * we may receive concatenated frames: [THEIR_REQ][THEIR_RESP][OUR_RESP]
- * This struct helps identify and extract the correct frame.
+ * A view only carries the decoded header; register values are decoded
+ * lazily with InverterProtocol::parse_response() for the frame we keep.
+ */
+struct FrameView {
+    size_t offset = 0;           // Offset within buffer
+    size_t length = 0;           // Frame length in bytes
+    FrameKind kind = FrameKind::RESPONSE;
+    uint8_t function_code = 0;   // Base function code (0x80 bit stripped)
+    uint16_t start_address = 0;  // Start register (echoed / failed register for exceptions)
+    uint16_t register_count = 0; // Registers carried (read) or confirmed (write)
+    bool crc_valid = false;
+
+    bool is_request() const { return kind == FrameKind::REQUEST; }
+};
+
+/**
+ * @brief Non-allocating iterator over the frames contained in an RX buffer
+ *
+ * Resync is pre-filtered: a byte only becomes a candidate when address,
+ * function code, frame length and (if given) the inverter serial are
+ * plausible; CRCs are computed for candidates only. Request candidates
+ * are validated from a rolling prefix CRC, so overlapping candidates
+ * share one pass over the buffer instead of rehashing 16 bytes each.
+ *
+ * Usage:
+ *     FrameIterator frames(data, length);
+ *     FrameView frame;
+ *     while (frames.next(frame)) { ... }
+ */
+class FrameIterator {
+  public:
+    /// @param expected_serial Serial responses must carry (nullptr = any)
+    FrameIterator(const uint8_t* data, size_t length, const uint8_t* expected_serial = nullptr)
+        : data_(data), length_(length), expected_serial_(expected_serial) {}
+
+    bool next(FrameView& frame);
+    void rewind() {
+        offset_ = 0;
+        prefix_end_ = 0;
+        prefix_[0] = 0;
+    }
+
+  private:
+    // Prefix CRC states kept for the last PREFIX_WINDOW offsets (power of two, > 16)
+    static constexpr size_t PREFIX_WINDOW = 32;
+
+    uint16_t prefix_at(size_t index);
+
+    const uint8_t* data_;
+    size_t length_;
+    const uint8_t* expected_serial_;
+    size_t offset_ = 0;
+    uint16_t prefix_[PREFIX_WINDOW] = {0};
+    size_t prefix_end_ = 0; // Bytes folded into prefix_
+};
+
+// ============================================================================
+// Request Templates
+// ============================================================================
+
+/**
+ * @brief 18-byte request prefix precomputed for one serial number
+ *
+ * Address, function code and serial do not change between polls once the
+ * inverter serial is known, so their CRC state is folded once per
+ * function code. Building a request is then a copy of the prefix plus the
+ * four start/count bytes folded into the stored CRC state.
  */
-struct FrameInfo {
-    size_t offset;      // Offset within buffer
-    size_t length;      // Frame length in bytes
-    bool is_request;    // True if address=0x00
-    ParseResult result; // Parsed result (for responses only)
+class RequestTemplate {
+  public:
+    RequestTemplate() { set_serial(""); }
+
+    void set_serial(const String& serial);
+    const uint8_t* serial() const { return serial_; }
+
+    /// Fill an 18-byte read (0x03/0x04) or write single (0x06) request.
+    void build(uint8_t* frame, ModbusFunctionCode func, uint16_t start_reg,
+               uint16_t count_or_value) const;
+
+  private:
+    static size_t slot(ModbusFunctionCode func);
+
+    uint8_t serial_[MODBUS_SERIAL_NUMBER_LENGTH];
+    uint16_t prefix_crc_[3]; // READ_HOLDING, READ_INPUT, WRITE_SINGLE
 };
 
 // ============================================================================
@@ -141,9 +254,24 @@ class InverterProtocol {
                                     const String& serial_number = "");
 
     static bool create_write_request(std::vector<uint8_t>& packet, uint16_t start_reg,
-                                     const std::vector<uint16_t>& values,
+                                     const uint16_t* values, size_t count,
                                      const String& serial_number = "");
 
+    // Same frames, built from a precomputed serial prefix (no serial copy/full CRC)
+    static bool create_read_request(std::vector<uint8_t>& packet, const RequestTemplate& prefix,
+                                    ModbusFunctionCode func, uint16_t start_reg, uint16_t count);
+    static bool create_write_request(std::vector<uint8_t>& packet, const RequestTemplate& prefix,
+                                     uint16_t start_reg, const uint16_t* values, size_t count);
+
+    // ========== Response Creation ==========
+    // Read response (0x03/0x04) as the inverter sends it, e.g. rebuilt from cached registers
+    static bool create_read_response(std::vector<uint8_t>& packet, ModbusFunctionCode func,
+                                     const uint8_t* serial, uint16_t start_reg,
+                                     const uint16_t* values, size_t count);
+    // Write single acknowledgement (0x06): echo of the written register and value
+    static bool create_write_single_response(std::vector<uint8_t>& packet, const uint8_t* serial,
+                                             uint16_t reg, uint16_t value);
+
     // ========== Response Parsing ==========
     static ParseResult parse_response(const uint8_t* data, size_t length);
 
@@ -152,12 +280,15 @@ class InverterProtocol {
     static bool is_valid_response(const uint8_t* data, size_t length);
 
     // ========== Multi-Frame Handling ==========
-    static size_t calculate_frame_length(const uint8_t* frame, size_t available);
-    static std::vector<FrameInfo> parse_all_frames(const std::vector<uint8_t>& data);
-    static int find_matching_response_index(const std::vector<FrameInfo>& frames,
-                                            ModbusFunctionCode expected_func,
-                                            uint16_t expected_start_reg,
-                                            uint16_t expected_register_count);
+    static size_t calculate_frame_length(const uint8_t* frame, size_t available,
+                                         const uint8_t* expected_serial = nullptr);
+    static size_t find_frame_candidate(const uint8_t* data, size_t length, size_t from,
+                                       const uint8_t* expected_serial = nullptr);
+    static bool contains_response(const uint8_t* data, size_t length,
+                                  const uint8_t* expected_serial = nullptr);
+    static bool is_matching_response(const FrameView& frame, ModbusFunctionCode expected_func,
+                                     uint16_t expected_start_reg,
+                                     uint16_t expected_register_count);
 
     // ========== Serial Number Helpers ==========
     static String serial_to_string(const uint8_t* serial);
@@ -169,4 +300,56 @@ class InverterProtocol {
 
     // ========== Debug ==========
     static String format_hex(const uint8_t* data, size_t length);
+    static const char* error_to_string(ParseError error);
+    static const char* exception_to_string(uint8_t exception_code);
 };
+
+// ============================================================================
+// Compile-Time Request Frames
+// ============================================================================
+
+/**
+ * @brief constexpr builders for read requests with a zero serial number
+ *
+ * Before the inverter serial is known (serial probe) the whole frame,
+ * CRC included, is a constant and is generated at compile time.
+ */
+namespace InverterFrames {
+
+using RequestFrame = std::array<uint8_t, MODBUS_MIN_REQUEST_SIZE>;
+
+constexpr uint16_t fold_zeros(uint16_t crc, size_t count) {
+    return count == 0 ? crc : fold_zeros(CRC16::fold(crc, 0x00), count - 1);
+}
+
+constexpr uint16_t zero_serial_request_crc(uint8_t func, uint16_t start_reg, uint16_t count) {
+    return CRC16::fold(
+        CRC16::fold(
+            CRC16::fold(
+                CRC16::fold(fold_zeros(CRC16::fold(CRC16::fold(CRC16::INITIAL_VALUE,
+                                                               MODBUS_DEVICE_ADDR_REQUEST),
+                                                   func),
+                                       MODBUS_SERIAL_NUMBER_LENGTH),
+                            static_cast<uint8_t>(start_reg & 0xFF)),
+                static_cast<uint8_t>(start_reg >> 8)),
+            static_cast<uint8_t>(count & 0xFF)),
+        static_cast<uint8_t>(count >> 8));
+}
+
+constexpr RequestFrame make_zero_serial_request(uint8_t func, uint16_t start_reg, uint16_t count,
+                                                uint16_t crc) {
+    return RequestFrame{{MODBUS_DEVICE_ADDR_REQUEST, func, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                         static_cast<uint8_t>(start_reg & 0xFF),
+                         static_cast<uint8_t>(start_reg >> 8), static_cast<uint8_t>(count & 0xFF),
+                         static_cast<uint8_t>(count >> 8), static_cast<uint8_t>(crc & 0xFF),
+                         static_cast<uint8_t>(crc >> 8)}};
+}
+
+constexpr RequestFrame zero_serial_read_request(ModbusFunctionCode func, uint16_t start_reg,
+                                                uint16_t count) {
+    return make_zero_serial_request(
+        static_cast<uint8_t>(func), start_reg, count,
+        zero_serial_request_crc(static_cast<uint8_t>(func), start_reg, count));
+}
+
+} // namespace InverterFrames
@@ -0,0 +1,140 @@
+/**
+ * @file negative_cache.cpp
+ * @brief Remembers register ranges the inverter answers with a Modbus exception
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#include "negative_cache.h"
+
+#include "logger.h"
+
+static const char* TAG = "negcache";
+
+static constexpr uint8_t MODBUS_EXCEPTION_ILLEGAL_FUNCTION = 0x01;
+static constexpr uint8_t MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE = 0x03;
+
+// ============================================================================
+// Update
+// ============================================================================
+
+bool NegativeCache::is_permanent(uint8_t exception_code) {
+    // 0x01 illegal function, 0x02 illegal data address, 0x03 illegal data value
+    return exception_code >= MODBUS_EXCEPTION_ILLEGAL_FUNCTION &&
+           exception_code <= MODBUS_EXCEPTION_ILLEGAL_DATA_VALUE;
+}
+
+bool NegativeCache::expired(const NegativeEntry& entry, uint32_t now_ms) {
+    return entry.register_count == 0 || now_ms - entry.stored_ms >= NEGATIVE_CACHE_TTL_MS;
+}
+
+bool NegativeCache::store(uint8_t function_code, uint16_t start, uint16_t count,
+                          uint16_t failed_register, uint8_t exception_code, uint32_t now_ms) {
+    if (count == 0 || !is_permanent(exception_code)) {
+        return false;
+    }
+
+    // Same range again (its entry expired meanwhile), else a free slot, else the oldest
+    NegativeEntry* same = nullptr;
+    NegativeEntry* free_slot = nullptr;
+    NegativeEntry* oldest = nullptr;
+    for (NegativeEntry& entry : entries_) {
+        if (entry.register_count == count && entry.start_register == start &&
+            entry.function_code == function_code) {
+            same = &entry;
+            break;
+        }
+        if (expired(entry, now_ms)) {
+            free_slot = free_slot ? free_slot : &entry;
+        } else if (!oldest || now_ms - entry.stored_ms > now_ms - oldest->stored_ms) {
+            oldest = &entry;
+        }
+    }
+    NegativeEntry* slot = same ? same : (free_slot ? free_slot : oldest);
+
+    slot->function_code = function_code;
+    slot->start_register = start;
+    slot->register_count = count;
+    slot->failed_register = failed_register;
+    slot->exception_code = exception_code;
+    slot->stored_ms = now_ms;
+    slot->hits = 0;
+    stores_++;
+
+    LOGD(TAG, "Remembered exception 0x%02X for func=0x%02X regs %u-%u", exception_code,
+         function_code, start, (unsigned) (start + count - 1));
+    return true;
+}
+
+size_t NegativeCache::forget(uint8_t function_code, uint16_t start, uint16_t count) {
+    const uint32_t end = static_cast<uint32_t>(start) + count;
+    size_t dropped = 0;
+    for (NegativeEntry& entry : entries_) {
+        // A wider entry may still be refused for registers outside this read
+        if (entry.register_count != 0 && entry.function_code == function_code &&
+            entry.start_register >= start &&
+            static_cast<uint32_t>(entry.start_register) + entry.register_count <= end) {
+            entry.register_count = 0;
+            dropped++;
+        }
+    }
+    return dropped;
+}
+
+size_t NegativeCache::clear() {
+    size_t dropped = 0;
+    for (NegativeEntry& entry : entries_) {
+        dropped += entry.register_count != 0 ? 1 : 0;
+        entry = NegativeEntry();
+    }
+    return dropped;
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+bool NegativeCache::contains(uint8_t function_code, uint16_t start, uint16_t count,
+                             uint32_t now_ms) const {
+    for (const NegativeEntry& entry : entries_) {
+        if (entry.register_count == count && entry.start_register == start &&
+            entry.function_code == function_code && !expired(entry, now_ms)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+const NegativeEntry* NegativeCache::lookup(uint8_t function_code, uint16_t start, uint16_t count,
+                                           uint32_t now_ms) {
+    for (NegativeEntry& entry : entries_) {
+        if (entry.register_count == count && entry.start_register == start &&
+            entry.function_code == function_code && !expired(entry, now_ms)) {
+            entry.hits++;
+            hits_++;
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+// ============================================================================
+// Status
+// ============================================================================
+
+size_t NegativeCache::size(uint32_t now_ms) const {
+    size_t count = 0;
+    for (const NegativeEntry& entry : entries_) {
+        count += expired(entry, now_ms) ? 0 : 1;
+    }
+    return count;
+}
+
+void NegativeCache::for_each(uint32_t now_ms, const EntryCallback& callback) const {
+    for (const NegativeEntry& entry : entries_) {
+        if (!expired(entry, now_ms)) {
+            callback(entry, now_ms - entry.stored_ms);
+        }
+    }
+}
@@ -0,0 +1,77 @@
+/**
+ * @file negative_cache.h
+ * @brief Remembers register ranges the inverter answers with a Modbus exception
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include "../config.h"
+
+#include <Arduino.h>
+
+#include <functional>
+
+/**
+ * @brief One read range known to fail, and how the inverter refused it
+ */
+struct NegativeEntry {
+    uint8_t function_code = 0;
+    uint16_t start_register = 0;
+    uint16_t register_count = 0; // 0 = slot unused
+    uint16_t failed_register = 0; // Register the inverter named in its exception
+    uint8_t exception_code = 0;
+    uint32_t stored_ms = 0;
+    uint32_t hits = 0; // Repeats answered locally
+};
+
+/**
+ * @brief Negative cache for reads that always end in a Modbus exception
+ *
+ * Tools probing the register map, and integrations configured for another
+ * inverter model, keep reading ranges this inverter does not implement.
+ * Each such read would cost a full bus round trip just to get the same
+ * exception back. Exceptions that depend only on the request (illegal
+ * function, address or value) are remembered per (function, start, count)
+ * for NEGATIVE_CACHE_TTL_MS, so repeats can be answered without the bus.
+ * Busy or device-failure exceptions are transient and never stored.
+ *
+ * Not thread-safe: the owner serializes access.
+ */
+class NegativeCache {
+  public:
+    static constexpr size_t MAX_ENTRIES = NEGATIVE_CACHE_SIZE;
+
+    using EntryCallback = std::function<void(const NegativeEntry& entry, uint32_t age_ms)>;
+
+    /// Whether an exception code is a property of the request rather than of the moment
+    static bool is_permanent(uint8_t exception_code);
+
+    /// Remember a refused read; returns false for transient exception codes
+    bool store(uint8_t function_code, uint16_t start, uint16_t count, uint16_t failed_register,
+               uint8_t exception_code, uint32_t now_ms);
+    /// Whether exactly this read is known to fail (no hit counted)
+    bool contains(uint8_t function_code, uint16_t start, uint16_t count, uint32_t now_ms) const;
+    /// Known-failing entry for exactly this read, or nullptr (counts the hit)
+    const NegativeEntry* lookup(uint8_t function_code, uint16_t start, uint16_t count,
+                                uint32_t now_ms);
+    /// Drop entries inside a range that was just read successfully
+    size_t forget(uint8_t function_code, uint16_t start, uint16_t count);
+    /// Drop everything; returns entries dropped
+    size_t clear();
+
+    // ========== Status ==========
+    size_t size(uint32_t now_ms) const;
+    void for_each(uint32_t now_ms, const EntryCallback& callback) const;
+    uint32_t get_hits() const { return hits_; }
+    uint32_t get_stores() const { return stores_; }
+
+  private:
+    static bool expired(const NegativeEntry& entry, uint32_t now_ms);
+
+    NegativeEntry entries_[MAX_ENTRIES];
+    uint32_t hits_ = 0;   // Reads answered with a remembered exception
+    uint32_t stores_ = 0; // Exceptions remembered
+};
@@ -0,0 +1,261 @@
+/**
+ * @file poll_predictor.cpp
+ * @brief Learns periodic client read patterns so the bridge can prefetch them
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#include "poll_predictor.h"
+
+#include "logger.h"
+
+static const char* TAG = "prefetch";
+
+// ============================================================================
+// Pattern Table
+// ============================================================================
+
+uint32_t PollPredictor::tolerance_ms(uint32_t period_ms) {
+    // A quarter period absorbs HA scheduling jitter; never less than 200ms
+    return std::max<uint32_t>(period_ms / 4, 200);
+}
+
+PollPattern* PollPredictor::find(const TcpParseResult& read) {
+    for (PollPattern& pattern : patterns_) {
+        if (pattern.register_count == read.register_count &&
+            pattern.start_register == read.start_register &&
+            pattern.function_code == read.function_code &&
+            memcmp(pattern.inverter_serial, read.inverter_serial, TCP_PROTO_DONGLE_SERIAL_LEN) ==
+                0) {
+            return &pattern;
+        }
+    }
+    return nullptr;
+}
+
+PollPattern* PollPredictor::claim(const TcpParseResult& read, uint32_t now_ms) {
+    // Free slot first, otherwise the least frequent pattern, oldest on a tie
+    PollPattern* victim = nullptr;
+    uint8_t victim_freq = 0;
+    for (PollPattern& pattern : patterns_) {
+        if (pattern.register_count == 0) {
+            victim = &pattern;
+            victim_freq = 0;
+            break;
+        }
+        const uint8_t freq = sketch_estimate(key_hash(pattern));
+        if (!victim || freq < victim_freq ||
+            (freq == victim_freq &&
+             now_ms - pattern.last_seen_ms > now_ms - victim->last_seen_ms)) {
+            victim = &pattern;
+            victim_freq = freq;
+        }
+    }
+
+    // Admission: a read must recur more often than the pattern it displaces
+    const uint8_t candidate_freq = sketch_estimate(
+        key_hash(read.function_code, read.start_register, read.register_count,
+                 read.inverter_serial));
+    if (victim->register_count != 0 && candidate_freq <= victim_freq) {
+        admission_rejects_++;
+        return nullptr;
+    }
+    admissions_++;
+
+    if (victim->prefetched) {
+        prefetch_wasted_++;
+    }
+
+    *victim = PollPattern();
+    victim->function_code = read.function_code;
+    victim->start_register = read.start_register;
+    victim->register_count = read.register_count;
+    memcpy(victim->inverter_serial, read.inverter_serial, TCP_PROTO_DONGLE_SERIAL_LEN);
+    victim->last_seen_ms = now_ms;
+    return victim;
+}
+
+// ============================================================================
+// Learning
+// ============================================================================
+
+void PollPredictor::observe(const TcpParseResult& read, bool served_from_cache,
+                            uint32_t now_ms) {
+    if (read.is_write_operation || read.register_count == 0) {
+        return;
+    }
+
+    sketch_increment(key_hash(read.function_code, read.start_register, read.register_count,
+                              read.inverter_serial));
+
+    PollPattern* pattern = find(read);
+    if (!pattern) {
+        claim(read, now_ms);
+        return;
+    }
+
+    const uint32_t interval = now_ms - pattern->last_seen_ms;
+    if (interval < PREFETCH_MIN_PERIOD_MS) {
+        return; // Repeat or second client within one cycle, not a new poll
+    }
+
+    if (pattern->prefetched) {
+        if (served_from_cache) {
+            prefetch_used_++;
+        } else {
+            prefetch_wasted_++;
+        }
+    }
+
+    if (pattern->period_ms == 0) {
+        pattern->period_ms = interval;
+    } else {
+        const uint32_t error = interval > pattern->period_ms ? interval - pattern->period_ms
+                                                             : pattern->period_ms - interval;
+        const bool on_time = error <= tolerance_ms(pattern->period_ms);
+
+        if (pattern->confidence >= PREFETCH_MIN_CONFIDENCE) {
+            predictions_++;
+            if (on_time) {
+                prediction_hits_++;
+            }
+        }
+
+        if (on_time) {
+            pattern->period_ms = (3 * pattern->period_ms + interval) / 4;
+            if (pattern->confidence < UINT8_MAX) {
+                pattern->confidence++;
+            }
+        } else {
+            pattern->period_ms = interval;
+            pattern->confidence = 0;
+        }
+    }
+
+    pattern->last_seen_ms = now_ms;
+    pattern->handled = false;
+    pattern->prefetched = false;
+}
+
+// ============================================================================
+// Frequency Sketch
+// ============================================================================
+
+uint32_t PollPredictor::key_hash(uint8_t function_code, uint16_t start, uint16_t count,
+                                 const uint8_t* serial) {
+    // FNV-1a over the pattern key
+    uint32_t hash = 2166136261u;
+    auto mix = [&hash](uint8_t byte) {
+        hash ^= byte;
+        hash *= 16777619u;
+    };
+    mix(function_code);
+    mix(start & 0xFF);
+    mix(start >> 8);
+    mix(count & 0xFF);
+    mix(count >> 8);
+    for (size_t i = 0; i < TCP_PROTO_DONGLE_SERIAL_LEN; i++) {
+        mix(serial[i]);
+    }
+    return hash;
+}
+
+uint32_t PollPredictor::key_hash(const PollPattern& pattern) {
+    return key_hash(pattern.function_code, pattern.start_register, pattern.register_count,
+                    pattern.inverter_serial);
+}
+
+void PollPredictor::sketch_increment(uint32_t hash) {
+    uint8_t& a = sketch_[0][hash % SKETCH_WIDTH];
+    uint8_t& b = sketch_[1][(hash >> 16) % SKETCH_WIDTH];
+    if (a < 15) {
+        a++;
+    }
+    if (b < 15) {
+        b++;
+    }
+
+    // Halve everything periodically so polls that stopped fade out
+    if (++sketch_samples_ >= SKETCH_RESET_SAMPLES) {
+        sketch_samples_ = 0;
+        for (auto& row : sketch_) {
+            for (uint8_t& counter : row) {
+                counter >>= 1;
+            }
+        }
+    }
+}
+
+uint8_t PollPredictor::sketch_estimate(uint32_t hash) const {
+    return std::min(sketch_[0][hash % SKETCH_WIDTH], sketch_[1][(hash >> 16) % SKETCH_WIDTH]);
+}
+
+// ============================================================================
+// Scheduling
+// ============================================================================
+
+PollPattern* PollPredictor::next_due(uint32_t now_ms) {
+    PollPattern* due = nullptr;
+
+    for (PollPattern& pattern : patterns_) {
+        if (pattern.register_count == 0 || pattern.confidence < PREFETCH_MIN_CONFIDENCE) {
+            continue;
+        }
+
+        const int32_t until_poll = static_cast<int32_t>(pattern.predicted_ms() - now_ms);
+
+        // The poll did not come: whatever was prefetched for it went unused
+        if (until_poll < -static_cast<int32_t>(tolerance_ms(pattern.period_ms))) {
+            if (pattern.prefetched) {
+                prefetch_wasted_++;
+                pattern.prefetched = false;
+                LOGD(TAG, "Predicted poll func=0x%02X start=%u missed", pattern.function_code,
+                     pattern.start_register);
+            }
+            pattern.handled = true;
+            continue;
+        }
+
+        if (pattern.handled || until_poll > static_cast<int32_t>(PREFETCH_LEAD_MS)) {
+            continue;
+        }
+        if (until_poll <= 0) {
+            pattern.handled = true; // Window passed while the bus was busy
+            continue;
+        }
+
+        if (!due || static_cast<int32_t>(pattern.predicted_ms() - due->predicted_ms()) < 0) {
+            due = &pattern;
+        }
+    }
+    return due;
+}
+
+void PollPredictor::mark_handled(PollPattern& pattern, bool prefetched) {
+    pattern.handled = true;
+    pattern.prefetched = prefetched;
+    if (prefetched) {
+        prefetches_++;
+    }
+}
+
+// ============================================================================
+// Statistics
+// ============================================================================
+
+size_t PollPredictor::get_pattern_count() const {
+    size_t count = 0;
+    for (const PollPattern& pattern : patterns_) {
+        count += pattern.register_count != 0 ? 1 : 0;
+    }
+    return count;
+}
+
+size_t PollPredictor::get_confident_count() const {
+    size_t count = 0;
+    for (const PollPattern& pattern : patterns_) {
+        count += pattern.register_count != 0 && pattern.confidence >= PREFETCH_MIN_CONFIDENCE;
+    }
+    return count;
+}
@@ -0,0 +1,97 @@
+/**
+ * @file poll_predictor.h
+ * @brief Learns periodic client read patterns so the bridge can prefetch them
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include "../config.h"
+#include "tcp_protocol.h"
+
+#include <Arduino.h>
+
+/**
+ * @brief One recurring client read and its learned cadence
+ */
+struct PollPattern {
+    uint8_t function_code = 0;
+    uint16_t start_register = 0;
+    uint16_t register_count = 0; // 0 = slot unused
+    uint8_t inverter_serial[TCP_PROTO_DONGLE_SERIAL_LEN] = {0};
+    uint32_t last_seen_ms = 0;
+    uint32_t period_ms = 0;  // Smoothed interval between client polls
+    uint8_t confidence = 0;  // Consecutive intervals that matched the period
+    bool handled = false;    // Prefetch decision taken for the next poll
+    bool prefetched = false; // A prefetch was issued for the next poll
+
+    uint32_t predicted_ms() const { return last_seen_ms + period_ms; }
+};
+
+/**
+ * @brief Polling-pattern learner
+ *
+ * Home Assistant integrations read the same banks at a fixed cadence.
+ * Every client read updates the (function, start, count) pattern it
+ * belongs to; once PREFETCH_MIN_CONFIDENCE consecutive intervals agree,
+ * next_due() offers the pattern PREFETCH_LEAD_MS before its next
+ * predicted poll. Whether the prefetched data was then served from the
+ * cache is tracked as used/wasted.
+ *
+ * Reads are also counted in a small frequency sketch (TinyLFU-style, halved
+ * every SKETCH_RESET_SAMPLES reads). Once the table is full, a new read only
+ * replaces the least frequent pattern if it has been seen more often, so a
+ * burst of one-off reads (e.g. a register scan) cannot flush the learned
+ * polls.
+ *
+ * Network side only; not thread-safe.
+ */
+class PollPredictor {
+  public:
+    static constexpr size_t MAX_PATTERNS = 8;
+    static constexpr size_t SKETCH_WIDTH = 64;           // Counters per sketch row
+    static constexpr uint16_t SKETCH_RESET_SAMPLES = 256; // Reads between halvings
+
+    /// Record a client read (writes are ignored)
+    void observe(const TcpParseResult& read, bool served_from_cache, uint32_t now_ms);
+    /// Pattern whose prefetch window is open, or nullptr
+    PollPattern* next_due(uint32_t now_ms);
+    void mark_handled(PollPattern& pattern, bool prefetched);
+
+    // ========== Statistics ==========
+    size_t get_pattern_count() const;
+    size_t get_confident_count() const;
+    uint32_t get_predictions() const { return predictions_; }
+    uint32_t get_prediction_hits() const { return prediction_hits_; }
+    uint32_t get_prefetches() const { return prefetches_; }
+    uint32_t get_prefetch_used() const { return prefetch_used_; }
+    uint32_t get_prefetch_wasted() const { return prefetch_wasted_; }
+    uint32_t get_admissions() const { return admissions_; }
+    uint32_t get_admission_rejects() const { return admission_rejects_; }
+
+  private:
+    static uint32_t tolerance_ms(uint32_t period_ms);
+    PollPattern* find(const TcpParseResult& read);
+    PollPattern* claim(const TcpParseResult& read, uint32_t now_ms);
+
+    // ========== Frequency Sketch ==========
+    static uint32_t key_hash(uint8_t function_code, uint16_t start, uint16_t count,
+                             const uint8_t* serial);
+    static uint32_t key_hash(const PollPattern& pattern);
+    void sketch_increment(uint32_t hash);
+    uint8_t sketch_estimate(uint32_t hash) const;
+
+    PollPattern patterns_[MAX_PATTERNS];
+    uint8_t sketch_[2][SKETCH_WIDTH] = {}; // Count-min, saturating at 15
+    uint16_t sketch_samples_ = 0;
+
+    uint32_t predictions_ = 0;     // Polls that arrived while their pattern was confident
+    uint32_t prediction_hits_ = 0; // ...of which on time (within tolerance)
+    uint32_t prefetches_ = 0;
+    uint32_t prefetch_used_ = 0;   // Next poll was answered from the cache
+    uint32_t prefetch_wasted_ = 0; // Next poll missed the cache or never came
+    uint32_t admissions_ = 0;        // Reads that took a pattern slot
+    uint32_t admission_rejects_ = 0; // ...and that were kept out as too rare
+};
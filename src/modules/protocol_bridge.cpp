@@ -9,16 +9,73 @@
 
 #include "../config.h"
 #include "logger.h"
+#include "network_manager.h"
 
-#include <esp_random.h>
+#include <Esp.h>
 
-#include <utility>
-
-#include <WiFi.h>
+#include <algorithm>
 
 static const char* TAG = "bridge";
+static const char* const QUEUE_SHARE_EXCEEDED = "Bridge queue share exceeded";
+static constexpr uint8_t MODBUS_EXCEPTION_SERVER_BUSY = 0x06;
 static constexpr uint8_t MODBUS_EXCEPTION_GATEWAY_TARGET_FAILED = 0x0B;
 
+// Cache-first TTL per function code and register range. The shortest TTL of
+// any rule overlapping a read applies; reads no rule covers always go to RS485.
+struct CacheTtlRule {
+    uint8_t function_code;
+    uint16_t first_register;
+    uint16_t last_register;
+    uint32_t ttl_ms;
+};
+
+static const CacheTtlRule CACHE_TTL_RULES[] = {
+    {0x04, 0, 0xFFFF, CACHE_TTL_INPUT_MS},   // Live measurements
+    {0x03, 0, 0xFFFF, CACHE_TTL_HOLDING_MS}, // Settings
+    {0x03, 12, 14, CACHE_TTL_INPUT_MS},      // Inverter clock
+};
+
+static uint32_t cache_first_ttl_ms(uint8_t function_code, uint16_t start, uint16_t count) {
+    if (count == 0) {
+        return 0;
+    }
+
+    // Write function codes have no rules, so writes always get 0
+    const uint32_t first = start;
+    const uint32_t last = first + count - 1;
+    uint32_t ttl_ms = 0;
+    for (const CacheTtlRule& rule : CACHE_TTL_RULES) {
+        if (rule.function_code != function_code || last < rule.first_register ||
+            first > rule.last_register) {
+            continue;
+        }
+        if (ttl_ms == 0 || rule.ttl_ms < ttl_ms) {
+            ttl_ms = rule.ttl_ms;
+        }
+    }
+    return ttl_ms;
+}
+
+namespace {
+// Holds the fallback cache mutex for a scope (no-op before begin())
+class CacheLock {
+  public:
+    explicit CacheLock(SemaphoreHandle_t mutex) : mutex_(mutex) {
+        if (mutex_) {
+            xSemaphoreTake(mutex_, portMAX_DELAY);
+        }
+    }
+    ~CacheLock() {
+        if (mutex_) {
+            xSemaphoreGive(mutex_);
+        }
+    }
+
+  private:
+    SemaphoreHandle_t mutex_;
+};
+} // namespace
+
 ProtocolBridge& ProtocolBridge::getInstance() {
     static ProtocolBridge instance;
     return instance;
@@ -29,18 +86,407 @@ void ProtocolBridge::begin(const String& dongle_serial) {
 
     LOGI(TAG, "Initializing Protocol Bridge");
     LOGI(TAG, "  Dongle Serial: %s", dongle_serial_.c_str());
-    LOGI(TAG, "  RS485 worker queue: %u request(s)", (unsigned) REQUEST_QUEUE_MAX_DEPTH);
+    LOGI(TAG, "  RS485 worker queue: %u request(s) now, %u-%u by free heap",
+         (unsigned) update_queue_limit(), (unsigned) BRIDGE_QUEUE_MIN_DEPTH,
+         (unsigned) REQUEST_QUEUE_MAX_DEPTH);
+    LOGI(TAG, "  Register shadow: %u registers now, %u-%u by free heap",
+         (unsigned) update_cache_capacity(), 2u * RegisterShadow::MIN_REGISTERS_PER_TABLE,
+         2u * RegisterShadow::REGISTERS_PER_TABLE);
+    last_cache_resize_ms_ = millis();
+
+    response_buffer_.reserve(TCP_PROTO_MAX_RESPONSE_SIZE);
+    cache_first_buffer_.reserve(TCP_PROTO_MAX_RESPONSE_SIZE);
+    shadow_frame_.reserve(MODBUS_MIN_RESPONSE_SIZE + 2 * MODBUS_MAX_REGISTERS);
+    frame_buffer_.reserve(MODBUS_MIN_RESPONSE_SIZE + 2 * MODBUS_MAX_REGISTERS);
+    if (cache_mutex_ == nullptr) {
+        cache_mutex_ = xSemaphoreCreateMutex();
+    }
 }
 
+// ============================================================================
+// Network Side
+// ============================================================================
+
 void ProtocolBridge::loop() {
     if (!is_ready()) {
         return;
     }
 
+    refresh_live_clients();
+    deliver_completions();
+    refresh_client_occupancy();
+    if (millis() - last_cache_resize_ms_ >= SHADOW_RESIZE_MS) {
+        last_cache_resize_ms_ = millis();
+        update_cache_capacity();
+    }
+#if BRIDGE_PREFETCH
+    run_prefetcher();
+#endif
+
+    // Without a dedicated task the worker runs inline, as before
+    if (!worker_task_) {
+        run_worker();
+        deliver_completions();
+    }
+}
+
+bool ProtocolBridge::start_worker_task() {
+    if (worker_task_) {
+        return true;
+    }
+    if (!rs485_) {
+        LOGE(TAG, "Cannot start RS485 worker task: no RS485 manager");
+        return false;
+    }
+
+    BaseType_t core = RS485_WORKER_TASK_CORE;
+    if (core < 0)
+        core = tskNO_AFFINITY;
+    if (xTaskCreatePinnedToCore(worker_task_trampoline, "RS485Worker", RS485_WORKER_TASK_STACK,
+                                this, RS485_WORKER_TASK_PRIORITY, &worker_task_,
+                                core) != pdPASS) {
+        LOGE(TAG, "Failed to create RS485 worker task");
+        worker_task_ = nullptr;
+        return false;
+    }
+
+    LOGI(TAG, "RS485 worker task started (core=%d, prio=%d)", (int) core,
+         RS485_WORKER_TASK_PRIORITY);
+    return true;
+}
+
+void ProtocolBridge::worker_task_trampoline(void* arg) {
+    ProtocolBridge* bridge = static_cast<ProtocolBridge*>(arg);
+    while (true) {
+        bridge->rs485_->loop();
+        bridge->run_worker();
+        // Sleep until the UART reports a frame boundary or the idle wait ends
+        bridge->rs485_->wait_for_activity(RS485_WORKER_IDLE_WAIT_MS);
+    }
+}
+
+void ProtocolBridge::refresh_live_clients() {
+    static_assert(TCP_MAX_CLIENTS <= LIVE_CLIENT_SLOTS, "live client snapshot too small");
+
+    AsyncClient* handles[LIVE_CLIENT_SLOTS];
+    const size_t count = tcp_server_->copy_client_handles(handles, LIVE_CLIENT_SLOTS);
+
+    // Slots are stable: a handle that stays connected never moves, so the
+    // worker cannot miss it while this update is in progress.
+    for (auto& slot : live_clients_) {
+        AsyncClient* handle = slot.load();
+        if (handle && std::find(handles, handles + count, handle) == handles + count) {
+            slot.store(nullptr);
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (is_client_live(handles[i])) {
+            continue;
+        }
+        for (auto& slot : live_clients_) {
+            if (slot.load() == nullptr) {
+                slot.store(handles[i]);
+                break;
+            }
+        }
+    }
+}
+
+void ProtocolBridge::refresh_client_occupancy() {
+    for (const auto& slot : live_clients_) {
+        AsyncClient* handle = slot.load();
+        TCPClient* client = handle ? tcp_server_->resolve_client(handle) : nullptr;
+        if (client) {
+            client->bridge_queued = static_cast<uint16_t>(count_queued(handle));
+        }
+    }
+}
+
+size_t ProtocolBridge::update_queue_limit() {
+    // A queued request holds its packet buffers and, once answered, a TCP
+    // send buffer: grow the queue only as far as the heap can spare
+    const uint32_t free_heap = ESP.getFreeHeap();
+    const uint32_t spare = free_heap > QUEUE_HEAP_RESERVE ? free_heap - QUEUE_HEAP_RESERVE : 0;
+    const size_t limit = std::min<size_t>(
+        std::max<size_t>(spare / QUEUE_HEAP_PER_SLOT, BRIDGE_QUEUE_MIN_DEPTH),
+        BRIDGE_QUEUE_MAX_DEPTH);
+    queue_limit_ = limit;
+    return limit;
+}
+
+size_t ProtocolBridge::update_cache_capacity() {
+    // Shadow tables are the largest heap user that can give memory back: grow
+    // them while the heap can spare it, shrink them (dropping the highest
+    // registers) when it runs low. The current tables count as available, so
+    // a grow is not read as heap pressure at the next check.
+    const uint32_t free_heap = ESP.getFreeHeap();
+    CacheLock lock(cache_mutex_);
+    const uint16_t current = register_shadow_.registers_per_table();
+    const uint32_t available = free_heap + RegisterShadow::heap_bytes(current);
+    const uint32_t spare = available > SHADOW_HEAP_RESERVE ? available - SHADOW_HEAP_RESERVE : 0;
+    uint32_t target = (spare / RegisterShadow::BYTES_PER_REGISTER) & ~31u;
+    if (target < RegisterShadow::MIN_REGISTERS_PER_TABLE) {
+        target = RegisterShadow::MIN_REGISTERS_PER_TABLE;
+    } else if (target > RegisterShadow::REGISTERS_PER_TABLE) {
+        target = RegisterShadow::REGISTERS_PER_TABLE;
+    }
+
+    // Resizing reallocates: the largest new table must fit in one free block
+    if (target != current && ESP.getMaxAllocHeap() < target * sizeof(uint32_t)) {
+        target = current;
+    }
+
+    if (target != current) {
+        const size_t dropped = register_shadow_.resize(static_cast<uint16_t>(target));
+        cache_invalidations_ += dropped;
+        cache_resizes_++;
+        LOGI(TAG, "Register shadow %s to %u registers per table (free heap %u, %u dropped)",
+             target > current ? "grown" : "shrunk", (unsigned) target, (unsigned) free_heap,
+             (unsigned) dropped);
+    }
+    cache_capacity_ = register_shadow_.capacity();
+    return cache_capacity_;
+}
+
+size_t ProtocolBridge::count_queued(const AsyncClient* handle) {
+    // Producer-side view: the worker may pop meanwhile, which only makes the
+    // count stale high, never low. client_handle is not written by the worker.
+    const size_t queued = request_queue_.size();
+    size_t count = 0;
+    for (size_t i = 0; i < queued; i++) {
+        count += request_queue_.at(i)->client_handle == handle ? 1 : 0;
+    }
+    return count;
+}
+
+const char* ProtocolBridge::check_admission(const AsyncClient* handle, BridgePriority priority) {
+    size_t limit = update_queue_limit();
+#if BRIDGE_PRIORITY_SCHEDULING
+    // Keep the last slot for writes so read load can never lock them out
+    if (priority != BridgePriority::WRITE) {
+        limit -= WRITE_RESERVED_SLOTS;
+    }
+#endif
+    if (request_queue_.size() >= limit) {
+        return "Bridge queue full";
+    }
+
+#if BRIDGE_FAIR_QUEUING
+    // One poller must not crowd out the others: each connected client may
+    // hold an equal share of the queue. Writes are exempt, so a client whose
+    // reads fill its share can still change a setting.
+    const size_t clients = std::max<size_t>(tcp_server_->get_client_count(), 1);
+    const size_t share = std::max<size_t>(limit / clients, 1);
+    if (priority != BridgePriority::WRITE && count_queued(handle) >= share) {
+        return QUEUE_SHARE_EXCEEDED;
+    }
+#endif
+    return nullptr;
+}
+
+bool ProtocolBridge::is_client_live(const AsyncClient* handle) const {
+    if (!handle) {
+        return false;
+    }
+    for (const auto& slot : live_clients_) {
+        if (slot.load() == handle) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ProtocolBridge::run_prefetcher() {
+    const uint32_t now = millis();
+
+    // Another master on the bus: stay off it for a while
+    const uint32_t foreign = rs485_->get_external_requests_detected();
+    if (foreign != foreign_requests_seen_) {
+        foreign_requests_seen_ = foreign;
+        last_foreign_traffic_ms_ = now;
+    }
+    if (foreign != 0 && now - last_foreign_traffic_ms_ < PREFETCH_BACKOFF_MS) {
+        return;
+    }
+
+    // Only into an idle bridge: client requests never queue behind a prefetch
+    if (paused_ || has_active_request_ || !request_queue_.empty() ||
+        breaker_state_.load() == BreakerState::OPEN) {
+        return;
+    }
+    auto& guard_mgr = OperationGuardManager::getInstance();
+    if (!guard_mgr.canPerformOperation(OperationGuard::OperationType::TCP_CLIENT_PROCESSING)) {
+        return;
+    }
+
+    PollPattern* pattern = poll_predictor_.next_due(now);
+    if (!pattern) {
+        return;
+    }
+
+    // Nothing to do if the cache will still be fresh when the poll arrives
+    const uint32_t ttl_ms = cache_first_ttl_ms(pattern->function_code, pattern->start_register,
+                                               pattern->register_count);
+    uint32_t age_ms = 0;
+    if (ttl_ms == 0 ||
+        (get_cached_range_age(pattern->function_code, pattern->start_register,
+                              pattern->register_count, age_ms) &&
+         age_ms + (pattern->predicted_ms() - now) <= ttl_ms)) {
+        poll_predictor_.mark_handled(*pattern, false);
+        return;
+    }
+
+    // After the predicted poll the poll itself reads the bank
+    const uint32_t id = enqueue_background_read(pattern->function_code, pattern->start_register,
+                                                pattern->register_count,
+                                                pattern->inverter_serial, "prefetch",
+                                                pattern->predicted_ms());
+    if (!id) {
+        return;
+    }
+    poll_predictor_.mark_handled(*pattern, true);
+
+    LOGD(TAG, "[REQ#%u] Prefetch func=0x%02X regs %u-%u, poll expected in %lums", id,
+         pattern->function_code, pattern->start_register,
+         (unsigned) (pattern->start_register + pattern->register_count - 1),
+         (unsigned long) (pattern->predicted_ms() - now));
+}
+
+void ProtocolBridge::revalidate(const TcpParseResult& read, uint32_t age_ms,
+                                uint32_t patience_ms) {
+    const uint32_t now = millis();
+
+    // One refresh per range until it lands: while the cached copy is older
+    // than the last refresh, that refresh is still queued or on the bus
+    StaleRefresh* slot = &refresh_slots_[0];
+    for (StaleRefresh& refresh : refresh_slots_) {
+        if (refresh.function_code == read.function_code &&
+            refresh.start_register == read.start_register &&
+            refresh.register_count == read.register_count) {
+            const uint32_t since_issue = now - refresh.issued_ms;
+            if (since_issue < STALE_REFRESH_WINDOW_MS && age_ms >= since_issue) {
+                return;
+            }
+            slot = &refresh;
+            break;
+        }
+        if (now - refresh.issued_ms > now - slot->issued_ms) {
+            slot = &refresh;
+        }
+    }
+
+    // Background reads count as one more client for the fair share
+    if (paused_ || breaker_state_.load() == BreakerState::OPEN ||
+        check_admission(nullptr, BridgePriority::BULK)) {
+        return; // The stale copy keeps serving until the hard TTL
+    }
+    const uint32_t id =
+        enqueue_background_read(read.function_code, read.start_register, read.register_count,
+                                read.inverter_serial, "refresh", now + patience_ms);
+    if (!id) {
+        return;
+    }
+
+    slot->function_code = read.function_code;
+    slot->start_register = read.start_register;
+    slot->register_count = read.register_count;
+    slot->issued_ms = now;
+    stale_refreshes_++;
+
+    LOGD(TAG, "[REQ#%u] Stale refresh func=0x%02X regs %u-%u (age=%lums)", id,
+         read.function_code, read.start_register,
+         (unsigned) (read.start_register + read.register_count - 1), (unsigned long) age_ms);
+}
+
+uint32_t ProtocolBridge::enqueue_background_read(uint8_t function_code, uint16_t start,
+                                                 uint16_t count, const uint8_t* inverter_serial,
+                                                 const char* label, uint32_t deadline_ms) {
+    // A refresh is queued while its client read still sits in the uncommitted
+    // push slot, so the serial is copied out before that slot is reset
+    uint8_t serial[TCP_PROTO_DONGLE_SERIAL_LEN];
+    memcpy(serial, inverter_serial, TCP_PROTO_DONGLE_SERIAL_LEN);
+
+    BridgeRequest* slot = request_queue_.begin_push();
+    if (!slot) {
+        return 0;
+    }
+
+    BridgeRequest& request = *slot;
+    request = BridgeRequest();
+    request.wifi_request.success = true;
+    request.wifi_request.function_code = function_code;
+    request.wifi_request.start_register = start;
+    request.wifi_request.register_count = count;
+    memcpy(request.wifi_request.inverter_serial, serial, TCP_PROTO_DONGLE_SERIAL_LEN);
+    request.background = true;
+    strncpy(request.client_ip, label, sizeof(request.client_ip) - 1);
+    request.timestamp = millis();
+    request.deadline_ms = deadline_ms;
+    request.priority = BridgePriority::BULK;
+    request.id = ++total_requests_;
+    request.bus_start = start;
+    request.bus_count = count;
+
+    const uint32_t id = request.id;
+    request_queue_.commit_push();
+    return id;
+}
+
+void ProtocolBridge::deliver_completions() {
+    while (BridgeCompletion* completion = completions_.front()) {
+        for (AsyncClient* handle : completion->client_handles) {
+            TCPClient* client = tcp_server_->resolve_client(handle);
+            if (!client || !client->client) {
+                LOGW(TAG, "[REQ#%u] ⚠ Client gone, dropping response", completion->request_id);
+                client_gone_count_++;
+            } else if (completion->action == BridgeCompletion::Action::CLOSE) {
+                tcp_server_->request_client_close(client->client, completion->reason);
+            } else {
+                const char* data = reinterpret_cast<const char*>(completion->packet.data());
+                const size_t size = completion->packet.size();
+                const size_t written = client->client->write(data, size);
+                if (written == size) {
+                    client->last_activity = millis();
+                    client->bridge_pending_since_ms = 0;
+                    LOGI(TAG, "[REQ#%u] ✓ Response sent to %s (%u bytes)", completion->request_id,
+                         client->remote_ip.c_str(), (unsigned) written);
+                } else {
+                    LOGW(TAG, "[REQ#%u] ⚠ Partial write: %u/%u bytes", completion->request_id,
+                         (unsigned) written, (unsigned) size);
+                }
+            }
+        }
+        completions_.pop();
+    }
+}
+
+// ============================================================================
+// Worker Side
+// ============================================================================
+
+void ProtocolBridge::run_worker() {
+    if (!rs485_) {
+        return;
+    }
+
+    if (paused_ && !queue_empty()) {
+        drop_queued_requests("bridge paused");
+    }
+
+#if BRIDGE_CIRCUIT_BREAKER
+    update_breaker();
+#endif
+
     if (!waiting_rs485_response_ && !pending_rs485_send_retry_ && !has_active_request_) {
         start_next_request();
     }
 
+#if BRIDGE_SINGLE_FLIGHT
+    if (has_active_request_) {
+        attach_queued_duplicates();
+    }
+#endif
+
     if (pending_rs485_send_retry_) {
         process_pending_rs485_send();
     }
@@ -54,7 +500,7 @@ void ProtocolBridge::loop() {
         // Check timeout
         if (waiting_rs485_response_ && millis() - last_request_time_ > timeout_ms) {
             // Don't log as error if it's a network issue
-            if (WiFi.status() != WL_CONNECTED) {
+            if (!NetworkManager::getInstance().isConnected()) {
                 LOGW(TAG, "Request timeout during WiFi disconnection (%lu ms)", timeout_ms);
             } else {
                 LOGW(TAG, "Request timeout (%lu ms)", timeout_ms);
@@ -62,6 +508,9 @@ void ProtocolBridge::loop() {
             send_error_response("Request timeout");
             waiting_rs485_response_ = false;
             failed_requests_++;
+#if BRIDGE_CIRCUIT_BREAKER
+            note_bus_result(false);
+#endif
             finish_current_request(BridgeWorkerState::FAILED);
         }
     }
@@ -71,11 +520,180 @@ void ProtocolBridge::loop() {
     }
 }
 
-TCPClient* ProtocolBridge::resolve_current_client() {
-    if (!tcp_server_ || !current_request_.client_handle) {
-        return nullptr;
+// ============================================================================
+// Circuit Breaker
+// ============================================================================
+
+void ProtocolBridge::update_breaker() {
+    const BreakerState state = breaker_state_.load();
+    if (!rs485_->is_inverter_link_up()) {
+        // The RS485 manager keeps probing the serial with backoff meanwhile
+        if (state != BreakerState::OPEN) {
+            open_breaker("inverter link down");
+        }
+        breaker_link_down_ = true;
+        return;
+    }
+
+    // Link back (its serial probe was answered), or time for one trial request
+    if (state == BreakerState::OPEN &&
+        (breaker_link_down_ || millis() - breaker_opened_ms_ >= BREAKER_OPEN_MS)) {
+        breaker_link_down_ = false;
+        breaker_state_.store(BreakerState::HALF_OPEN);
+        LOGI(TAG, "Circuit half-open: next request probes the inverter");
+    }
+}
+
+void ProtocolBridge::note_bus_result(bool responded) {
+    const BreakerState state = breaker_state_.load();
+    if (responded) {
+        consecutive_timeouts_ = 0;
+        if (state != BreakerState::CLOSED && rs485_->is_inverter_link_up()) {
+            breaker_state_.store(BreakerState::CLOSED);
+            LOGI(TAG, "Circuit closed: inverter answering again");
+        }
+        return;
+    }
+
+    if (consecutive_timeouts_ < UINT8_MAX) {
+        consecutive_timeouts_++;
+    }
+    if (state == BreakerState::HALF_OPEN ||
+        (state == BreakerState::CLOSED && consecutive_timeouts_ >= BREAKER_TIMEOUT_THRESHOLD)) {
+        open_breaker("bus timeouts");
+    }
+}
+
+void ProtocolBridge::open_breaker(const char* reason) {
+    breaker_state_.store(BreakerState::OPEN);
+    breaker_opened_ms_ = millis();
+    breaker_opens_++;
+    LOGW(TAG, "Circuit open (%s): failing fast, next probe in %lums", reason,
+         (unsigned long) BREAKER_OPEN_MS);
+}
+
+void ProtocolBridge::fail_fast_current_request() {
+    breaker_fast_fails_++;
+    if (is_bare_background()) {
+        failed_requests_++;
+        finish_current_request(BridgeWorkerState::FAILED);
+        return;
+    }
+    finish_deferred_send_failure("Circuit open: inverter not responding");
+}
+
+const char* ProtocolBridge::get_breaker_state_name() const {
+    switch (breaker_state_.load()) {
+        case BreakerState::CLOSED:
+            return "closed";
+        case BreakerState::OPEN:
+            return "open";
+        case BreakerState::HALF_OPEN:
+            return "half-open";
+    }
+    return "unknown";
+}
+
+bool ProtocolBridge::is_current_client_live() const {
+    if (is_client_live(current_request_.client_handle)) {
+        return true;
+    }
+    for (const BridgeWaiter& waiter : current_request_.waiters) {
+        if (is_client_live(waiter.client_handle)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Address a completion to a request's client and every coalesced waiter
+static void add_request_clients(BridgeCompletion& completion, const BridgeRequest& request) {
+    completion.client_handles.clear();
+    if (request.client_handle) {
+        completion.client_handles.push_back(request.client_handle);
+    }
+    for (const BridgeWaiter& waiter : request.waiters) {
+        completion.client_handles.push_back(waiter.client_handle);
+    }
+}
+
+// Address a completion to the request's clients that asked for exactly this range
+static void add_range_clients(BridgeCompletion& completion, const BridgeRequest& request,
+                              uint16_t start, uint16_t count) {
+    completion.client_handles.clear();
+    if (request.client_handle && request.wifi_request.start_register == start &&
+        request.wifi_request.register_count == count) {
+        completion.client_handles.push_back(request.client_handle);
+    }
+    if (request.wifi_request.is_write_operation) {
+        return; // Combined writes ack every client with its own value
+    }
+    for (const BridgeWaiter& waiter : request.waiters) {
+        if (waiter.start_register == start && waiter.register_count == count) {
+            completion.client_handles.push_back(waiter.client_handle);
+        }
+    }
+}
+
+bool ProtocolBridge::post_response(const std::vector<uint8_t>& packet) {
+    const TcpParseResult& request = current_request_.wifi_request;
+    return post_range_response(packet, request.start_register, request.register_count);
+}
+
+bool ProtocolBridge::post_range_response(const std::vector<uint8_t>& packet, uint16_t start,
+                                         uint16_t count) {
+    BridgeCompletion* completion = completions_.begin_push();
+    if (!completion) {
+        LOGW(TAG, "[REQ#%u] Completion queue full, dropping response", current_request_.id);
+        return false;
+    }
+
+    completion->action = BridgeCompletion::Action::SEND;
+    add_range_clients(*completion, current_request_, start, count);
+    completion->request_id = current_request_.id;
+    completion->reason = nullptr;
+    if (!completion->packet.assign(packet.data(), packet.size())) {
+        LOGE(TAG, "[REQ#%u] Response too large (%u bytes)", current_request_.id,
+             (unsigned) packet.size());
+        return false;
+    }
+    completions_.commit_push();
+    return true;
+}
+
+bool ProtocolBridge::post_client_response(const std::vector<uint8_t>& packet,
+                                          AsyncClient* handle) {
+    BridgeCompletion* completion = completions_.begin_push();
+    if (!completion) {
+        LOGW(TAG, "[REQ#%u] Completion queue full, dropping response", current_request_.id);
+        return false;
+    }
+
+    completion->action = BridgeCompletion::Action::SEND;
+    completion->client_handles.clear();
+    completion->client_handles.push_back(handle);
+    completion->request_id = current_request_.id;
+    completion->reason = nullptr;
+    if (!completion->packet.assign(packet.data(), packet.size())) {
+        return false;
     }
-    return tcp_server_->resolve_client(current_request_.client_handle);
+    completions_.commit_push();
+    return true;
+}
+
+bool ProtocolBridge::post_close(const BridgeRequest& request, const char* reason) {
+    BridgeCompletion* completion = completions_.begin_push();
+    if (!completion) {
+        return false;
+    }
+
+    completion->action = BridgeCompletion::Action::CLOSE;
+    add_request_clients(*completion, request);
+    completion->request_id = request.id;
+    completion->reason = reason;
+    completion->packet.clear();
+    completions_.commit_push();
+    return true;
 }
 
 void ProtocolBridge::process_wifi_request(const uint8_t* data, size_t length, TCPClient* client) {
@@ -88,14 +706,14 @@ void ProtocolBridge::process_wifi_request(const uint8_t* data, size_t length, TC
     // the duration of this synchronous call; after that, the backing vector
     // can move. We keep the AsyncClient* (heap-stable) and the IP string.
     AsyncClient* client_handle = client ? client->client : nullptr;
-    String client_ip = client ? client->remote_ip : String("unknown");
+    const char* client_ip = client ? client->remote_ip.c_str() : "unknown";
 
     // Helper lambda: send error using the currently-passed client pointer,
     // which is still live within this call.
-    auto send_err = [&](const String& err) {
+    auto send_err = [&](const char* err) {
         if (client && client->is_connected() && client->client) {
-            LOGW(TAG, "Error to %s: %s", client_ip.c_str(), err.c_str());
-            tcp_server_->request_client_close(client->client, err.c_str());
+            LOGW(TAG, "Error to %s: %s", client_ip, err);
+            tcp_server_->request_client_close(client->client, err);
         }
     };
 
@@ -121,17 +739,44 @@ void ProtocolBridge::process_wifi_request(const uint8_t* data, size_t length, TC
 
     total_requests_++;
 
+#if BRIDGE_PRIORITY_SCHEDULING
+    if (client) {
+        learn_client_patience(*client, millis());
+    }
+#endif
+
+    BridgeRequest* slot = request_queue_.begin_push();
+    if (!slot) {
+        LOGW(TAG, "Bridge queue full (%u/%u), rejecting request #%u from %s",
+             (unsigned) request_queue_.size(), (unsigned) REQUEST_QUEUE_MAX_DEPTH,
+             total_requests_.load(), client_ip);
+        queue_drops_++;
+        if (client) {
+            client->bridge_drops++;
+        }
+        send_err("Bridge queue full");
+        failed_requests_++;
+        return;
+    }
+
     // Use static buffers instead of String to avoid memory fragmentation
     char req_tag[20];
-    snprintf(req_tag, sizeof(req_tag), "[REQ#%u] ", total_requests_);
+    const uint32_t request_id = total_requests_;
+    snprintf(req_tag, sizeof(req_tag), "[REQ#%u] ", request_id);
     LOGD(TAG, "%sWiFi raw (first 40b): %s", req_tag,
          TcpProtocol::format_hex(data, min(length, (size_t) 40)).c_str());
 
-    TcpParseResult parse_result = TcpProtocol::parse_request(data, length);
-
-    if (!parse_result.success) {
-        LOGE(TAG, "✗ Failed to parse WiFi request: %s", parse_result.error_message.c_str());
-        send_err(parse_result.error_message);
+    // Parse straight into the free queue slot; it is only committed on success,
+    // so the request is never copied between parse and enqueue.
+    BridgeRequest& request = *slot;
+    request = BridgeRequest();
+    request.id = request_id;
+    const TcpParseResult& parse_result = request.wifi_request;
+
+    if (!TcpProtocol::parse_request(data, length, request.wifi_request)) {
+        const char* error = TcpProtocol::error_to_string(parse_result.error);
+        LOGE(TAG, "✗ Failed to parse WiFi request: %s", error);
+        send_err(error);
         failed_requests_++;
         return;
     }
@@ -166,46 +811,145 @@ void ProtocolBridge::process_wifi_request(const uint8_t* data, size_t length, TC
                  parse_result.register_count);
     }
 
-    LOGI(TAG, "━━━ Request #%u: %s %s from %s ━━━", total_requests_, op_type, op_details,
-         client_ip.c_str());
+    LOGI(TAG, "━━━ Request #%u: %s %s from %s ━━━", request_id, op_type, op_details,
+         client_ip);
     LOGD(TAG, "%sInverter SN: %s", req_tag,
          TcpProtocol::format_serial(parse_result.inverter_serial).c_str());
 
-    if (queue_full()) {
-        LOGW(TAG, "Bridge queue full (%u/%u), rejecting request #%u from %s",
-             (unsigned) request_queue_count_, (unsigned) REQUEST_QUEUE_MAX_DEPTH, total_requests_,
-             client_ip.c_str());
+#if NEGATIVE_CACHE_ENABLED
+    // Known to fail: not worth a bus round trip, nor a prefetch pattern
+    if (serve_from_negative_cache(request, client)) {
+        return;
+    }
+#endif
+#if BRIDGE_CACHE_FIRST
+    // A fresh cached copy answers the read without queueing it for RS485
+    const bool served_from_cache = serve_from_cache(request, client);
+#if BRIDGE_PREFETCH
+    poll_predictor_.observe(parse_result, served_from_cache, millis());
+#endif
+    if (served_from_cache) {
+        return;
+    }
+#endif
+#if BRIDGE_CIRCUIT_BREAKER
+    // Queueing would only make the client wait for a timeout
+    if (breaker_state_.load() == BreakerState::OPEN) {
+        answer_while_open(request, client);
+        return;
+    }
+#endif
+
+    request.priority = classify(parse_result);
+
+    if (const char* reject = check_admission(client_handle, request.priority)) {
+        LOGW(TAG, "%s%s (%u/%u), rejecting request from %s", req_tag, reject,
+             (unsigned) request_queue_.size(), (unsigned) queue_limit_.load(), client_ip);
         queue_drops_++;
-        send_err("Bridge queue full");
         failed_requests_++;
+        if (client) {
+            client->bridge_drops++;
+        }
+#if BRIDGE_FAIR_QUEUING
+        // Over its share, the client is told to back off but keeps its connection
+        if (reject == QUEUE_SHARE_EXCEEDED && client && client->client &&
+            build_exception_response(cache_first_buffer_, parse_result,
+                                     parse_result.start_register, MODBUS_EXCEPTION_SERVER_BUSY)) {
+            client->client->write(reinterpret_cast<const char*>(cache_first_buffer_.data()),
+                                  cache_first_buffer_.size());
+            return;
+        }
+#endif
+        send_err(reject);
         return;
     }
 
-    BridgeRequest request;
     request.client_handle = client_handle;
-    request.client_ip = client_ip;
-    request.wifi_request = parse_result;
+    strncpy(request.client_ip, client_ip, sizeof(request.client_ip) - 1);
+    request.client_ip[sizeof(request.client_ip) - 1] = '\0';
     request.timestamp = millis();
+    request.deadline_ms = request.timestamp + client_patience_ms(client);
     request.retry_count = 0;
-    request.id = total_requests_;
+    request.bus_start = parse_result.start_register;
+    request.bus_count = parse_result.register_count;
 
-    if (!enqueue_request(std::move(request))) {
-        LOGW(TAG, "Bridge queue full during enqueue, rejecting request #%u from %s",
-             total_requests_, client_ip.c_str());
-        queue_drops_++;
-        send_err("Bridge queue full");
-        failed_requests_++;
+    // The worker checks liveness against the snapshot, so it must already
+    // include this client when the request becomes visible.
+    refresh_live_clients();
+    request_queue_.commit_push();
+    queued_requests_++;
+    if (client && client->bridge_pending_since_ms == 0) {
+        client->bridge_pending_since_ms = request.timestamp;
+    }
+
+    LOGI(TAG, "[REQ#%u] Queued for RS485 worker (%u/%u, worker=%s)", request_id,
+         (unsigned) request_queue_.size(), (unsigned) queue_limit_.load(),
+         worker_state_name(worker_state_));
+}
+
+BridgePriority ProtocolBridge::classify(const TcpParseResult& request) {
+    if (request.is_write_operation) {
+        return BridgePriority::WRITE;
+    }
+    return request.register_count >= BRIDGE_BULK_READ_REGS ? BridgePriority::BULK
+                                                            : BridgePriority::INTERACTIVE;
+}
+
+void ProtocolBridge::answer_while_open(const BridgeRequest& request, TCPClient* client) {
+    breaker_fast_fails_++;
+    failed_requests_++;
+    if (!client || !client->client) {
         return;
     }
-    queued_requests_++;
 
-    if (!has_active_request_ && !waiting_rs485_response_ && !pending_rs485_send_retry_) {
-        set_current_state(BridgeWorkerState::QUEUED);
+    // Freshest copy within the fallback age, else a gateway exception: either
+    // way the client learns the state of things in milliseconds, not seconds
+    const TcpParseResult& read = request.wifi_request;
+    uint32_t age_ms = 0;
+    const bool cached = !read.is_write_operation &&
+                        get_cached_response(read.function_code, read.start_register,
+                                            read.register_count, cache_first_buffer_,
+                                            FALLBACK_CACHE_MAX_AGE_MS, &age_ms);
+    if (!cached && !build_exception_response(cache_first_buffer_, read, read.start_register,
+                                             MODBUS_EXCEPTION_GATEWAY_TARGET_FAILED)) {
+        return;
     }
+    client->client->write(reinterpret_cast<const char*>(cache_first_buffer_.data()),
+                          cache_first_buffer_.size());
+    client->last_activity = millis();
 
-    LOGI(TAG, "[REQ#%u] Queued for RS485 worker (%u/%u, worker=%s)", total_requests_,
-         (unsigned) request_queue_count_, (unsigned) REQUEST_QUEUE_MAX_DEPTH,
-         worker_state_name(worker_state_));
+    if (cached) {
+        LOGI(TAG, "[REQ#%u] Circuit open: answered from cache (age=%lums)", request.id,
+             (unsigned long) age_ms);
+    } else {
+        LOGW(TAG, "[REQ#%u] Circuit open: refused without touching the bus", request.id);
+    }
+}
+
+void ProtocolBridge::learn_client_patience(TCPClient& client, uint32_t now) {
+    // Dongle clients wait for each answer, so a new request while an older
+    // one is still unanswered means the client gave up on it: the wait is a
+    // sample of its response timeout.
+    if (client.bridge_pending_since_ms == 0) {
+        return;
+    }
+    const uint32_t waited = now - client.bridge_pending_since_ms;
+    client.bridge_pending_since_ms = 0;
+    if (waited < CLIENT_PATIENCE_MIN_MS) {
+        return; // Pipelined request, not a retry
+    }
+
+    // Per client: one impatient tool must not shorten everyone's deadline
+    const uint32_t patience = (3 * client_patience_ms(&client) + waited) / 4;
+    client.bridge_patience_ms = std::min<uint32_t>(
+        std::max<uint32_t>(patience, CLIENT_PATIENCE_MIN_MS), CLIENT_PATIENCE_MAX_MS);
+    LOGD(TAG, "Client %s re-sent after %lums unanswered, patience now %lums",
+         client.remote_ip.c_str(), (unsigned long) waited,
+         (unsigned long) client.bridge_patience_ms);
+}
+
+uint32_t ProtocolBridge::client_patience_ms(const TCPClient* client) {
+    return client && client->bridge_patience_ms ? client->bridge_patience_ms : CLIENT_PATIENCE_MS;
 }
 
 const char* ProtocolBridge::worker_state_name(BridgeWorkerState state) {
@@ -233,38 +977,541 @@ const char* ProtocolBridge::worker_state_name(BridgeWorkerState state) {
     }
 }
 
-void ProtocolBridge::set_pause(bool paused) {
-    paused_ = paused;
-    if (paused_) {
-        drop_queued_requests("bridge paused");
+void ProtocolBridge::set_pause(bool paused) {
+    // The worker drops queued requests once it sees the flag
+    paused_ = paused;
+}
+
+void ProtocolBridge::set_current_state(BridgeWorkerState state) {
+    worker_state_ = state;
+}
+
+bool ProtocolBridge::dequeue_request(BridgeRequest& request) {
+    // The ring only pops from the front, so a request taken from further
+    // back is marked consumed and released once everything ahead of it is.
+    BridgeRequest* next = nullptr;
+    const size_t queued = request_queue_.size();
+    for (size_t i = 0; i < queued; i++) {
+        BridgeRequest* candidate = request_queue_.at(i);
+        if (candidate->consumed) {
+            continue;
+        }
+#if BRIDGE_PRIORITY_SCHEDULING || BRIDGE_FAIR_QUEUING
+        if (!next || outranks(*candidate, *next)) {
+            next = candidate;
+        }
+#else
+        next = candidate;
+        break;
+#endif
+    }
+
+    if (next) {
+        if (next != request_queue_.front()) {
+            reordered_requests_++;
+        }
+        request = *next;
+        next->consumed = true;
+        note_dispatch(request.client_handle);
+    }
+    release_consumed();
+    return next != nullptr;
+}
+
+void ProtocolBridge::release_consumed() {
+    while (const BridgeRequest* front = request_queue_.front()) {
+        if (!front->consumed) {
+            break;
+        }
+        request_queue_.pop();
+    }
+}
+
+bool ProtocolBridge::outranks(const BridgeRequest& a, const BridgeRequest& b) const {
+#if BRIDGE_PRIORITY_SCHEDULING
+    if (a.priority != b.priority) {
+        return a.priority < b.priority;
+    }
+#endif
+    const bool writes = a.priority == BridgePriority::WRITE && b.priority == BridgePriority::WRITE;
+#if BRIDGE_FAIR_QUEUING
+    // Round-robin within a class: the client dispatched longest ago goes next.
+    // Not for writes: combined in arrival order, the last value must win.
+    if (!writes && a.client_handle != b.client_handle) {
+        const uint32_t turn_a = last_dispatch(a.client_handle);
+        const uint32_t turn_b = last_dispatch(b.client_handle);
+        if (turn_a != turn_b) {
+            return turn_a < turn_b;
+        }
+    }
+#endif
+    // Writes keep arrival order; reads go earliest deadline first
+    if (!writes && a.deadline_ms != b.deadline_ms) {
+        return static_cast<int32_t>(a.deadline_ms - b.deadline_ms) < 0;
+    }
+    return static_cast<int32_t>(a.id - b.id) < 0;
+}
+
+uint32_t ProtocolBridge::last_dispatch(const AsyncClient* handle) const {
+    for (const ClientTurn& turn : client_turns_) {
+        if (turn.handle == handle) {
+            return turn.dispatch_seq;
+        }
+    }
+    return 0; // Not served recently: first in line
+}
+
+void ProtocolBridge::note_dispatch(const AsyncClient* handle) {
+    // Reuse the client's slot, otherwise the one dispatched longest ago
+    ClientTurn* slot = &client_turns_[0];
+    for (ClientTurn& turn : client_turns_) {
+        if (turn.handle == handle) {
+            slot = &turn;
+            break;
+        }
+        if (turn.dispatch_seq < slot->dispatch_seq) {
+            slot = &turn;
+        }
+    }
+    slot->handle = handle;
+    slot->dispatch_seq = ++dispatch_seq_;
+}
+
+bool ProtocolBridge::deadline_passed(const BridgeRequest& request, uint32_t now) {
+    return static_cast<int32_t>(request.deadline_ms - now) < (int32_t) BRIDGE_DEADLINE_GUARD_MS;
+}
+
+bool ProtocolBridge::is_same_read(const TcpParseResult& a, const TcpParseResult& b) {
+    return !a.is_write_operation && !b.is_write_operation && a.function_code == b.function_code &&
+           a.start_register == b.start_register && a.register_count == b.register_count &&
+           memcmp(a.inverter_serial, b.inverter_serial, TCP_PROTO_DONGLE_SERIAL_LEN) == 0;
+}
+
+void ProtocolBridge::attach_queued_duplicates() {
+    // Queued entries stay in place (the ring is FIFO); a matching read is
+    // only marked consumed and released once it reaches the front.
+    const size_t queued = request_queue_.size();
+    for (size_t i = 0; i < queued && !current_request_.waiters.full(); i++) {
+        BridgeRequest* request = request_queue_.at(i);
+        if (request->consumed ||
+            !is_same_read(request->wifi_request, current_request_.wifi_request)) {
+            continue;
+        }
+
+        // A queued prefetch or refresh has nobody to answer: the read fills the cache anyway
+        request->consumed = true;
+        if (request->background) {
+            continue;
+        }
+
+        BridgeWaiter waiter;
+        waiter.client_handle = request->client_handle;
+        waiter.id = request->id;
+        waiter.start_register = request->wifi_request.start_register;
+        waiter.register_count = request->wifi_request.register_count;
+        current_request_.waiters.push_back(waiter);
+        coalesced_requests_++;
+
+        LOGI(TAG, "[REQ#%u] Coalesced into in-flight #%u (%u waiter(s))", request->id,
+             current_request_.id, (unsigned) current_request_.waiters.size());
+    }
+
+    release_consumed();
+}
+
+#if BRIDGE_READ_MERGE && BRIDGE_MERGE_WINDOW_MS > 0
+bool ProtocolBridge::merge_window_open() {
+    if (request_queue_.size() != 1) {
+        return false; // Nothing queued, or partners already waiting
+    }
+    const BridgeRequest* front = request_queue_.front();
+    return front && !front->wifi_request.is_write_operation &&
+           millis() - front->timestamp < BRIDGE_MERGE_WINDOW_MS;
+}
+#endif
+
+void ProtocolBridge::merge_queued_reads() {
+    const TcpParseResult& own = current_request_.wifi_request;
+    if (own.is_write_operation) {
+        return;
+    }
+
+    // Every merge widens the bus range, which can make another queued read
+    // adjacent, so scan until a pass adds nothing.
+    bool merged = true;
+    while (merged && !current_request_.waiters.full()) {
+        merged = false;
+        const size_t queued = request_queue_.size();
+        for (size_t i = 0; i < queued && !current_request_.waiters.full(); i++) {
+            BridgeRequest* request = request_queue_.at(i);
+            const TcpParseResult& read = request->wifi_request;
+            if (read.is_write_operation) {
+                break; // Reads queued behind a write must see its effect
+            }
+            if (request->consumed || read.function_code != own.function_code ||
+                memcmp(read.inverter_serial, own.inverter_serial, TCP_PROTO_DONGLE_SERIAL_LEN) !=
+                    0) {
+                continue;
+            }
+
+            // Ranges must touch or overlap, and the union must fit one read
+            const uint32_t bus_end = current_request_.bus_start + current_request_.bus_count;
+            const uint32_t read_end = read.start_register + read.register_count;
+            if (read.start_register > bus_end || read_end < current_request_.bus_start) {
+                continue;
+            }
+            const uint32_t lo = std::min<uint32_t>(current_request_.bus_start, read.start_register);
+            const uint32_t hi = std::max<uint32_t>(bus_end, read_end);
+            if (hi - lo > MODBUS_MAX_REGISTERS) {
+                continue;
+            }
+
+            // An exception for a merged read cannot be pinned on one client:
+            // once the inverter refused this union, the reads go to the bus
+            // separately so each gets (and is remembered with) its own answer
+            {
+                CacheLock lock(cache_mutex_);
+                if (negative_cache_.contains(own.function_code, static_cast<uint16_t>(lo),
+                                             static_cast<uint16_t>(hi - lo), millis())) {
+                    continue;
+                }
+            }
+
+            // Background reads only widen the bus read; there is no client to answer
+            request->consumed = true;
+            current_request_.bus_start = static_cast<uint16_t>(lo);
+            current_request_.bus_count = static_cast<uint16_t>(hi - lo);
+            merged = true;
+            if (request->background) {
+                continue;
+            }
+
+            BridgeWaiter waiter;
+            waiter.client_handle = request->client_handle;
+            waiter.id = request->id;
+            waiter.start_register = read.start_register;
+            waiter.register_count = read.register_count;
+            current_request_.waiters.push_back(waiter);
+            if (read.start_register == own.start_register &&
+                read.register_count == own.register_count) {
+                coalesced_requests_++;
+            } else {
+                merged_requests_++;
+            }
+
+            LOGI(TAG, "[REQ#%u] Merged regs %u-%u into #%u, bus read now %u-%u", request->id,
+                 read.start_register, (unsigned) (read_end - 1), current_request_.id,
+                 (unsigned) lo, (unsigned) (hi - 1));
+        }
+    }
+}
+
+void ProtocolBridge::align_to_banks() {
+    const TcpParseResult& own = current_request_.wifi_request;
+    if (own.is_write_operation) {
+        return;
+    }
+
+    // Clients split the register space differently (0-39 vs 0-31 + 32-63);
+    // reading whole banks gives every split the same bus reads and fills the
+    // shadow in the blocks the next client will ask for
+    const uint32_t start = current_request_.bus_start;
+    const uint32_t end = start + current_request_.bus_count;
+    const uint32_t lo = start / BRIDGE_BANK_SIZE * BRIDGE_BANK_SIZE;
+    const uint32_t hi = (end + BRIDGE_BANK_SIZE - 1) / BRIDGE_BANK_SIZE * BRIDGE_BANK_SIZE;
+    if ((lo == start && hi == end) || hi - lo > MODBUS_MAX_REGISTERS) {
+        return;
+    }
+
+    // Banks the inverter refused as a whole are read as requested
+    {
+        CacheLock lock(cache_mutex_);
+        if (negative_cache_.contains(own.function_code, static_cast<uint16_t>(lo),
+                                     static_cast<uint16_t>(hi - lo), millis())) {
+            return;
+        }
+    }
+
+    if (!current_request_.bank_aligned) {
+        bank_aligned_reads_++;
+    }
+    bank_padding_registers_ += (hi - lo) - (end - start);
+    current_request_.bank_aligned = true;
+    current_request_.bus_start = static_cast<uint16_t>(lo);
+    current_request_.bus_count = static_cast<uint16_t>(hi - lo);
+
+    LOGD(TAG, "[REQ#%u] Bus read aligned to banks: regs %u-%u", current_request_.id,
+         (unsigned) lo, (unsigned) (hi - 1));
+}
+
+bool ProtocolBridge::retry_unaligned(const ParseResult& rs485_result) {
+    if (!current_request_.bank_aligned || rs485_result.error != ParseError::MODBUS_EXCEPTION ||
+        !validate_response_match(rs485_result, current_request_)) {
+        return false;
+    }
+
+    // The padding may be what the inverter refused: remember the banks so
+    // they are not aligned to again, and read only what the clients asked for
+    remember_exception(rs485_result);
+    const TcpParseResult& own = current_request_.wifi_request;
+    uint32_t lo = own.start_register;
+    uint32_t hi = lo + own.register_count;
+    for (const BridgeWaiter& waiter : current_request_.waiters) {
+        lo = std::min<uint32_t>(lo, waiter.start_register);
+        hi = std::max<uint32_t>(hi, waiter.start_register + waiter.register_count);
+    }
+    current_request_.bank_aligned = false;
+    current_request_.bus_start = static_cast<uint16_t>(lo);
+    current_request_.bus_count = static_cast<uint16_t>(hi - lo);
+    bank_refusals_++;
+
+    LOGI(TAG, "[REQ#%u] Bank read refused (0x%02X), re-reading regs %u-%u as requested",
+         current_request_.id, rs485_result.exception_code, (unsigned) lo, (unsigned) (hi - 1));
+    start_current_request();
+    return true;
+}
+
+bool ProtocolBridge::retry_split(const ParseResult& rs485_result) {
+    if (!has_merged_reads() || rs485_result.error != ParseError::MODBUS_EXCEPTION ||
+        !validate_response_match(rs485_result, current_request_)) {
+        return false;
+    }
+
+    // An exception for the union cannot be pinned on one client's range:
+    // remember it so the reads are not merged again, then read each range
+    // on its own so every client gets the inverter's answer for its own
+    const TcpParseResult& own = current_request_.wifi_request;
+    remember_exception(rs485_result);
+    split_reads_.function_code = own.function_code;
+    memcpy(split_reads_.inverter_serial, own.inverter_serial, TCP_PROTO_DONGLE_SERIAL_LEN);
+    split_reads_.waiters.clear();
+    auto& waiters = current_request_.waiters;
+    size_t kept = 0;
+    for (const BridgeWaiter& waiter : waiters) {
+        if (waiter.start_register == own.start_register &&
+            waiter.register_count == own.register_count) {
+            waiters[kept++] = waiter;
+        } else {
+            split_reads_.waiters.push_back(waiter);
+        }
+    }
+    waiters.resize(kept);
+    current_request_.bank_aligned = false;
+    current_request_.bus_start = own.start_register;
+    current_request_.bus_count = own.register_count;
+    merge_refusals_++;
+
+    LOGI(TAG, "[REQ#%u] Merged read refused (0x%02X), re-reading %u client range(s) separately",
+         current_request_.id, rs485_result.exception_code,
+         (unsigned) (split_reads_.waiters.size() + 1));
+    if (is_bare_background()) {
+        finish_current_request(BridgeWorkerState::FAILED); // Only the clients' reads matter
+        return true;
+    }
+    start_current_request();
+    return true;
+}
+
+void ProtocolBridge::start_split_read() {
+    // The first remaining range becomes a request of its own; clients that
+    // asked for the same range are answered by the same read
+    auto& pending = split_reads_.waiters;
+    const BridgeWaiter first = pending[0];
+    current_request_ = BridgeRequest();
+    TcpParseResult& read = current_request_.wifi_request;
+    read.success = true;
+    read.function_code = split_reads_.function_code;
+    read.start_register = first.start_register;
+    read.register_count = first.register_count;
+    memcpy(read.inverter_serial, split_reads_.inverter_serial, TCP_PROTO_DONGLE_SERIAL_LEN);
+    current_request_.client_handle = first.client_handle;
+    current_request_.id = first.id;
+    strncpy(current_request_.client_ip, "split read", sizeof(current_request_.client_ip) - 1);
+    current_request_.timestamp = millis();
+    current_request_.priority = classify(read);
+    current_request_.bus_start = first.start_register;
+    current_request_.bus_count = first.register_count;
+
+    size_t kept = 0;
+    for (size_t i = 1; i < pending.size(); i++) {
+        if (pending[i].start_register == first.start_register &&
+            pending[i].register_count == first.register_count) {
+            current_request_.waiters.push_back(pending[i]);
+        } else {
+            pending[kept++] = pending[i];
+        }
+    }
+    pending.resize(kept);
+
+    has_active_request_ = true;
+    if (!is_current_client_live()) {
+        LOGW(TAG, "[REQ#%u] Split read client disconnected before RS485 send",
+             current_request_.id);
+        client_gone_count_++;
+        failed_requests_++;
+        finish_current_request(BridgeWorkerState::FAILED);
+        return;
+    }
+    start_current_request();
+}
+
+void ProtocolBridge::combine_queued_writes() {
+    const TcpParseResult& own = current_request_.wifi_request;
+    if (own.function_code != static_cast<uint8_t>(ModbusFunctionCode::WRITE_SINGLE)) {
+        return;
+    }
+
+    // Slider drags and automations send bursts of single writes to one
+    // register or its neighbours. Queued writes are taken in order, so the
+    // last value for a register wins, as it would on the bus; the first
+    // write that cannot join ends the scan so writes are never reordered.
+    combined_values_[0] = own.write_values[0];
+    const size_t queued = request_queue_.size();
+    for (size_t i = 0; i < queued && !current_request_.waiters.full(); i++) {
+        BridgeRequest* request = request_queue_.at(i);
+        const TcpParseResult& write = request->wifi_request;
+        if (request->consumed) {
+            continue;
+        }
+        if (!write.is_write_operation) {
+#if BRIDGE_PRIORITY_SCHEDULING
+            continue; // Reads run after every queued write anyway
+#else
+            break; // In FIFO order a read sees only the writes queued before it
+#endif
+        }
+        if (write.function_code != own.function_code ||
+            memcmp(write.inverter_serial, own.inverter_serial, TCP_PROTO_DONGLE_SERIAL_LEN) !=
+                0) {
+            break;
+        }
+
+        const uint32_t reg = write.start_register;
+        const uint32_t bus_start = current_request_.bus_start;
+        const uint32_t bus_end = bus_start + current_request_.bus_count;
+        if (reg + 1 < bus_start || reg > bus_end ||
+            std::max(bus_end, reg + 1) - std::min(bus_start, reg) > BRIDGE_WRITE_COMBINE_MAX) {
+            break;
+        }
+
+        if (reg < bus_start) {
+            memmove(&combined_values_[1], &combined_values_[0],
+                    current_request_.bus_count * sizeof(uint16_t));
+            current_request_.bus_start = static_cast<uint16_t>(reg);
+            current_request_.bus_count++;
+            combined_writes_++;
+        } else if (reg == bus_end) {
+            current_request_.bus_count++;
+            combined_writes_++;
+        } else {
+            superseded_writes_++;
+        }
+        combined_values_[reg - current_request_.bus_start] = write.write_values[0];
+
+        BridgeWaiter waiter;
+        waiter.client_handle = request->client_handle;
+        waiter.id = request->id;
+        waiter.start_register = write.start_register;
+        waiter.register_count = 1;
+        waiter.write_value = write.write_values[0];
+        current_request_.waiters.push_back(waiter);
+        request->consumed = true;
+
+        LOGI(TAG, "[REQ#%u] Write reg %u=0x%04X combined into #%u, bus write now %u-%u",
+             request->id, (unsigned) reg, write.write_values[0], current_request_.id,
+             current_request_.bus_start,
+             (unsigned) (current_request_.bus_start + current_request_.bus_count - 1));
     }
 }
 
-void ProtocolBridge::set_current_state(BridgeWorkerState state) {
-    worker_state_ = state;
+void ProtocolBridge::answer_combined_writes(BridgeWorkerState terminal_state) {
+    const ParseResult& result = rs485_->get_last_result();
+    const bool matches = validate_response_match(result, current_request_);
+    const uint8_t exception_code = matches && result.error == ParseError::MODBUS_EXCEPTION
+                                       ? result.exception_code
+                                       : MODBUS_EXCEPTION_GATEWAY_TARGET_FAILED;
+
+    // Each client is acknowledged with the value it wrote, even if a later
+    // write to the same register was what reached the inverter
+    std::vector<uint8_t>& reply = response_buffer_;
+    for (const BridgeWaiter& waiter : current_request_.waiters) {
+        const bool built =
+            terminal_state == BridgeWorkerState::DONE
+                ? build_write_ack(reply, waiter.start_register, waiter.write_value)
+                : build_exception_response(reply, current_request_.wifi_request,
+                                           waiter.start_register, exception_code);
+        if (built) {
+            post_client_response(reply, waiter.client_handle);
+        }
+    }
 }
 
-bool ProtocolBridge::enqueue_request(BridgeRequest&& request) {
-    if (queue_full()) {
+bool ProtocolBridge::build_write_ack(std::vector<uint8_t>& wifi_response, uint16_t reg,
+                                     uint16_t value) {
+    if (!InverterProtocol::create_write_single_response(
+            frame_buffer_, current_request_.wifi_request.inverter_serial, reg, value)) {
         return false;
     }
-
-    request_queue_[request_queue_tail_] = std::move(request);
-    request_queue_tail_ = (request_queue_tail_ + 1) % REQUEST_QUEUE_MAX_DEPTH;
-    request_queue_count_++;
-    return true;
+    uint8_t dongle_serial[10];
+    TcpProtocol::copy_serial(dongle_serial_, dongle_serial);
+    return TcpProtocol::build_response(wifi_response, frame_buffer_.data(), frame_buffer_.size(),
+                                       dongle_serial);
 }
 
-bool ProtocolBridge::dequeue_request(BridgeRequest& request) {
-    if (queue_empty()) {
-        return false;
+bool ProtocolBridge::has_merged_reads() const {
+    const TcpParseResult& own = current_request_.wifi_request;
+    if (own.is_write_operation) {
+        return false; // Combined writes have their own waiters, answered per register
+    }
+    for (const BridgeWaiter& waiter : current_request_.waiters) {
+        if (waiter.start_register != own.start_register ||
+            waiter.register_count != own.register_count) {
+            return true;
+        }
     }
+    return false;
+}
 
-    request = std::move(request_queue_[request_queue_head_]);
-    request_queue_[request_queue_head_] = BridgeRequest();
-    request_queue_head_ = (request_queue_head_ + 1) % REQUEST_QUEUE_MAX_DEPTH;
-    request_queue_count_--;
-    return true;
+void ProtocolBridge::answer_merged_reads(BridgeWorkerState terminal_state) {
+    const ParseResult& result = rs485_->get_last_result();
+    const bool matches = validate_response_match(result, current_request_);
+    const bool have_values = terminal_state == BridgeWorkerState::DONE && result.success && matches;
+    const uint8_t exception_code = matches && result.error == ParseError::MODBUS_EXCEPTION
+                                       ? result.exception_code
+                                       : MODBUS_EXCEPTION_GATEWAY_TARGET_FAILED;
+
+    const TcpParseResult& own = current_request_.wifi_request;
+    const auto& waiters = current_request_.waiters;
+    for (size_t i = 0; i < waiters.size(); i++) {
+        const uint16_t start = waiters[i].start_register;
+        const uint16_t count = waiters[i].register_count;
+        if (start == own.start_register && count == own.register_count) {
+            continue; // Answered together with the request itself
+        }
+
+        // One reply per distinct range, addressed to every client that asked for it
+        bool answered = false;
+        for (size_t j = 0; j < i && !answered; j++) {
+            answered = waiters[j].start_register == start && waiters[j].register_count == count;
+        }
+        if (answered) {
+            continue;
+        }
+
+        std::vector<uint8_t>& reply = response_buffer_;
+        const bool built = have_values
+                               ? build_range_response(result, start, count, reply)
+                               : get_fallback_response(own.function_code, start, count, reply);
+        if (built) {
+            post_range_response(reply, start, count);
+        } else {
+            post_exception_response(start, count, exception_code);
+        }
+
+        LOGI(TAG, "[REQ#%u] Merged regs %u-%u answered from %s", waiters[i].id, start,
+             (unsigned) (start + count - 1),
+             have_values ? "bus read" : (built ? "fallback cache" : "exception"));
+    }
 }
 
 void ProtocolBridge::drop_queued_requests(const char* reason) {
@@ -273,15 +1520,12 @@ void ProtocolBridge::drop_queued_requests(const char* reason) {
         queue_drops_++;
         failed_requests_++;
 
-        TCPClient* client = tcp_server_ && dropped.client_handle
-                                ? tcp_server_->resolve_client(dropped.client_handle)
-                                : nullptr;
-        if (client && client->client) {
-            tcp_server_->request_client_close(client->client, reason);
+        if (is_client_live(dropped.client_handle)) {
+            post_close(dropped, reason);
         }
 
         LOGW(TAG, "[REQ#%u] Dropped queued request from %s: %s", dropped.id,
-             dropped.client_ip.c_str(), reason ? reason : "unknown");
+             dropped.client_ip, reason ? reason : "unknown");
     }
 
     if (!has_active_request_ && queue_empty()) {
@@ -290,23 +1534,84 @@ void ProtocolBridge::drop_queued_requests(const char* reason) {
 }
 
 void ProtocolBridge::start_next_request() {
-    if (has_active_request_ || queue_empty()) {
+    if (has_active_request_) {
+        return;
+    }
+
+#if BRIDGE_READ_MERGE
+    // Ranges of a refused merged read were dequeued before anything still queued
+    while (!split_reads_.waiters.empty() && !has_active_request_) {
+        start_split_read();
+    }
+    if (has_active_request_) {
+        return;
+    }
+#endif
+
+    if (queue_empty()) {
+        return;
+    }
+
+#if BRIDGE_READ_MERGE && BRIDGE_MERGE_WINDOW_MS > 0
+    // Give a lone read a moment for neighbouring reads to arrive
+    if (merge_window_open()) {
         return;
     }
+#endif
 
     while (dequeue_request(current_request_)) {
         has_active_request_ = true;
         set_current_state(BridgeWorkerState::RS485_SEND);
 
-        if (!resolve_current_client()) {
+        if (!current_request_.background && !is_current_client_live()) {
             LOGW(TAG, "[REQ#%u] Queued client %s disconnected before RS485 send",
-                 current_request_.id, current_request_.client_ip.c_str());
+                 current_request_.id, current_request_.client_ip);
             client_gone_count_++;
             failed_requests_++;
             finish_current_request(BridgeWorkerState::FAILED);
             continue;
         }
 
+#if BRIDGE_PRIORITY_SCHEDULING
+        // The client has given up by now; its retry, if any, is queued behind
+        const uint32_t now = millis();
+        if (deadline_passed(current_request_, now)) {
+            LOGW(TAG, "[REQ#%u] Deadline reached after %lums queued, dropped before RS485 send",
+                 current_request_.id, (unsigned long) (now - current_request_.timestamp));
+            deadline_drops_++;
+            failed_requests_++;
+            // Told to back off rather than left to sit out its own timeout
+            if (!current_request_.background) {
+                const TcpParseResult& request = current_request_.wifi_request;
+                post_exception_response(request.start_register, request.register_count,
+                                        MODBUS_EXCEPTION_SERVER_BUSY);
+            }
+            finish_current_request(BridgeWorkerState::FAILED);
+            continue;
+        }
+#endif
+
+#if BRIDGE_CIRCUIT_BREAKER
+        // Queued before the breaker opened: answer now rather than after a timeout
+        if (breaker_state_.load() == BreakerState::OPEN) {
+            fail_fast_current_request();
+            continue;
+        }
+#endif
+
+#if BRIDGE_WRITE_COMBINE
+        combine_queued_writes();
+#endif
+#if BRIDGE_BANK_ALIGN
+        // Aligned first, so queued reads anywhere in the same banks merge too
+        align_to_banks();
+#endif
+#if BRIDGE_READ_MERGE
+        merge_queued_reads();
+#endif
+#if BRIDGE_BANK_ALIGN
+        align_to_banks();
+#endif
         start_current_request();
         return;
     }
@@ -355,13 +1660,30 @@ void ProtocolBridge::finish_current_request(BridgeWorkerState terminal_state) {
 
     const uint32_t elapsed = millis() - current_request_.timestamp;
     LOGD(TAG, "[REQ#%u] Worker finished state=%s elapsed=%lums queue=%u/%u", current_request_.id,
-         worker_state_name(terminal_state), elapsed, (unsigned) request_queue_count_,
-         (unsigned) REQUEST_QUEUE_MAX_DEPTH);
+         worker_state_name(terminal_state), elapsed, (unsigned) request_queue_.size(),
+         (unsigned) queue_limit_.load());
 
     last_finished_request_id_ = current_request_.id;
     last_finished_elapsed_ms_ = elapsed;
     last_terminal_state_ = terminal_state;
 
+#if BRIDGE_READ_MERGE
+    if (has_merged_reads()) {
+        answer_merged_reads(terminal_state);
+    }
+#endif
+#if BRIDGE_WRITE_COMBINE
+    if (is_combined_write()) {
+        answer_combined_writes(terminal_state);
+    }
+#endif
+
+    // A write without an acknowledgement may or may not have been applied
+    const TcpParseResult& request = current_request_.wifi_request;
+    if (request.is_write_operation && terminal_state != BridgeWorkerState::DONE) {
+        invalidate_cached_range(0x03, current_request_.bus_start, current_request_.bus_count);
+    }
+
     waiting_rs485_response_ = false;
     pending_rs485_send_retry_ = false;
     current_request_ = BridgeRequest();
@@ -373,20 +1695,33 @@ bool ProtocolBridge::send_current_request_to_rs485() {
     const TcpParseResult& request = current_request_.wifi_request;
 
     if (request.is_write_operation) {
-        return rs485_->send_write_request(request.start_register, request.write_values);
+        if (is_combined_write()) {
+            return rs485_->send_write_request(current_request_.bus_start, combined_values_,
+                                              current_request_.bus_count);
+        }
+        return rs485_->send_write_request(request.start_register, request.write_values.data(),
+                                          request.write_values.size());
     }
 
     ModbusFunctionCode func = static_cast<ModbusFunctionCode>(request.function_code);
-    return rs485_->send_read_request(func, request.start_register, request.register_count);
+    return rs485_->send_read_request(func, current_request_.bus_start, current_request_.bus_count);
 }
 
 void ProtocolBridge::defer_current_request_retry(const char* reason) {
+    if (is_bare_background()) {
+        // Background reads are only worth it on an idle bus; clients read anyway
+        LOGD(TAG, "[REQ#%u] Background %s dropped: %s", current_request_.id,
+             current_request_.client_ip, reason);
+        failed_requests_++;
+        finish_current_request(BridgeWorkerState::FAILED);
+        return;
+    }
+
     pending_rs485_send_retry_ = true;
     waiting_rs485_response_ = false;
     last_send_attempt_time_ = millis();
     current_request_.retry_count = 0;
-    current_retry_delay_ms_ =
-        RS485_SEND_RETRY_DELAY_MS + (esp_random() % (RS485_SEND_RETRY_JITTER_MS + 1));
+    current_retry_delay_ms_ = next_retry_delay_ms();
     set_current_state(BridgeWorkerState::RS485_RETRY);
 
     LOGD(TAG, "%s; keeping TCP client open and retrying for %lums", reason,
@@ -409,16 +1744,22 @@ void ProtocolBridge::finish_deferred_send_failure(const char* reason) {
 }
 
 void ProtocolBridge::process_pending_rs485_send() {
-    TCPClient* client = resolve_current_client();
-    if (!client) {
+    if (!is_current_client_live()) {
         LOGW(TAG, "Deferred RS485 send abandoned: client %s disconnected",
-             current_request_.client_ip.c_str());
+             current_request_.client_ip);
         client_gone_count_++;
         failed_requests_++;
         finish_current_request(BridgeWorkerState::FAILED);
         return;
     }
 
+#if BRIDGE_CIRCUIT_BREAKER
+    if (breaker_state_.load() == BreakerState::OPEN) {
+        fail_fast_current_request();
+        return;
+    }
+#endif
+
     const uint32_t now = millis();
     const uint32_t age_ms = now - current_request_.timestamp;
 
@@ -442,12 +1783,11 @@ void ProtocolBridge::process_pending_rs485_send() {
 
     current_request_.retry_count++;
     last_send_attempt_time_ = now;
-    current_retry_delay_ms_ =
-        RS485_SEND_RETRY_DELAY_MS + (esp_random() % (RS485_SEND_RETRY_JITTER_MS + 1));
+    current_retry_delay_ms_ = next_retry_delay_ms();
 
     if (!send_current_request_to_rs485()) {
         LOGD(TAG, "RS485 send retry %u still busy/failed for %s", current_request_.retry_count,
-             current_request_.client_ip.c_str());
+             current_request_.client_ip);
         return;
     }
 
@@ -460,26 +1800,38 @@ void ProtocolBridge::process_pending_rs485_send() {
          current_request_.retry_count, age_ms);
 }
 
+uint32_t ProtocolBridge::next_retry_delay_ms() {
+    // Arduino random() is backed by the hardware RNG on ESP32
+    return RS485_SEND_RETRY_DELAY_MS + random(RS485_SEND_RETRY_JITTER_MS + 1);
+}
+
 bool ProtocolBridge::validate_response_match(const ParseResult& result,
-                                             const TcpParseResult& request) {
-    // Check function code
-    if (static_cast<uint8_t>(result.function_code) != request.function_code) {
+                                             const BridgeRequest& bridge_request) {
+    const TcpParseResult& request = bridge_request.wifi_request;
+
+    // Check function code (combined single writes go out as one 0x10 write)
+    const bool combined = request.is_write_operation && !bridge_request.waiters.empty();
+    const uint8_t function_code = combined && bridge_request.bus_count > 1
+                                      ? static_cast<uint8_t>(ModbusFunctionCode::WRITE_MULTI)
+                                      : request.function_code;
+    if (static_cast<uint8_t>(result.function_code) != function_code) {
         return false;
     }
 
-    // Check start address
-    if (result.start_address != request.start_register) {
+    // Check start address (of the bus read, which merged reads may widen)
+    if (result.start_address != bridge_request.bus_start) {
         return false;
     }
 
     // Check register count only if it's a successful response (exceptions don't have count)
     if (result.success) {
         if (request.is_write_operation) {
-            if (result.register_count != request.write_values.size()) {
+            if (result.register_count !=
+                (combined ? bridge_request.bus_count : request.write_values.size())) {
                 return false;
             }
         } else {
-            if (result.register_count != request.register_count) {
+            if (result.register_count != bridge_request.bus_count) {
                 return false;
             }
         }
@@ -494,9 +1846,21 @@ void ProtocolBridge::process_rs485_response() {
         const ParseResult& rs485_result = rs485_->get_last_result();
         unsigned long elapsed = millis() - last_request_time_;
         BridgeWorkerState terminal_state = BridgeWorkerState::FAILED;
+#if BRIDGE_CIRCUIT_BREAKER
+        // Any frame back, even an exception, shows the inverter is there
+        note_bus_result(rs485_result.error != ParseError::TIMEOUT);
+#endif
 
         if (rs485_result.success) {
             terminal_state = handle_rs485_success(rs485_result, elapsed);
+#if BRIDGE_BANK_ALIGN
+        } else if (retry_unaligned(rs485_result)) {
+            return;
+#endif
+#if BRIDGE_READ_MERGE
+        } else if (retry_split(rs485_result)) {
+            return;
+#endif
         } else {
             terminal_state = handle_rs485_error(rs485_result, elapsed);
         }
@@ -509,12 +1873,20 @@ void ProtocolBridge::process_rs485_response() {
 bool ProtocolBridge::send_wifi_response(const ParseResult& rs485_result) {
     set_current_state(BridgeWorkerState::RESPOND_TCP);
 
-    // Resolve the client fresh at the point of use. The TCPClient entry may
-    // have been removed or moved in the vector since process_wifi_request ran.
-    TCPClient* client = resolve_current_client();
-    if (!client) {
+    // ========== CACHE FOR FALLBACK ==========
+    // Shadow the registers of a successful read for cache-first and fallback use
+    cache_read_result(rs485_result);
+    // ========== END CACHE FOR FALLBACK ==========
+
+    if (is_bare_background()) {
+        LOGD(TAG, "[REQ#%u] Background %s stored in cache", current_request_.id,
+             current_request_.client_ip);
+        return true;
+    }
+
+    if (!is_current_client_live()) {
         LOGW(TAG, "⚠ Client %s no longer connected, dropping response",
-             current_request_.client_ip.c_str());
+             current_request_.client_ip);
         client_gone_count_++;
         return false;
     }
@@ -527,13 +1899,25 @@ bool ProtocolBridge::send_wifi_response(const ParseResult& rs485_result) {
         return false;
     }
 
-    LOGD(TAG, "[REQ#%u] Wrapping raw RS485 response in TCP (A1 1A)...", current_request_.id);
-    std::vector<uint8_t> wifi_response;
-    uint8_t dongle_serial[10];
-    TcpProtocol::copy_serial(dongle_serial_, dongle_serial);
-
-    bool built = TcpProtocol::build_response(wifi_response, raw_response.data(),
-                                             raw_response.size(), dongle_serial);
+    std::vector<uint8_t>& wifi_response = response_buffer_;
+    const TcpParseResult& request = current_request_.wifi_request;
+    bool built = false;
+
+    if (is_combined_write()) {
+        // The echo may carry another client's value, or be a 0x10 ack
+        built = build_write_ack(wifi_response, request.start_register, request.write_values[0]);
+    } else if (current_request_.bus_start == request.start_register &&
+               current_request_.bus_count == request.register_count) {
+        LOGD(TAG, "[REQ#%u] Wrapping raw RS485 response in TCP (A1 1A)...", current_request_.id);
+        uint8_t dongle_serial[10];
+        TcpProtocol::copy_serial(dongle_serial_, dongle_serial);
+        built = TcpProtocol::build_response(wifi_response, raw_response.data(),
+                                            raw_response.size(), dongle_serial);
+    } else {
+        // Merged bus read: cut this client's own range out of the response
+        built = build_range_response(rs485_result, request.start_register,
+                                     request.register_count, wifi_response);
+    }
 
     if (!built) {
         LOGE(TAG, "✗ Failed to build WiFi response");
@@ -541,71 +1925,70 @@ bool ProtocolBridge::send_wifi_response(const ParseResult& rs485_result) {
         return false;
     }
 
-    // ========== CACHE FOR FALLBACK ==========
-    // Store successful response in cache for potential fallback use
-    cache_read_response(current_request_.wifi_request, wifi_response);
-    // ========== END CACHE FOR FALLBACK ==========
-
     LOGI(TAG, "WiFi response built: %d bytes", wifi_response.size());
     LOGD(TAG, "  WiFi packet (first 60 bytes): %s",
          TcpProtocol::format_hex(wifi_response.data(), min(wifi_response.size(), (size_t) 60))
              .c_str());
 
-    // Send to TCP client — re-resolve in case something changed during the
-    // response build (unlikely but cheap to check).
-    client = resolve_current_client();
-    if (!client || !client->client) {
-        LOGW(TAG, "⚠ Client %s disconnected during response build",
-             current_request_.client_ip.c_str());
-        client_gone_count_++;
-        return false;
-    }
+    // Hand off to the network side, which re-resolves the client and writes
+    LOGI(TAG, "→ Sending to TCP client %s (+%u coalesced)...", current_request_.client_ip,
+         (unsigned) current_request_.waiters.size());
+    return post_response(wifi_response);
+}
 
-    LOGI(TAG, "→ Sending to TCP client %s...", client->remote_ip.c_str());
-    size_t written = client->client->write(reinterpret_cast<const char*>(wifi_response.data()),
-                                           wifi_response.size());
-    if (written == wifi_response.size()) {
-        client->last_activity = millis();
-        LOGI(TAG, "✓ Response sent successfully (%d bytes)", written);
-        return true;
+bool ProtocolBridge::build_range_response(const ParseResult& result, uint16_t start,
+                                          uint16_t count, std::vector<uint8_t>& out) {
+    const size_t offset = start - result.start_address;
+    if (start < result.start_address || offset + count > result.register_values.size()) {
+        return false;
     }
 
-    LOGW(TAG, "⚠ Partial write: %d/%d bytes", written, wifi_response.size());
-    return false;
+    uint8_t dongle_serial[10];
+    TcpProtocol::copy_serial(dongle_serial_, dongle_serial);
+    return InverterProtocol::create_read_response(frame_buffer_, result.function_code,
+                                                  result.serial_number, start,
+                                                  &result.register_values[offset], count) &&
+           TcpProtocol::build_response(out, frame_buffer_.data(), frame_buffer_.size(),
+                                       dongle_serial);
 }
 
-void ProtocolBridge::send_error_response(const String& error) {
-    TCPClient* client = resolve_current_client();
-    if (!client) {
-        LOGD(TAG, "Client gone, dropping error: %s", error.c_str());
+void ProtocolBridge::send_error_response(const char* error) {
+    if (!is_current_client_live()) {
+        LOGD(TAG, "Client gone, dropping error: %s", error);
         return;
     }
 
-    LOGW(TAG, "Sending error response to client: %s", error.c_str());
+    LOGW(TAG, "Sending error response to client: %s", error);
 
     // Get the last RS485 raw response if available
     const std::vector<uint8_t>& raw_response = rs485_->get_last_raw_response();
     const ParseResult& last_result = rs485_->get_last_result();
 
-    if (!raw_response.empty() &&
-        validate_response_match(last_result, current_request_.wifi_request)) {
+    const TcpParseResult& request = current_request_.wifi_request;
+    const bool matches =
+        !raw_response.empty() && validate_response_match(last_result, current_request_);
+    const bool own_range = current_request_.bus_start == request.start_register &&
+                           current_request_.bus_count == request.register_count;
+
+    if (matches && own_range) {
         // We have the raw exception response from inverter - forward it to client
-        std::vector<uint8_t> wifi_response;
+        std::vector<uint8_t>& wifi_response = response_buffer_;
         uint8_t dongle_serial[10];
         TcpProtocol::copy_serial(dongle_serial_, dongle_serial);
 
         bool built = TcpProtocol::build_response(wifi_response, raw_response.data(),
                                                  raw_response.size(), dongle_serial);
 
-        // Re-resolve after build (cheap; handles race with cleanup).
-        client = resolve_current_client();
-        if (built && client && client->client) {
-            size_t written = client->client->write(
-                reinterpret_cast<const char*>(wifi_response.data()), wifi_response.size());
-            if (written == wifi_response.size()) {
-                client->last_activity = millis();
-            }
-            LOGI(TAG, "✓ Exception response forwarded to client (%d bytes)", written);
+        if (built && post_response(wifi_response)) {
+            LOGI(TAG, "✓ Exception response forwarded to client (%u bytes)",
+                 (unsigned) wifi_response.size());
+            return;
+        }
+    } else if (matches && last_result.error == ParseError::MODBUS_EXCEPTION) {
+        // Merged bus read: re-address the inverter's exception to this client's range
+        if (post_exception_response(request.start_register, request.register_count,
+                                    last_result.exception_code)) {
+            LOGI(TAG, "✓ Exception 0x%02X forwarded to client", last_result.exception_code);
             return;
         }
     } else if (!raw_response.empty()) {
@@ -618,65 +2001,62 @@ void ProtocolBridge::send_error_response(const String& error) {
 
     // Last resort: close connection if we can't build a protocol-compatible response.
     LOGW(TAG, "⚠ Cannot build gateway exception response, closing connection");
-    client = resolve_current_client();
-    if (client && client->client) {
-        tcp_server_->request_client_close(client->client, "cannot build gateway exception");
-    }
+    post_close(current_request_, "cannot build gateway exception");
 }
 
-bool ProtocolBridge::send_gateway_target_failed_response(const String& reason) {
-    TCPClient* client = resolve_current_client();
-    if (!client || !client->client) {
+bool ProtocolBridge::send_gateway_target_failed_response(const char* reason) {
+    if (!is_current_client_live()) {
         return false;
     }
 
     const TcpParseResult& request = current_request_.wifi_request;
-    std::vector<uint8_t> exception_response(MODBUS_MIN_EXCEPTION_SIZE, 0);
+    set_current_state(BridgeWorkerState::RESPOND_TCP);
+    if (!post_exception_response(request.start_register, request.register_count,
+                                 MODBUS_EXCEPTION_GATEWAY_TARGET_FAILED)) {
+        LOGW(TAG, "Failed to send synthetic gateway exception for: %s", reason);
+        return false;
+    }
+
+    LOGW(TAG,
+         "Sent synthetic Modbus exception 0x%02X "
+         "(Gateway Target Device Failed to Respond) for func=0x%02X start=%u: %s",
+         MODBUS_EXCEPTION_GATEWAY_TARGET_FAILED, request.function_code, request.start_register,
+         reason);
+    return true;
+}
+
+bool ProtocolBridge::post_exception_response(uint16_t start, uint16_t count,
+                                             uint8_t exception_code) {
+    std::vector<uint8_t>& wifi_response = response_buffer_;
+    if (!build_exception_response(wifi_response, current_request_.wifi_request, start,
+                                  exception_code)) {
+        return false;
+    }
+    return post_range_response(wifi_response, start, count);
+}
+
+bool ProtocolBridge::build_exception_response(std::vector<uint8_t>& wifi_response,
+                                              const TcpParseResult& request, uint16_t start,
+                                              uint8_t exception_code) const {
+    std::array<uint8_t, MODBUS_MIN_EXCEPTION_SIZE> exception_response{};
 
     exception_response[InverterProtocolOffsets::ADDR] = MODBUS_DEVICE_ADDR_RESPONSE;
     exception_response[InverterProtocolOffsets::FUNC] = request.function_code | 0x80;
     memcpy(&exception_response[InverterProtocolOffsets::SERIAL_NUM], request.inverter_serial,
            MODBUS_SERIAL_NUMBER_LENGTH);
-    InverterProtocol::write_little_endian_uint16(
-        exception_response.data(), InverterProtocolOffsets::START_REG, request.start_register);
-    exception_response[InverterProtocolOffsets::EXCEPTION_CODE] =
-        MODBUS_EXCEPTION_GATEWAY_TARGET_FAILED;
+    InverterProtocol::write_little_endian_uint16(exception_response.data(),
+                                                 InverterProtocolOffsets::START_REG, start);
+    exception_response[InverterProtocolOffsets::EXCEPTION_CODE] = exception_code;
 
     const size_t crc_offset = MODBUS_MIN_EXCEPTION_SIZE - 2;
     const uint16_t crc = InverterProtocol::calculate_crc16(exception_response.data(), crc_offset);
     InverterProtocol::write_little_endian_uint16(exception_response.data(), crc_offset, crc);
 
-    std::vector<uint8_t> wifi_response;
     uint8_t dongle_serial[10];
     TcpProtocol::copy_serial(dongle_serial_, dongle_serial);
 
-    if (!TcpProtocol::build_response(wifi_response, exception_response.data(),
-                                     exception_response.size(), dongle_serial)) {
-        LOGW(TAG, "Failed to build synthetic gateway exception for: %s", reason.c_str());
-        return false;
-    }
-
-    set_current_state(BridgeWorkerState::RESPOND_TCP);
-    client = resolve_current_client();
-    if (!client || !client->client) {
-        LOGD(TAG, "Client gone before gateway exception could be sent");
-        return false;
-    }
-
-    size_t written = client->client->write(reinterpret_cast<const char*>(wifi_response.data()),
-                                           wifi_response.size());
-    if (written != wifi_response.size()) {
-        LOGW(TAG, "⚠ Partial gateway exception write: %d/%d bytes", written, wifi_response.size());
-        return false;
-    }
-
-    client->last_activity = millis();
-    LOGW(TAG,
-         "Sent synthetic Modbus exception 0x%02X "
-         "(Gateway Target Device Failed to Respond) for func=0x%02X start=%u: %s",
-         MODBUS_EXCEPTION_GATEWAY_TARGET_FAILED, request.function_code, request.start_register,
-         reason.c_str());
-    return true;
+    return TcpProtocol::build_response(wifi_response, exception_response.data(),
+                                       exception_response.size(), dongle_serial);
 }
 
 // ============================================================================
@@ -686,15 +2066,15 @@ bool ProtocolBridge::send_gateway_target_failed_response(const String& reason) {
 BridgeWorkerState ProtocolBridge::handle_rs485_success(const ParseResult& rs485_result,
                                                        unsigned long elapsed) {
     // Validate response matches request to avoid processing snooped packets
-    if (!validate_response_match(rs485_result, current_request_.wifi_request)) {
+    if (!validate_response_match(rs485_result, current_request_)) {
         const uint16_t expected_count = current_request_.wifi_request.is_write_operation
                                             ? current_request_.wifi_request.write_values.size()
-                                            : current_request_.wifi_request.register_count;
+                                            : current_request_.bus_count;
         LOGW(TAG,
              "⚠ Response mismatch! Expected func=0x%02X start=%d count=%d, Got func=0x%02X "
              "start=%d count=%d",
-             current_request_.wifi_request.function_code,
-             current_request_.wifi_request.start_register, expected_count,
+             current_request_.wifi_request.function_code, current_request_.bus_start,
+             expected_count,
              static_cast<uint8_t>(rs485_result.function_code), rs485_result.start_address,
              rs485_result.register_count);
 
@@ -720,11 +2100,15 @@ BridgeWorkerState ProtocolBridge::handle_rs485_success(const ParseResult& rs485_
          static_cast<uint8_t>(rs485_result.function_code), rs485_result.register_count,
          rs485_result.start_address, elapsed, value_summary);
 
+    if (current_request_.wifi_request.is_write_operation) {
+        cache_write_result(rs485_result);
+    }
+
     if (send_wifi_response(rs485_result)) {
-        successful_requests_++;
-        LOGI(TAG, "[REQ#%u] ✓ Completed (success: %d/%d = %.1f%%)", current_request_.id,
-             successful_requests_, total_requests_,
-             (100.0f * successful_requests_) / total_requests_);
+        const uint32_t succeeded = ++successful_requests_;
+        const uint32_t total = total_requests_;
+        LOGI(TAG, "[REQ#%u] ✓ Completed (success: %u/%u = %.1f%%)", current_request_.id,
+             succeeded, total, (100.0f * succeeded) / total);
         return BridgeWorkerState::DONE;
     }
 
@@ -734,27 +2118,32 @@ BridgeWorkerState ProtocolBridge::handle_rs485_success(const ParseResult& rs485_
 
 BridgeWorkerState ProtocolBridge::handle_rs485_error(const ParseResult& rs485_result,
                                                      unsigned long elapsed) {
-    // ========== TRY FALLBACK CACHE FIRST ==========
-    // This is critical for handling collisions/mismatches
-    // Even if response is mismatch, cache might have valid data
-    if (try_fallback_cache_on_error(rs485_result)) {
-        LOGI(TAG, "RS485 error, using FALLBACK CACHE despite any mismatch");
-        failed_requests_++;
-        return BridgeWorkerState::CACHE_FALLBACK;
-    }
-    // ========== END FALLBACK ATTEMPT ==========
+    const bool exception = rs485_result.error == ParseError::MODBUS_EXCEPTION;
+
+    if (exception && validate_response_match(rs485_result, current_request_)) {
+        // The inverter's own answer for this range: remember and forward it.
+        // Serving cached registers here would hide a genuine refusal.
+        remember_exception(rs485_result);
+    } else {
+        // ========== TRY FALLBACK CACHE ==========
+        // Timeouts, CRC errors and mismatched frames (typically a collision)
+        // say nothing about the registers, so cached data is the better answer
+        if (try_fallback_cache_on_error(rs485_result)) {
+            LOGI(TAG, "RS485 error, using FALLBACK CACHE despite any mismatch");
+            failed_requests_++;
+            return BridgeWorkerState::CACHE_FALLBACK;
+        }
+        // ========== END FALLBACK ATTEMPT ==========
 
-    // If cache miss, validate exception response
-    if (rs485_result.error_message.startsWith("Modbus Exception")) {
-        if (!validate_response_match(rs485_result, current_request_.wifi_request)) {
+        if (exception) {
             const uint16_t expected_count = current_request_.wifi_request.is_write_operation
                                                 ? current_request_.wifi_request.write_values.size()
-                                                : current_request_.wifi_request.register_count;
+                                                : current_request_.bus_count;
             LOGW(TAG,
                  "Exception response mismatch AND no fallback cache! Expected func=0x%02X "
                  "start=%d count=%d, Got func=0x%02X start=%d count=%d",
-                 current_request_.wifi_request.function_code,
-                 current_request_.wifi_request.start_register, expected_count,
+                 current_request_.wifi_request.function_code, current_request_.bus_start,
+                 expected_count,
                  static_cast<uint8_t>(rs485_result.function_code), rs485_result.start_address,
                  rs485_result.register_count);
 
@@ -765,10 +2154,18 @@ BridgeWorkerState ProtocolBridge::handle_rs485_error(const ParseResult& rs485_re
     }
 
     // Log the error
-    LOGE(TAG, "✗ RS485 FAIL: %s (after %lums)", rs485_result.error_message.c_str(), elapsed);
+    const char* error = InverterProtocol::error_to_string(rs485_result.error);
+    if (rs485_result.error == ParseError::MODBUS_EXCEPTION) {
+        LOGE(TAG, "✗ RS485 FAIL: %s 0x%02X: %s (register %u) (after %lums)", error,
+             rs485_result.exception_code,
+             InverterProtocol::exception_to_string(rs485_result.exception_code),
+             rs485_result.start_address, elapsed);
+    } else {
+        LOGE(TAG, "✗ RS485 FAIL: %s (after %lums)", error, elapsed);
+    }
 
     // No fallback available - send error
-    send_error_response(rs485_result.error_message);
+    send_error_response(error);
 
     const std::vector<uint8_t>& raw = rs485_->get_last_raw_response();
     if (!raw.empty()) {
@@ -777,8 +2174,10 @@ BridgeWorkerState ProtocolBridge::handle_rs485_error(const ParseResult& rs485_re
     }
 
     failed_requests_++;
-    LOGE(TAG, "[REQ#%u] ✗ Failed (failures: %d/%d = %.1f%%)", current_request_.id, failed_requests_,
-         total_requests_, (100.0f * failed_requests_) / total_requests_);
+    const uint32_t failed = failed_requests_;
+    const uint32_t total = total_requests_;
+    LOGE(TAG, "[REQ#%u] ✗ Failed (failures: %u/%u = %.1f%%)", current_request_.id, failed, total,
+         (100.0f * failed) / total);
     return BridgeWorkerState::FAILED;
 }
 
@@ -814,210 +2213,316 @@ bool ProtocolBridge::try_fallback_cache_on_error(const ParseResult& rs485_result
 }
 
 // ============================================================================
-// Fallback Cache Implementation
+// Fallback Cache Implementation (register shadow)
 // ============================================================================
 
-void ProtocolBridge::cache_read_response(const TcpParseResult& request,
-                                         const std::vector<uint8_t>& tcp_response) {
-    // Only cache READ operations (not WRITE)
-    if (request.is_write_operation) {
+void ProtocolBridge::cache_read_result(const ParseResult& rs485_result) {
+    // Only READ responses carry register values worth shadowing
+    if (current_request_.wifi_request.is_write_operation) {
         return;
     }
 
-    ReadCacheKey cache_key{request.function_code, request.start_register, request.register_count};
+    CacheLock lock(cache_mutex_);
+    register_shadow_.store(rs485_result, millis());
+    // The range reads fine now (e.g. after an inverter firmware update)
+    negative_cache_.forget(static_cast<uint8_t>(rs485_result.function_code),
+                           rs485_result.start_address, rs485_result.register_count);
+}
+
+void ProtocolBridge::cache_write_result(const ParseResult& rs485_result) {
+    const TcpParseResult& write = current_request_.wifi_request;
+
+    // The inverter acknowledged the write, so the written values are now the
+    // register contents: 0x06 echoes the stored value, 0x10 confirms the count.
+    const bool combined = is_combined_write();
+    const uint16_t start = combined ? current_request_.bus_start : write.start_register;
+    const size_t count = combined ? current_request_.bus_count : write.write_values.size();
+    const uint16_t* values = combined ? combined_values_ : write.write_values.data();
+    if (rs485_result.function_code == ModbusFunctionCode::WRITE_SINGLE &&
+        !rs485_result.register_values.empty()) {
+        values = rs485_result.register_values.data();
+    }
+
+    CacheLock lock(cache_mutex_);
+    const size_t updated = register_shadow_.store(ModbusFunctionCode::READ_HOLDING, start, values,
+                                                  count, rs485_result.serial_number, millis());
+    cache_write_updates_ += updated;
+    LOGD(TAG, "Write-through: %u holding register(s) from %u updated", (unsigned) updated,
+         start);
+}
 
-    cache_response_for_fallback(cache_key, tcp_response);
+size_t ProtocolBridge::get_cache_size() const {
+    CacheLock lock(cache_mutex_);
+    return register_shadow_.valid_count();
 }
 
-void ProtocolBridge::cache_response_for_fallback(const ReadCacheKey& key,
-                                                 const std::vector<uint8_t>& tcp_response) {
-    // First, check if this key already exists and remove it (to replace with fresh response)
-    auto existing = fallback_cache_.find(key);
-    if (existing != fallback_cache_.end()) {
-        LOGD(TAG, "Replacing existing cache entry: %s", key.format().c_str());
-        fallback_cache_.erase(existing);
+bool ProtocolBridge::serve_from_cache(const BridgeRequest& request, TCPClient* client) {
+    const TcpParseResult& read = request.wifi_request;
+    const uint32_t ttl_ms =
+        cache_first_ttl_ms(read.function_code, read.start_register, read.register_count);
+    if (ttl_ms == 0 || !client || !client->client) {
+        return false;
+    }
+
+#if CACHE_SWR_ENABLED
+    // Between the TTL and the hard TTL the copy is answered and refreshed behind
+    const uint32_t max_age_ms = ttl_ms * CACHE_SWR_TTL_FACTOR;
+#else
+    const uint32_t max_age_ms = ttl_ms;
+#endif
+    uint32_t age_ms = 0;
+    if (!get_cached_response(read.function_code, read.start_register, read.register_count,
+                             cache_first_buffer_, max_age_ms, &age_ms, false)) {
+        cache_first_misses_++;
+        return false;
+    }
+
+    const size_t written = client->client->write(
+        reinterpret_cast<const char*>(cache_first_buffer_.data()), cache_first_buffer_.size());
+    if (written != cache_first_buffer_.size()) {
+        LOGW(TAG, "[REQ#%u] ⚠ Partial cache-first write: %u/%u bytes", request.id,
+             (unsigned) written, (unsigned) cache_first_buffer_.size());
+        failed_requests_++;
+        return true;
+    }
+
+    client->last_activity = millis();
+    cache_first_hits_++;
+    cache_first_age_total_ms_ += age_ms;
+    if (age_ms > cache_first_max_age_ms_) {
+        cache_first_max_age_ms_ = age_ms;
+    }
+    successful_requests_++;
+
+    LOGI(TAG, "[REQ#%u] ✓ Served from cache (age=%lums, ttl=%lums)", request.id, age_ms, ttl_ms);
+#if CACHE_SWR_ENABLED
+    if (age_ms > ttl_ms) {
+        cache_stale_hits_++;
+        revalidate(read, age_ms, client_patience_ms(client));
     }
+#endif
+    return true;
+}
 
-    evict_oldest_cache_entry();
+bool ProtocolBridge::serve_from_negative_cache(const BridgeRequest& request, TCPClient* client) {
+    const TcpParseResult& read = request.wifi_request;
+    if (read.is_write_operation || !client || !client->client) {
+        return false;
+    }
 
-    // Store new entry with fresh timestamp
-    ReadCacheEntry entry;
-    entry.key = key;
-    entry.tcp_response_packet = tcp_response;
-    entry.timestamp_ms = millis();
-    entry.last_access_ms = millis();
-    entry.hit_count = 0;
+    uint16_t failed_register = 0;
+    uint8_t exception_code = 0;
+    {
+        CacheLock lock(cache_mutex_);
+        const NegativeEntry* entry = negative_cache_.lookup(read.function_code,
+                                                            read.start_register,
+                                                            read.register_count, millis());
+        if (!entry) {
+            return false;
+        }
+        failed_register = entry->failed_register;
+        exception_code = entry->exception_code;
+    }
 
-    fallback_cache_[key] = entry;
+    // Same frame the inverter sent for this range, without the bus round trip
+    if (!build_exception_response(cache_first_buffer_, read, failed_register, exception_code)) {
+        return false;
+    }
+    client->client->write(reinterpret_cast<const char*>(cache_first_buffer_.data()),
+                          cache_first_buffer_.size());
+    client->last_activity = millis();
 
-    LOGD(TAG, "Fallback cache: stored %s (size=%zu/%zu)", key.format().c_str(),
-         fallback_cache_.size(), MAX_CACHE_ENTRIES);
+    LOGI(TAG, "[REQ#%u] ✗ Known exception 0x%02X (%s) answered locally", request.id,
+         exception_code, InverterProtocol::exception_to_string(exception_code));
+    return true;
 }
 
-void ProtocolBridge::clear_fallback_cache() {
-    if (!fallback_cache_.empty()) {
-        cache_invalidations_ += fallback_cache_.size();
-        fallback_cache_.clear();
+void ProtocolBridge::remember_exception(const ParseResult& rs485_result) {
+#if NEGATIVE_CACHE_ENABLED
+    // Writes carry values, so a refused write says nothing about the next one
+    const TcpParseResult& request = current_request_.wifi_request;
+    if (request.is_write_operation) {
+        return;
+    }
+
+    CacheLock lock(cache_mutex_);
+    negative_cache_.store(request.function_code, current_request_.bus_start,
+                          current_request_.bus_count, rs485_result.start_address,
+                          rs485_result.exception_code, millis());
+#else
+    (void) rs485_result;
+#endif
+}
+
+size_t ProtocolBridge::get_negative_cache_size() const {
+    CacheLock lock(cache_mutex_);
+    return negative_cache_.size(millis());
+}
+
+uint32_t ProtocolBridge::get_negative_cache_hits() const {
+    CacheLock lock(cache_mutex_);
+    return negative_cache_.get_hits();
+}
+
+uint32_t ProtocolBridge::get_negative_cache_stores() const {
+    CacheLock lock(cache_mutex_);
+    return negative_cache_.get_stores();
+}
+
+size_t ProtocolBridge::clear_negative_cache() {
+    CacheLock lock(cache_mutex_);
+    return negative_cache_.clear();
+}
+
+void ProtocolBridge::print_negative_entries(std::function<void(const String&)> callback) const {
+    CacheLock lock(cache_mutex_);
+    if (negative_cache_.size(millis()) == 0) {
+        callback(String("  [empty]"));
+        return;
+    }
+
+    int index = 1;
+    negative_cache_.for_each(millis(), [&](const NegativeEntry& entry, uint32_t age_ms) {
+        char line[112];
+        snprintf(line, sizeof(line),
+                 "  [%d] func=0x%02X regs %u-%u (%u) | exception 0x%02X at %u | hits=%lu "
+                 "age=%lus",
+                 index++, entry.function_code, entry.start_register,
+                 (unsigned) (entry.start_register + entry.register_count - 1),
+                 entry.register_count, entry.exception_code, entry.failed_register,
+                 (unsigned long) entry.hits, (unsigned long) (age_ms / 1000));
+        callback(String(line));
+    });
+}
+
+void ProtocolBridge::invalidate_cached_range(uint8_t function_code, uint16_t start,
+                                             uint16_t count) {
+    if (count == 0) {
+        return;
     }
+
+    CacheLock lock(cache_mutex_);
+    const size_t dropped =
+        register_shadow_.invalidate(static_cast<ModbusFunctionCode>(function_code), start, count);
+    if (dropped > 0) {
+        LOGD(TAG, "Invalidated %u cached registers after write (func=0x%02X start=%u count=%u)",
+             (unsigned) dropped, function_code, start, count);
+        cache_invalidations_ += dropped;
+    }
+}
+
+void ProtocolBridge::clear_fallback_cache() {
+    CacheLock lock(cache_mutex_);
+    cache_invalidations_ += register_shadow_.clear();
 }
 
 bool ProtocolBridge::try_fallback_cache_for_current_request(const char* reason) {
-    // Only try fallback for READ operations
-    if (current_request_.wifi_request.is_write_operation) {
+    const TcpParseResult& read = current_request_.wifi_request;
+
+    // Only try fallback for READ operations that have a client to answer
+    if (read.is_write_operation || is_bare_background()) {
         return false;
     }
 
-    ReadCacheKey cache_key{current_request_.wifi_request.function_code,
-                           current_request_.wifi_request.start_register,
-                           current_request_.wifi_request.register_count};
-
-    std::vector<uint8_t> fallback_response;
-    if (get_fallback_response(cache_key, fallback_response)) {
+    std::vector<uint8_t>& fallback_response = response_buffer_;
+    if (get_fallback_response(read.function_code, read.start_register, read.register_count,
+                              fallback_response)) {
         // Fallback cache found - use it instead of error
-        LOGI(TAG, "%s, using FALLBACK CACHE for %s", reason, cache_key.format().c_str());
+        LOGI(TAG, "%s, using FALLBACK CACHE for func=0x%02X start=%u count=%u", reason,
+             read.function_code, read.start_register, read.register_count);
 
         // Send cached response to client
         set_current_state(BridgeWorkerState::CACHE_FALLBACK);
-        return send_response_to_client(fallback_response, fallback_response.size());
+        return send_response_to_client(fallback_response);
     }
 
-    LOGW(TAG, "⚠ No fallback cache available for this request (%u-%u, %u)",
-         current_request_.wifi_request.function_code, current_request_.wifi_request.start_register,
-         current_request_.wifi_request.register_count);
+    LOGW(TAG, "⚠ No fallback cache available for this request (%u-%u, %u)", read.function_code,
+         read.start_register, read.register_count);
     return false; // ← Failed, no cache available
 }
 
-bool ProtocolBridge::get_cached_response(const ReadCacheKey& key,
+bool ProtocolBridge::get_cached_response(uint8_t function_code, uint16_t start, uint16_t count,
                                          std::vector<uint8_t>& out_response, uint32_t max_age_ms,
-                                         uint32_t* out_age_ms, bool* out_found, bool count_stats) {
-    if (out_found) {
-        *out_found = false;
-    }
+                                         uint32_t* out_age_ms, bool count_stats) {
     if (out_age_ms) {
         *out_age_ms = 0;
     }
 
-    auto it = fallback_cache_.find(key);
-    if (it == fallback_cache_.end()) {
+    const ModbusFunctionCode func = static_cast<ModbusFunctionCode>(function_code);
+    uint32_t age_ms = 0;
+
+    CacheLock lock(cache_mutex_);
+    const bool fresh = register_shadow_.range_age(func, start, count, millis(), age_ms) &&
+                       (max_age_ms == 0 || age_ms <= max_age_ms);
+    if (!fresh) {
         if (count_stats) {
             cache_misses_++;
         }
         return false;
     }
 
-    if (out_found) {
-        *out_found = true;
+    // Rebuild the inverter frame from the shadow, then wrap it like a live reply
+    uint8_t dongle_serial[10];
+    TcpProtocol::copy_serial(dongle_serial_, dongle_serial);
+    if (!register_shadow_.build_read_response(shadow_frame_, func, start, count) ||
+        !TcpProtocol::build_response(out_response, shadow_frame_.data(), shadow_frame_.size(),
+                                     dongle_serial)) {
+        LOGW(TAG, "Cache: failed to rebuild response for func=0x%02X start=%u count=%u",
+             function_code, start, count);
+        return false;
     }
 
-    ReadCacheEntry& entry = it->second;
-    const uint32_t age_ms = entry.get_age(millis());
     if (out_age_ms) {
         *out_age_ms = age_ms;
     }
-
-    if (max_age_ms > 0 && age_ms > max_age_ms) {
-        if (count_stats) {
-            cache_misses_++;
-        }
-        return false;
-    }
-
     if (count_stats) {
         cache_hits_++;
     }
-    out_response = entry.tcp_response_packet;
-    entry.increment_hit_count();
-    entry.update_access_time();
 
-    LOGI(TAG, "Fallback cache HIT: %s (hits=%u, age=%lums)", key.format().c_str(), entry.hit_count,
+    LOGD(TAG, "Cache HIT: func=0x%02X start=%u count=%u (age=%lums)", function_code, start, count,
          age_ms);
-
     return true;
 }
 
-void ProtocolBridge::evict_oldest_cache_entry() {
-    if (fallback_cache_.empty()) {
-        return;
-    }
-
-    uint32_t now_ms = millis();
-    // First pass: Remove entries older (TTL-based)
-    for (auto it = fallback_cache_.begin(); it != fallback_cache_.end();) {
-        if (it->second.get_age(now_ms) > FALLBACK_CACHE_MAX_AGE_MS) {
-            LOGD(TAG, "Evicting stale cache entry: %s (age=%lums)", it->first.format().c_str(),
-                 it->second.get_age(now_ms));
-            it = fallback_cache_.erase(it);
-            cache_invalidations_++;
-        } else {
-            ++it;
-        }
-    }
-
-    // Second pass: If still full, remove oldest entry by timestamp
-    if (fallback_cache_.size() >= MAX_CACHE_ENTRIES) {
-        auto oldest = fallback_cache_.begin();
-        for (auto it = fallback_cache_.begin(); it != fallback_cache_.end(); ++it) {
-            if (it->second.is_older_than(oldest->second)) {
-                oldest = it;
-            }
-        }
-
-        LOGD(TAG, "Fallback cache full, evicting oldest: %s (age=%lums)",
-             oldest->first.format().c_str(), oldest->second.get_age(now_ms));
-        fallback_cache_.erase(oldest);
-        cache_invalidations_++;
-    }
-}
-
 void ProtocolBridge::print_cache_entries(std::function<void(const String&)> callback) const {
-    if (fallback_cache_.empty()) {
+    CacheLock lock(cache_mutex_);
+    if (register_shadow_.valid_count() == 0) {
         callback(String("  [empty]"));
         return;
     }
 
-    uint32_t now_ms = millis();
     int index = 1;
+    register_shadow_.for_each_run(millis(), [&](ModbusFunctionCode func, uint16_t start,
+                                                uint16_t count, uint32_t oldest_age_ms,
+                                                uint32_t newest_age_ms) {
+        char line[96];
+        snprintf(line, sizeof(line), "  [%d] func=0x%02X regs %u-%u (%u) | age=%lu-%lums",
+                 index++, static_cast<uint8_t>(func), start, (unsigned) (start + count - 1),
+                 count, (unsigned long) newest_age_ms, (unsigned long) oldest_age_ms);
+        callback(String(line));
+    });
+}
 
-    for (const auto& entry : fallback_cache_) {
-        String line;
-        line.reserve(150);
-
-        line += "  [";
-        line += index++;
-        line += "] ";
-        line += entry.first.format();
-        line += " | ";
-        line += "packet=";
-        line += entry.second.tcp_response_packet.size();
-        line += "B age=";
-        line += entry.second.get_age(now_ms);
-        line += "ms hits=";
-        line += entry.second.hit_count;
-
-        callback(line);
-    }
+bool ProtocolBridge::get_cached_range_age(uint8_t function_code, uint16_t start, uint16_t count,
+                                          uint32_t& age_ms) const {
+    CacheLock lock(cache_mutex_);
+    return register_shadow_.range_age(static_cast<ModbusFunctionCode>(function_code), start,
+                                      count, millis(), age_ms);
 }
 
-bool ProtocolBridge::get_fallback_response(const ReadCacheKey& key,
+bool ProtocolBridge::get_fallback_response(uint8_t function_code, uint16_t start, uint16_t count,
                                            std::vector<uint8_t>& out_response) {
-    return get_cached_response(key, out_response, FALLBACK_CACHE_MAX_AGE_MS);
+    return get_cached_response(function_code, start, count, out_response,
+                               FALLBACK_CACHE_MAX_AGE_MS);
 }
 
-bool ProtocolBridge::send_response_to_client(const std::vector<uint8_t>& response,
-                                             size_t response_size) {
-    TCPClient* client = resolve_current_client();
-    if (!client || !client->client) {
+bool ProtocolBridge::send_response_to_client(const std::vector<uint8_t>& response) {
+    if (!is_current_client_live()) {
         LOGW(TAG, "⚠ Client %s no longer connected, dropping cached response",
-             current_request_.client_ip.c_str());
+             current_request_.client_ip);
         client_gone_count_++;
         return false;
     }
 
-    size_t written =
-        client->client->write(reinterpret_cast<const char*>(response.data()), response_size);
-    if (written == response_size) {
-        client->last_activity = millis();
-    }
-    LOGI(TAG, "✓ Response sent to client: %u bytes", written);
-    return written == response_size;
+    return post_response(response);
 }
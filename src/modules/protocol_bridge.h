@@ -7,82 +7,24 @@
  */
 #pragma once
 
+#include "negative_cache.h"
 #include "operation_guard.h"
+#include "poll_predictor.h"
+#include "register_shadow.h"
 #include "rs485_manager.h"
 #include "tcp_protocol.h"
 #include "tcp_server.h"
+#include "utils/fixed_vector.h"
+#include "utils/spsc_ring.h"
 
 #include <Arduino.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
 
 #include <array>
+#include <atomic>
 #include <functional>
-#include <map>
-
-// ============================================================================
-// Fallback Cache - Safety Net for RS485 Failures
-// ============================================================================
-
-/**
- * @brief Key for fallback cache lookup
- *
- * Uniquely identifies a read request by function code, start register, and register count
- */
-struct ReadCacheKey {
-    uint8_t function_code;
-    uint16_t start_register;
-    uint16_t register_count;
-
-    bool operator<(const ReadCacheKey& other) const {
-        if (function_code != other.function_code)
-            return function_code < other.function_code;
-        if (start_register != other.start_register)
-            return start_register < other.start_register;
-        return register_count < other.register_count;
-    }
-
-    bool operator==(const ReadCacheKey& other) const {
-        return function_code == other.function_code && start_register == other.start_register &&
-               register_count == other.register_count;
-    }
-
-    // Format key as string for logging
-    String format() const {
-        char buffer[64];
-        snprintf(buffer, sizeof(buffer), "func=0x%02X start=%d count=%d", function_code,
-                 start_register, register_count);
-        return String(buffer);
-    }
-};
-
-/**
- * @brief Entry stored in the fallback cache
- *
- * Contains the last successful response for a specific read request
- * Used when RS485 fails (timeout, error, collision)
- */
-struct ReadCacheEntry {
-    ReadCacheKey key;
-    std::vector<uint8_t> tcp_response_packet; // WiFi response packet (A1 1A format)
-    uint32_t timestamp_ms;                    // Timestamp when entry was cached
-    uint32_t hit_count;                       // Number of times used as fallback
-    uint32_t last_access_ms;                  // Timestamp of last access (for LRU)
-
-    ReadCacheEntry() : timestamp_ms(0), hit_count(0), last_access_ms(0) {}
-
-    // Get age of entry in milliseconds
-    uint32_t get_age(uint32_t now_ms) const { return now_ms - timestamp_ms; }
-
-    // Update last access time for LRU tracking
-    void update_access_time() { last_access_ms = millis(); }
-
-    // Increment hit counter
-    void increment_hit_count() { hit_count++; }
-
-    // Check if this entry is older by last access time (LRU comparison)
-    bool is_older_than(const ReadCacheEntry& other) const {
-        return last_access_ms < other.last_access_ms;
-    }
-};
 
 enum class BridgeWorkerState : uint8_t {
     IDLE = 0,
@@ -104,6 +46,45 @@ enum class BridgeWorkerState : uint8_t {
  * - RS485 Protocol (Modbus-like) to/from Inverter
  */
 
+/**
+ * @brief Scheduling class of a queued request; lower is served first
+ */
+enum class BridgePriority : uint8_t {
+    WRITE = 0,   // User-initiated setting change
+    INTERACTIVE, // Small read, typically a UI refresh
+    BULK,        // Bank poll, prefetch or stale refresh
+};
+
+/**
+ * @brief Circuit breaker guarding the RS485 bus
+ *
+ * CLOSED: requests go to the bus. OPEN: the inverter is unreachable, so
+ * requests are answered from the cache or refused at once. HALF_OPEN: the
+ * next request goes to the bus as a probe and decides between the two.
+ */
+enum class BreakerState : uint8_t {
+    CLOSED,
+    OPEN,
+    HALF_OPEN,
+};
+
+/**
+ * @brief Client answered by another request's RS485 transaction
+ *
+ * Either an identical read (single-flight), a neighbouring read merged
+ * into the same bus read, or a single register write combined into the
+ * same bus write; the range is what this client asked for.
+ */
+struct BridgeWaiter {
+    AsyncClient* client_handle = nullptr;
+    uint32_t id = 0;
+    uint16_t start_register = 0;
+    uint16_t register_count = 0;
+    uint16_t write_value = 0; // Combined writes: the value this client wrote
+};
+
+static constexpr size_t BRIDGE_MAX_WAITERS = 4;
+
 struct BridgeRequest {
     // Stable handle: AsyncClient* is heap-allocated and persists until
     // TCPServer::destroy_client() is called. The TCPClient struct itself
@@ -111,22 +92,54 @@ struct BridgeRequest {
     // TCPServer::resolve_client() at the point of use instead of caching
     // a TCPClient*.
     AsyncClient* client_handle = nullptr;
-    String client_ip; // Snapshot for logging, even if client goes away
+    char client_ip[16] = {0}; // Snapshot for logging, even if client goes away
     TcpParseResult wifi_request;
     uint32_t timestamp = 0;
+    uint32_t deadline_ms = 0; // After this the client no longer waits for the answer
     uint32_t id = 0;
     uint8_t retry_count = 0;
+    BridgePriority priority = BridgePriority::BULK;
+
+    // Single-flight / read merging: queued reads served by this request's response
+    FixedVector<BridgeWaiter, BRIDGE_MAX_WAITERS> waiters;
+    bool consumed = false; // Taken by the worker out of order, or coalesced into the active
+                           // request; popped once it reaches the front of the ring
+    bool background = false; // Prefetch or stale refresh; no client of its own
+    bool bank_aligned = false; // Bus range widened to canonical banks
+
+    // Registers actually read or written on the bus; wider than wifi_request
+    // once reads are merged or aligned to banks, or writes are combined
+    uint16_t bus_start = 0;
+    uint16_t bus_count = 0;
 
     BridgeRequest() = default;
 };
 
+/**
+ * @brief Worker → network hand-off for one TCP client
+ *
+ * The RS485 worker never touches AsyncTCP; it posts what to send (or that
+ * the connection should close) and the network side delivers it.
+ */
+struct BridgeCompletion {
+    enum class Action : uint8_t { SEND, CLOSE };
+
+    Action action = Action::SEND;
+    FixedVector<AsyncClient*, 1 + BRIDGE_MAX_WAITERS> client_handles; // Request + waiters
+    uint32_t request_id = 0;
+    const char* reason = nullptr; // CLOSE only; static string
+    FixedVector<uint8_t, TCP_PROTO_MAX_RESPONSE_SIZE> packet;
+};
+
 class ProtocolBridge {
   public:
     static ProtocolBridge& getInstance();
 
     // Lifecycle
     void begin(const String& dongle_serial = "0000000000");
-    void loop();
+    void loop(); // Network side; also runs the worker when it has no task
+    bool start_worker_task();
+    bool has_worker_task() const { return worker_task_ != nullptr; }
 
     // Configuration
     void set_tcp_server(TCPServer* server) { tcp_server_ = server; }
@@ -139,18 +152,32 @@ class ProtocolBridge {
     // Status
     bool is_ready() const { return tcp_server_ != nullptr && rs485_ != nullptr; }
     bool is_paused() const { return paused_; }
-    bool is_busy() const { return has_active_request_ || request_queue_count_ > 0; }
+    bool is_busy() const { return has_active_request_ || !request_queue_.empty(); }
     void set_pause(bool paused);
     uint32_t get_total_requests() const { return total_requests_; }
     uint32_t get_successful_requests() const { return successful_requests_; }
     uint32_t get_failed_requests() const { return failed_requests_; }
     const char* get_worker_state_name() const { return worker_state_name(worker_state_); }
-    size_t get_queue_size() const { return request_queue_count_; }
-    size_t get_queue_capacity() const { return REQUEST_QUEUE_MAX_DEPTH; }
+    size_t get_queue_size() const { return request_queue_.size(); }
+    size_t get_queue_capacity() const { return queue_limit_; }
     uint32_t get_active_request_id() const { return has_active_request_ ? current_request_.id : 0; }
     uint32_t get_queued_requests() const { return queued_requests_; }
     uint32_t get_queue_drops() const { return queue_drops_; }
     uint32_t get_client_gone_count() const { return client_gone_count_; }
+    uint32_t get_coalesced_requests() const { return coalesced_requests_; }
+    uint32_t get_merged_requests() const { return merged_requests_; }
+    uint32_t get_bank_aligned_reads() const { return bank_aligned_reads_; }
+    uint32_t get_bank_padding_registers() const { return bank_padding_registers_; }
+    uint32_t get_bank_refusals() const { return bank_refusals_; }
+    uint32_t get_merge_refusals() const { return merge_refusals_; }
+    uint32_t get_combined_writes() const { return combined_writes_; }
+    BreakerState get_breaker_state() const { return breaker_state_.load(); }
+    const char* get_breaker_state_name() const;
+    uint32_t get_breaker_opens() const { return breaker_opens_; }
+    uint32_t get_breaker_fast_fails() const { return breaker_fast_fails_; }
+    uint32_t get_superseded_writes() const { return superseded_writes_; }
+    uint32_t get_reordered_requests() const { return reordered_requests_; }
+    uint32_t get_deadline_drops() const { return deadline_drops_; }
     uint32_t get_last_finished_request_id() const { return last_finished_request_id_; }
     const char* get_last_terminal_state_name() const {
         return worker_state_name(last_terminal_state_);
@@ -158,11 +185,22 @@ class ProtocolBridge {
     uint32_t get_last_finished_elapsed_ms() const { return last_finished_elapsed_ms_; }
 
     // ========== Cache Status Methods ==========
-    size_t get_cache_size() const { return fallback_cache_.size(); }
-    size_t get_cache_capacity() const { return MAX_CACHE_ENTRIES; }
+    size_t get_cache_size() const;
+    size_t get_cache_capacity() const { return cache_capacity_; }
+    uint32_t get_cache_resizes() const { return cache_resizes_; }
     uint32_t get_cache_hits() const { return cache_hits_; }
     uint32_t get_cache_misses() const { return cache_misses_; }
     uint32_t get_cache_invalidations() const { return cache_invalidations_; }
+    uint32_t get_cache_write_updates() const { return cache_write_updates_; }
+    uint32_t get_cache_first_hits() const { return cache_first_hits_; }
+    uint32_t get_cache_first_misses() const { return cache_first_misses_; }
+    uint32_t get_cache_first_max_age_ms() const { return cache_first_max_age_ms_; }
+    uint32_t get_cache_stale_hits() const { return cache_stale_hits_; }
+    uint32_t get_stale_refreshes() const { return stale_refreshes_; }
+    uint32_t get_cache_first_avg_age_ms() const {
+        return cache_first_hits_ > 0 ? cache_first_age_total_ms_ / cache_first_hits_ : 0;
+    }
+    const PollPredictor& get_poll_predictor() const { return poll_predictor_; }
     float get_cache_hit_ratio() const {
         uint32_t hits = get_cache_hits();
         uint32_t misses = get_cache_misses();
@@ -174,16 +212,71 @@ class ProtocolBridge {
     void clear_fallback_cache();
     void print_cache_entries(std::function<void(const String&)> callback) const;
 
+    // ========== Negative Cache (reads refused with an exception) ==========
+    size_t get_negative_cache_size() const;
+    uint32_t get_negative_cache_hits() const;
+    uint32_t get_negative_cache_stores() const;
+    size_t clear_negative_cache();
+    void print_negative_entries(std::function<void(const String&)> callback) const;
+
   private:
     ProtocolBridge() = default;
     ~ProtocolBridge() = default;
     ProtocolBridge(const ProtocolBridge&) = delete;
     ProtocolBridge& operator=(const ProtocolBridge&) = delete;
 
-    bool enqueue_request(BridgeRequest&& request);
+    // ========== Network Side ==========
+    static void worker_task_trampoline(void* arg);
+    void refresh_live_clients();
+    void deliver_completions();
+    void run_prefetcher();
+    void revalidate(const TcpParseResult& read, uint32_t age_ms, uint32_t patience_ms);
+    uint32_t enqueue_background_read(uint8_t function_code, uint16_t start, uint16_t count,
+                                     const uint8_t* inverter_serial, const char* label,
+                                     uint32_t deadline_ms);
+    void learn_client_patience(TCPClient& client, uint32_t now);
+    static uint32_t client_patience_ms(const TCPClient* client);
+    void answer_while_open(const BridgeRequest& request, TCPClient* client);
+    void refresh_client_occupancy();
+    size_t update_queue_limit();
+    size_t update_cache_capacity();
+    size_t count_queued(const AsyncClient* handle);
+    const char* check_admission(const AsyncClient* handle, BridgePriority priority);
+    static BridgePriority classify(const TcpParseResult& request);
+
+    // ========== Worker Side ==========
+    void run_worker();
+    void update_breaker();
+    void note_bus_result(bool responded);
+    void open_breaker(const char* reason);
+    void fail_fast_current_request();
     bool dequeue_request(BridgeRequest& request);
-    bool queue_empty() const { return request_queue_count_ == 0; }
-    bool queue_full() const { return request_queue_count_ >= REQUEST_QUEUE_MAX_DEPTH; }
+    void release_consumed();
+    bool outranks(const BridgeRequest& a, const BridgeRequest& b) const;
+    uint32_t last_dispatch(const AsyncClient* handle) const;
+    void note_dispatch(const AsyncClient* handle);
+    static bool deadline_passed(const BridgeRequest& request, uint32_t now);
+    void attach_queued_duplicates();
+    static bool is_same_read(const TcpParseResult& a, const TcpParseResult& b);
+#if BRIDGE_READ_MERGE && BRIDGE_MERGE_WINDOW_MS > 0
+    bool merge_window_open();
+#endif
+    void merge_queued_reads();
+    void align_to_banks();
+    void combine_queued_writes();
+    void answer_combined_writes(BridgeWorkerState terminal_state);
+    bool is_combined_write() const {
+        return current_request_.wifi_request.is_write_operation &&
+               !current_request_.waiters.empty();
+    }
+    bool build_write_ack(std::vector<uint8_t>& wifi_response, uint16_t reg, uint16_t value);
+    bool post_client_response(const std::vector<uint8_t>& packet, AsyncClient* handle);
+    bool retry_unaligned(const ParseResult& rs485_result);
+    bool retry_split(const ParseResult& rs485_result);
+    void start_split_read();
+    void answer_merged_reads(BridgeWorkerState terminal_state);
+    bool has_merged_reads() const;
+    bool queue_empty() const { return request_queue_.empty(); }
     void drop_queued_requests(const char* reason);
     void start_next_request();
     void start_current_request();
@@ -192,29 +285,48 @@ class ProtocolBridge {
     bool send_current_request_to_rs485();
     void defer_current_request_retry(const char* reason);
     void finish_deferred_send_failure(const char* reason);
+    static uint32_t next_retry_delay_ms();
     void finish_current_request(BridgeWorkerState terminal_state);
     void set_current_state(BridgeWorkerState state);
     static const char* worker_state_name(BridgeWorkerState state);
-    static bool validate_response_match(const ParseResult& result, const TcpParseResult& request);
+    static bool validate_response_match(const ParseResult& result, const BridgeRequest& request);
     bool send_wifi_response(const ParseResult& rs485_result);
-    void send_error_response(const String& error);
-    bool send_gateway_target_failed_response(const String& reason);
-    // Resolve the current request's client handle to a live TCPClient*, or
-    // nullptr if it has been disconnected/removed in the meantime.
-    TCPClient* resolve_current_client();
+    bool build_range_response(const ParseResult& result, uint16_t start, uint16_t count,
+                              std::vector<uint8_t>& out);
+    void send_error_response(const char* error);
+    bool send_gateway_target_failed_response(const char* reason);
+    // Whether a client handle was still connected at the last network-side
+    // snapshot. The worker never resolves TCPClient entries itself.
+    bool is_client_live(const AsyncClient* handle) const;
+    bool is_current_client_live() const; // Requester or any coalesced waiter
+    // Prefetch nobody has joined yet: nothing to answer, only the cache to fill
+    bool is_bare_background() const {
+        return current_request_.background && current_request_.waiters.empty();
+    }
+    bool post_response(const std::vector<uint8_t>& packet);
+    bool post_range_response(const std::vector<uint8_t>& packet, uint16_t start, uint16_t count);
+    bool post_exception_response(uint16_t start, uint16_t count, uint8_t exception_code);
+    bool build_exception_response(std::vector<uint8_t>& wifi_response,
+                                  const TcpParseResult& request, uint16_t start,
+                                  uint8_t exception_code) const;
+    bool post_close(const BridgeRequest& request, const char* reason);
 
     // ========== Fallback Cache Methods ==========
-    void cache_read_response(const TcpParseResult& request,
-                             const std::vector<uint8_t>& tcp_response);
-    void cache_response_for_fallback(const ReadCacheKey& key,
-                                     const std::vector<uint8_t>& tcp_response);
-    bool get_cached_response(const ReadCacheKey& key, std::vector<uint8_t>& out_response,
-                             uint32_t max_age_ms, uint32_t* out_age_ms = nullptr,
-                             bool* out_found = nullptr, bool count_stats = true);
-    bool get_fallback_response(const ReadCacheKey& key, std::vector<uint8_t>& out_response);
+    bool serve_from_cache(const BridgeRequest& request, TCPClient* client); // Network side
+    bool serve_from_negative_cache(const BridgeRequest& request, TCPClient* client);
+    void remember_exception(const ParseResult& rs485_result);
+    void invalidate_cached_range(uint8_t function_code, uint16_t start, uint16_t count);
+    void cache_read_result(const ParseResult& rs485_result);
+    void cache_write_result(const ParseResult& rs485_result);
+    bool get_cached_response(uint8_t function_code, uint16_t start, uint16_t count,
+                             std::vector<uint8_t>& out_response, uint32_t max_age_ms,
+                             uint32_t* out_age_ms = nullptr, bool count_stats = true);
+    bool get_fallback_response(uint8_t function_code, uint16_t start, uint16_t count,
+                               std::vector<uint8_t>& out_response);
+    bool get_cached_range_age(uint8_t function_code, uint16_t start, uint16_t count,
+                              uint32_t& age_ms) const;
     bool try_fallback_cache_for_current_request(const char* reason);
-    bool send_response_to_client(const std::vector<uint8_t>& response, size_t response_size);
-    void evict_oldest_cache_entry();
+    bool send_response_to_client(const std::vector<uint8_t>& response);
 
     // ========== RS485 Response Handling ==========
     BridgeWorkerState handle_rs485_success(const ParseResult& rs485_result, unsigned long elapsed);
@@ -225,42 +337,120 @@ class ProtocolBridge {
     TCPServer* tcp_server_ = nullptr;
     RS485Manager* rs485_ = nullptr;
     String dongle_serial_;
-
-    static constexpr size_t REQUEST_QUEUE_MAX_DEPTH = 4;
-
-    std::array<BridgeRequest, REQUEST_QUEUE_MAX_DEPTH> request_queue_;
-    size_t request_queue_head_ = 0;
-    size_t request_queue_tail_ = 0;
-    size_t request_queue_count_ = 0;
+    std::vector<uint8_t> response_buffer_; // Reused for every TCP response we build
+    std::vector<uint8_t> frame_buffer_;    // Worker side: inverter frames rebuilt for a range
+    uint16_t combined_values_[BRIDGE_WRITE_COMBINE_MAX]; // Worker: payload of a combined write
+    std::vector<uint8_t> cache_first_buffer_; // Network side: cache-first replies
+
+    static constexpr size_t REQUEST_QUEUE_MAX_DEPTH = BRIDGE_QUEUE_MAX_DEPTH;
+    static constexpr size_t WRITE_RESERVED_SLOTS = 1; // Reads can never fill the whole queue
+    static constexpr size_t COMPLETION_QUEUE_DEPTH = 8; // One per client range of a request
+    static constexpr size_t LIVE_CLIENT_SLOTS = 8;
+
+    // ========== Task Hand-off ==========
+    // request_queue_: network side produces, worker consumes.
+    // completions_: worker produces, network side consumes.
+    SpscRing<BridgeRequest, REQUEST_QUEUE_MAX_DEPTH> request_queue_;
+    SpscRing<BridgeCompletion, COMPLETION_QUEUE_DEPTH> completions_;
+    std::atomic<AsyncClient*> live_clients_[LIVE_CLIENT_SLOTS]; // Written by the network side
+    std::atomic<size_t> queue_limit_{BRIDGE_QUEUE_MIN_DEPTH}; // Heap-sized, network side
+    TaskHandle_t worker_task_ = nullptr;
+    SemaphoreHandle_t cache_mutex_ = nullptr; // Worker vs. command-side cache access
+
+    // ========== Worker State ==========
     BridgeRequest current_request_;
-    bool has_active_request_ = false;
-    BridgeWorkerState worker_state_ = BridgeWorkerState::IDLE;
-    BridgeWorkerState last_terminal_state_ = BridgeWorkerState::IDLE;
+    std::atomic<bool> has_active_request_{false};
+    std::atomic<BridgeWorkerState> worker_state_{BridgeWorkerState::IDLE};
+    std::atomic<BridgeWorkerState> last_terminal_state_{BridgeWorkerState::IDLE};
     bool waiting_rs485_response_ = false;
     bool pending_rs485_send_retry_ = false;
     uint32_t last_request_time_ = 0;
     uint32_t last_send_attempt_time_ = 0;
     uint32_t current_retry_delay_ms_ = RS485_SEND_RETRY_DELAY_MS;
-    bool paused_ = false;
 
-    // ========== Fallback Cache ==========
-    std::map<ReadCacheKey, ReadCacheEntry> fallback_cache_;
-    static constexpr size_t MAX_CACHE_ENTRIES = 14;
+    // Refused merged read: client ranges still to be re-read one at a time
+    struct SplitReads {
+        uint8_t function_code = 0;
+        uint8_t inverter_serial[TCP_PROTO_DONGLE_SERIAL_LEN] = {0};
+        FixedVector<BridgeWaiter, BRIDGE_MAX_WAITERS> waiters;
+    };
+    SplitReads split_reads_;
+
+    // Round-robin between clients: when each was last dispatched (worker side)
+    struct ClientTurn {
+        const AsyncClient* handle = nullptr;
+        uint32_t dispatch_seq = 0;
+    };
+    ClientTurn client_turns_[LIVE_CLIENT_SLOTS];
+    uint32_t dispatch_seq_ = 0;
+    std::atomic<bool> paused_{false};
+
+    // ========== Register Shadow (fallback and cache-first source) ==========
+    RegisterShadow register_shadow_;
+    std::vector<uint8_t> shadow_frame_; // Rebuilt inverter frame, guarded by cache_mutex_
+    NegativeCache negative_cache_;      // Guarded by cache_mutex_
 
     // Cache statistics
     uint32_t cache_hits_ = 0;
     uint32_t cache_misses_ = 0;
     uint32_t cache_invalidations_ = 0;
-
-    // Statistics
+    uint32_t cache_write_updates_ = 0; // Registers updated from acknowledged writes
+
+    // Shadow span fitted to free heap (network side)
+    std::atomic<size_t> cache_capacity_{2 * static_cast<size_t>(SHADOW_REGISTER_COUNT)};
+    uint32_t cache_resizes_ = 0;
+    uint32_t last_cache_resize_ms_ = 0;
+
+    // ========== Prefetch (network side) ==========
+    PollPredictor poll_predictor_;
+    uint32_t foreign_requests_seen_ = 0;
+    uint32_t last_foreign_traffic_ms_ = 0;
+
+    // Cache-first statistics (network side)
+    uint32_t cache_first_hits_ = 0;
+    uint32_t cache_first_misses_ = 0;
+    uint32_t cache_first_age_total_ms_ = 0;
+    uint32_t cache_first_max_age_ms_ = 0;
+
+    // Stale-while-revalidate (network side): recent background refresh per range
+    struct StaleRefresh {
+        uint8_t function_code = 0;
+        uint16_t start_register = 0;
+        uint16_t register_count = 0;
+        uint32_t issued_ms = 0;
+    };
+    static constexpr size_t STALE_REFRESH_SLOTS = 4;
+    StaleRefresh refresh_slots_[STALE_REFRESH_SLOTS];
+    uint32_t cache_stale_hits_ = 0; // Cache-first hits past the TTL (subset of hits)
+    uint32_t stale_refreshes_ = 0;
+
+    // Statistics (atomic where both sides count)
     uint32_t queued_requests_ = 0;
-    uint32_t queue_drops_ = 0;
-    uint32_t client_gone_count_ = 0;
+    std::atomic<uint32_t> queue_drops_{0};
+    std::atomic<uint32_t> client_gone_count_{0};
+    uint32_t coalesced_requests_ = 0;
+    uint32_t merged_requests_ = 0;
+    uint32_t bank_aligned_reads_ = 0;
+    uint32_t bank_padding_registers_ = 0; // Registers read beyond what clients asked for
+    uint32_t bank_refusals_ = 0;          // Aligned reads refused, re-sent as requested
+    uint32_t merge_refusals_ = 0;         // Merged reads refused, re-read per client range
+    uint32_t combined_writes_ = 0;   // Writes to a neighbouring register folded into a bus write
+    uint32_t superseded_writes_ = 0; // Writes overtaken by a later value for the same register
+
+    // Circuit breaker: state written by the worker, read by the network side
+    std::atomic<BreakerState> breaker_state_{BreakerState::CLOSED};
+    uint32_t breaker_opened_ms_ = 0;
+    bool breaker_link_down_ = false; // Opened because the RS485 manager lost the inverter
+    uint8_t consecutive_timeouts_ = 0;
+    uint32_t breaker_opens_ = 0;
+    std::atomic<uint32_t> breaker_fast_fails_{0}; // Requests answered without the bus
+    uint32_t reordered_requests_ = 0; // Started ahead of an older queued request
+    std::atomic<uint32_t> deadline_drops_{0};
     uint32_t last_finished_request_id_ = 0;
     uint32_t last_finished_elapsed_ms_ = 0;
-    uint32_t total_requests_ = 0;
-    uint32_t successful_requests_ = 0;
-    uint32_t failed_requests_ = 0;
+    std::atomic<uint32_t> total_requests_{0};
+    std::atomic<uint32_t> successful_requests_{0};
+    std::atomic<uint32_t> failed_requests_{0};
 
     static constexpr uint32_t REQUEST_TIMEOUT_MS = 2000;
     static constexpr uint32_t RS485_SEND_RETRY_DELAY_MS = 120;
@@ -268,4 +458,7 @@ class ProtocolBridge {
     static constexpr uint32_t RS485_SEND_RETRY_WINDOW_MS = 1600;
     static constexpr uint8_t RS485_SEND_MAX_RETRIES = 14;
     static constexpr uint32_t FALLBACK_CACHE_MAX_AGE_MS = 45 * 1000;
+    // Longest a background read can take from enqueue to completion
+    static constexpr uint32_t STALE_REFRESH_WINDOW_MS =
+        REQUEST_TIMEOUT_MS + RS485_SEND_RETRY_WINDOW_MS;
 };
@@ -0,0 +1,223 @@
+/**
+ * @file register_shadow.cpp
+ * @brief Register-level shadow of the inverter's input and holding registers
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#include "register_shadow.h"
+
+#include "logger.h"
+
+#include <algorithm>
+
+static const char* TAG = "shadow";
+
+// ============================================================================
+// Table Selection
+// ============================================================================
+
+RegisterShadow::Table* RegisterShadow::table_for(ModbusFunctionCode func) {
+    return const_cast<Table*>(static_cast<const RegisterShadow*>(this)->table_for(func));
+}
+
+const RegisterShadow::Table* RegisterShadow::table_for(ModbusFunctionCode func) const {
+    switch (func) {
+        case ModbusFunctionCode::READ_INPUT:
+            return &input_;
+        case ModbusFunctionCode::READ_HOLDING:
+        case ModbusFunctionCode::WRITE_SINGLE:
+        case ModbusFunctionCode::WRITE_MULTI:
+            return &holding_;
+    }
+    return nullptr;
+}
+
+bool RegisterShadow::in_range(uint16_t start, uint16_t count) const {
+    return count > 0 && static_cast<uint32_t>(start) + count <= registers_;
+}
+
+// Validity bits of registers [start, end) that fall into bitset word `word`
+static uint32_t range_mask(uint32_t word, uint32_t start, uint32_t end) {
+    const uint32_t lo = std::max(start, word << 5) - (word << 5);
+    const uint32_t hi = std::min(end, (word + 1) << 5) - (word << 5);
+    const uint32_t bits = hi - lo;
+    return (bits >= 32 ? UINT32_MAX : (1u << bits) - 1) << lo;
+}
+
+// ============================================================================
+// Update
+// ============================================================================
+
+size_t RegisterShadow::store(const ParseResult& result, uint32_t now_ms) {
+    if (!result.success) {
+        return 0;
+    }
+    return store(result.function_code, result.start_address, result.register_values.data(),
+                 result.register_values.size(), result.serial_number, now_ms);
+}
+
+size_t RegisterShadow::store(ModbusFunctionCode func, uint16_t start, const uint16_t* values,
+                             size_t count, const uint8_t* serial, uint32_t now_ms) {
+    Table* table = table_for(func);
+    if (table == nullptr || values == nullptr || count == 0 || start >= registers_) {
+        return 0;
+    }
+
+    // Registers past the end of the table are simply not shadowed
+    if (start + count > registers_) {
+        count = registers_ - start;
+    }
+
+    memcpy(&table->values[start], values, count * sizeof(uint16_t));
+    std::fill(&table->stored_ms[start], &table->stored_ms[start + count], now_ms);
+    const uint32_t end = start + count;
+    for (uint32_t word = start >> 5; word <= (end - 1) >> 5; word++) {
+        table->valid[word] |= range_mask(word, start, end);
+    }
+    memcpy(serial_, serial, MODBUS_SERIAL_NUMBER_LENGTH);
+
+    LOGD(TAG, "Stored func=0x%02X regs %u-%u", static_cast<uint8_t>(func), start,
+         (unsigned) (start + count - 1));
+    return count;
+}
+
+size_t RegisterShadow::invalidate(ModbusFunctionCode func, uint16_t start, uint16_t count) {
+    Table* table = table_for(func);
+    if (table == nullptr || start >= registers_) {
+        return 0;
+    }
+
+    const uint32_t end = std::min<uint32_t>(static_cast<uint32_t>(start) + count, registers_);
+    size_t dropped = 0;
+    for (uint32_t word = start >> 5; start < end && word <= (end - 1) >> 5; word++) {
+        const uint32_t mask = range_mask(word, start, end);
+        dropped += __builtin_popcount(table->valid[word] & mask);
+        table->valid[word] &= ~mask;
+    }
+    return dropped;
+}
+
+size_t RegisterShadow::clear() {
+    const size_t dropped = valid_count();
+    std::fill(input_.valid.begin(), input_.valid.end(), 0);
+    std::fill(holding_.valid.begin(), holding_.valid.end(), 0);
+    memset(serial_, 0, MODBUS_SERIAL_NUMBER_LENGTH);
+    return dropped;
+}
+
+size_t RegisterShadow::resize_table(Table& table, uint16_t registers) {
+    const size_t words = registers / 32;
+    size_t dropped = 0;
+    for (size_t word = words; word < table.valid.size(); word++) {
+        dropped += __builtin_popcount(table.valid[word]);
+    }
+
+    // Spans are whole words, so growing only adds cleared validity bits.
+    // shrink_to_fit() hands the memory back instead of keeping the capacity.
+    table.values.resize(registers);
+    table.stored_ms.resize(registers);
+    table.valid.resize(words, 0);
+    table.values.shrink_to_fit();
+    table.stored_ms.shrink_to_fit();
+    table.valid.shrink_to_fit();
+    return dropped;
+}
+
+size_t RegisterShadow::resize(uint16_t registers_per_table) {
+    uint16_t registers = registers_per_table & ~31u;
+    if (registers < MIN_REGISTERS_PER_TABLE) {
+        registers = MIN_REGISTERS_PER_TABLE;
+    } else if (registers > REGISTERS_PER_TABLE) {
+        registers = REGISTERS_PER_TABLE;
+    }
+    if (registers == registers_) {
+        return 0;
+    }
+
+    const size_t dropped = resize_table(input_, registers) + resize_table(holding_, registers);
+    registers_ = registers;
+    return dropped;
+}
+
+// ============================================================================
+// Lookup
+// ============================================================================
+
+bool RegisterShadow::range_age(ModbusFunctionCode func, uint16_t start, uint16_t count,
+                               uint32_t now_ms, uint32_t& age_ms) const {
+    const Table* table = table_for(func);
+    if (table == nullptr || !in_range(start, count)) {
+        return false;
+    }
+
+    // Whole bitset words first: a miss costs at most five word compares
+    const uint32_t end = static_cast<uint32_t>(start) + count;
+    for (uint32_t word = start >> 5; word <= (end - 1) >> 5; word++) {
+        const uint32_t mask = range_mask(word, start, end);
+        if ((table->valid[word] & mask) != mask) {
+            return false;
+        }
+    }
+
+    uint32_t oldest = 0;
+    for (uint32_t reg = start; reg < end; reg++) {
+        const uint32_t age = now_ms - table->stored_ms[reg];
+        if (age > oldest) {
+            oldest = age;
+        }
+    }
+
+    age_ms = oldest;
+    return true;
+}
+
+bool RegisterShadow::build_read_response(std::vector<uint8_t>& frame, ModbusFunctionCode func,
+                                         uint16_t start, uint16_t count) const {
+    const Table* table = table_for(func);
+    if (table == nullptr || !in_range(start, count)) {
+        return false;
+    }
+    return InverterProtocol::create_read_response(frame, func, serial_, start,
+                                                  &table->values[start], count);
+}
+
+// ============================================================================
+// Status
+// ============================================================================
+
+size_t RegisterShadow::valid_count() const {
+    size_t count = 0;
+    for (size_t i = 0; i < input_.valid.size(); i++) {
+        count += __builtin_popcount(input_.valid[i]) + __builtin_popcount(holding_.valid[i]);
+    }
+    return count;
+}
+
+void RegisterShadow::for_each_run(uint32_t now_ms, const RunCallback& callback) const {
+    const ModbusFunctionCode funcs[] = {ModbusFunctionCode::READ_INPUT,
+                                        ModbusFunctionCode::READ_HOLDING};
+
+    for (ModbusFunctionCode func : funcs) {
+        const Table* table = table_for(func);
+        uint32_t reg = 0;
+        while (reg < registers_) {
+            if (!table->is_valid(reg)) {
+                reg++;
+                continue;
+            }
+
+            const uint32_t run_start = reg;
+            uint32_t oldest = 0;
+            uint32_t newest = UINT32_MAX;
+            for (; reg < registers_ && table->is_valid(reg); reg++) {
+                const uint32_t age = now_ms - table->stored_ms[reg];
+                oldest = std::max(oldest, age);
+                newest = std::min(newest, age);
+            }
+            callback(func, static_cast<uint16_t>(run_start),
+                     static_cast<uint16_t>(reg - run_start), oldest, newest);
+        }
+    }
+}
@@ -0,0 +1,104 @@
+/**
+ * @file register_shadow.h
+ * @brief Register-level shadow of the inverter's input and holding registers
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include "../config.h"
+#include "inverter_protocol.h"
+
+#include <Arduino.h>
+
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Last known value of every inverter register, with per-register age
+ *
+ * Successful reads are stored register by register in two dense tables
+ * (0x04 input, 0x03 holding), each with a store timestamp and a validity
+ * bit. Any later read whose registers are all present can then be
+ * answered, whatever request boundaries the original polls used.
+ *
+ * Both tables span the same number of registers from 0, between
+ * MIN_REGISTERS_PER_TABLE and REGISTERS_PER_TABLE. The owner resizes them
+ * with the free heap; shrinking drops the registers past the new end.
+ *
+ * Not thread-safe: the owner serializes access.
+ */
+class RegisterShadow {
+  public:
+    static constexpr uint16_t REGISTERS_PER_TABLE = SHADOW_REGISTER_COUNT;
+    static constexpr uint16_t MIN_REGISTERS_PER_TABLE = SHADOW_MIN_REGISTERS;
+    /// Heap per register of table span (value + timestamp in both tables)
+    static constexpr size_t BYTES_PER_REGISTER = 2 * (sizeof(uint16_t) + sizeof(uint32_t));
+
+    static_assert(REGISTERS_PER_TABLE % 32 == 0 && MIN_REGISTERS_PER_TABLE % 32 == 0,
+                  "Shadow spans must be whole validity words");
+    static_assert(MIN_REGISTERS_PER_TABLE <= REGISTERS_PER_TABLE,
+                  "SHADOW_MIN_REGISTERS exceeds SHADOW_REGISTER_COUNT");
+
+    /// Called once per contiguous run of valid registers
+    using RunCallback = std::function<void(ModbusFunctionCode func, uint16_t start,
+                                           uint16_t count, uint32_t oldest_age_ms,
+                                           uint32_t newest_age_ms)>;
+
+    RegisterShadow() {
+        resize(REGISTERS_PER_TABLE);
+        clear();
+    }
+
+    // ========== Update ==========
+    /// Store the registers of a successful read; returns registers stored
+    size_t store(const ParseResult& result, uint32_t now_ms);
+    /// Store registers from any confirmed source (e.g. an acknowledged write)
+    size_t store(ModbusFunctionCode func, uint16_t start, const uint16_t* values, size_t count,
+                 const uint8_t* serial, uint32_t now_ms);
+    /// Drop a range (e.g. after a write); returns registers dropped
+    size_t invalidate(ModbusFunctionCode func, uint16_t start, uint16_t count);
+    /// Drop everything; returns registers dropped
+    size_t clear();
+    /// Set the span of both tables (rounded down to 32, clamped); returns registers dropped
+    size_t resize(uint16_t registers_per_table);
+
+    // ========== Lookup ==========
+    /// Age of the oldest register in the range; false unless all are valid
+    bool range_age(ModbusFunctionCode func, uint16_t start, uint16_t count, uint32_t now_ms,
+                   uint32_t& age_ms) const;
+    /// Build the inverter read response for a range that range_age() accepted
+    bool build_read_response(std::vector<uint8_t>& frame, ModbusFunctionCode func,
+                             uint16_t start, uint16_t count) const;
+
+    // ========== Status ==========
+    size_t valid_count() const;
+    uint16_t registers_per_table() const { return registers_; }
+    size_t capacity() const { return 2 * static_cast<size_t>(registers_); }
+    /// Heap held by tables spanning @p registers_per_table registers
+    static constexpr size_t heap_bytes(uint16_t registers_per_table) {
+        return registers_per_table * BYTES_PER_REGISTER + 2 * (registers_per_table / 32) * 4;
+    }
+    void for_each_run(uint32_t now_ms, const RunCallback& callback) const;
+
+  private:
+    struct Table {
+        std::vector<uint16_t> values;
+        std::vector<uint32_t> stored_ms;
+        std::vector<uint32_t> valid; // One bit per register
+
+        bool is_valid(uint16_t reg) const { return (valid[reg >> 5] >> (reg & 31)) & 1u; }
+    };
+
+    Table* table_for(ModbusFunctionCode func);
+    const Table* table_for(ModbusFunctionCode func) const;
+    bool in_range(uint16_t start, uint16_t count) const;
+    static size_t resize_table(Table& table, uint16_t registers);
+
+    Table input_;
+    Table holding_;
+    uint16_t registers_ = 0; // Current span of each table
+    uint8_t serial_[MODBUS_SERIAL_NUMBER_LENGTH]; // Inverter serial of the latest store
+};
@@ -20,6 +20,12 @@
 
 static const char* TAG = "rs485";
 
+// Serial probe sent before any serial is known: fully built at compile time
+static constexpr InverterFrames::RequestFrame SERIAL_PROBE_FRAME =
+    InverterFrames::zero_serial_read_request(ModbusFunctionCode::READ_INPUT,
+                                             MODBUS_INVERTER_SN_START_REG,
+                                             MODBUS_INVERTER_SN_REG_COUNT);
+
 // ============================================================================
 // SECTION 1: Initialization
 // ============================================================================
@@ -45,47 +51,37 @@ const char* RS485Manager::function_code_to_string(ModbusFunctionCode func) {
 }
 
 bool RS485Manager::is_bus_busy() const {
+    return bus_busy_reason() != nullptr;
+}
+
+const char* RS485Manager::bus_busy_reason() const {
     // (1) Idle-tail timer: refreshed on every foreign frame. Keeps the bus "busy"
     //     until the line has been quiet for RS485_FOREIGN_IDLE_TAIL_MS, which
     //     bridges the foreign request->response turnaround so we never transmit
     //     into the gap and clobber the inverter's reply to the other master.
     if ((int32_t) (bus_busy_until_ms_ - millis()) > 0)
-        return true;
+        return "foreign traffic idle tail";
     // (2) Instant carrier sense: bytes are arriving on the line right now (a frame
     //     is mid-assembly). Closes the window between the first foreign byte and
     //     the moment the frame is classified (one inter-frame delay later).
-    if (!rx_buffer_.empty() && (millis() - last_rx_time_) <= MODBUS_INTER_FRAME_DELAY_MS)
-        return true;
-    return false;
+    if (!rx_buffer_.empty() && (millis() - port_->last_rx_ms()) <= MODBUS_INTER_FRAME_DELAY_MS)
+        return "frame arriving";
+    // (3) Bytes received by the UART but not pulled into rx_buffer_ yet.
+    if (port_->available() > 0)
+        return "unread RX bytes";
+    // (4) Post-timeout quiet time: a late reply may still be on its way.
+    if (timeout_quiet_)
+        return "post-timeout quiet time";
+    return nullptr;
 }
 
-void RS485Manager::begin(HardwareSerial& serial, int8_t tx_pin, int8_t rx_pin, int8_t de_pin,
-                         uint32_t baud_rate) {
-    serial_ = &serial;
-    de_pin_ = de_pin;
-
+void RS485Manager::begin(RS485Port& port) {
     LOGI(TAG, "Initializing RS485 Manager");
-    LOGI(TAG, "  TX Pin: GPIO%d", tx_pin);
-    LOGI(TAG, "  RX Pin: GPIO%d", rx_pin);
-    if (de_pin >= 0) {
-        LOGI(TAG, "  DE/RE Pin: GPIO%d", de_pin);
-    }
-    LOGI(TAG, "  Baud Rate: %d", baud_rate);
-
-    // A 125-register Lux response is ~267 bytes, so the default UART ring
-    // can overflow if the main loop is busy for a single large frame.
-    serial_->setRxBufferSize(RS485_UART_RX_BUFFER_SIZE);
+    port_ = &port;
 
-    // Initialize UART with short timeout to avoid blocking
-    serial_->begin(baud_rate, SERIAL_8N1, rx_pin, tx_pin);
-    serial_->setTimeout(15);
     rx_buffer_.reserve(MODBUS_MAX_RX_BUFFER_SIZE);
-
-    // Initialize DE/RE pin (receive mode by default)
-    if (de_pin_ >= 0) {
-        pinMode(de_pin_, OUTPUT);
-        digitalWrite(de_pin_, LOW);
-    }
+    tx_packet_.reserve(MODBUS_MAX_FRAME_SIZE);
+    last_raw_response_.reserve(MODBUS_MAX_FRAME_SIZE);
 
     initialized_ = true;
     serial_probe_backoff_ms_ = RS485_PROBE_BACKOFF_BASE_MS;
@@ -99,7 +95,8 @@ void RS485Manager::begin(HardwareSerial& serial, int8_t tx_pin, int8_t rx_pin, i
 // ============================================================================
 
 void RS485Manager::probe_inverter_serial() {
-    request_inverter_serial_probe();
+    // Called from command/UI tasks; the RS485 owner task picks it up in loop()
+    probe_requested_ = true;
 }
 
 void RS485Manager::request_inverter_serial_probe() {
@@ -123,10 +120,12 @@ void RS485Manager::request_inverter_serial_probe() {
 
     inverter_link_ok_ = false;
 
-    std::vector<uint8_t> packet;
-    if (!InverterProtocol::create_read_request(packet, ModbusFunctionCode::READ_INPUT,
-                                               MODBUS_INVERTER_SN_START_REG,
-                                               MODBUS_INVERTER_SN_REG_COUNT, serial_number_)) {
+    std::vector<uint8_t>& packet = tx_packet_;
+    if (serial_number_.length() == 0) {
+        packet.assign(SERIAL_PROBE_FRAME.begin(), SERIAL_PROBE_FRAME.end());
+    } else if (!InverterProtocol::create_read_request(
+                   packet, request_template_, ModbusFunctionCode::READ_INPUT,
+                   MODBUS_INVERTER_SN_START_REG, MODBUS_INVERTER_SN_REG_COUNT)) {
         LOGE(TAG, "Failed to build inverter serial probe request");
         return;
     }
@@ -155,12 +154,27 @@ void RS485Manager::loop() {
     // send_read_request()/send_write_request() and the probe, so we never transmit
     // on a busy bus.
 
+    if (probe_requested_.exchange(false)) {
+        request_inverter_serial_probe();
+    }
+
+    // Post-timeout quiet time over: the bus can be used again
+    if (timeout_quiet_ && (int32_t) (millis() - timeout_quiet_until_ms_) >= 0) {
+        timeout_quiet_ = false;
+    }
+
     // Auto-probe when link is down
     if (!inverter_link_ok_ && !serial_probe_pending_ && !waiting_response_ &&
         millis() >= next_serial_probe_ms_) {
         request_inverter_serial_probe();
     }
 
+    // TX done: the response timeout runs from the real end of transmission
+    if (tx_pending_ && !port_->tx_busy()) {
+        tx_pending_ = false;
+        last_tx_time_ = millis();
+    }
+
     // Process incoming data
     process_incoming_data();
 
@@ -170,6 +184,14 @@ void RS485Manager::loop() {
     }
 }
 
+bool RS485Manager::wait_for_activity(uint32_t timeout_ms) {
+    if (!initialized_) {
+        vTaskDelay(pdMS_TO_TICKS(timeout_ms));
+        return false;
+    }
+    return port_->wait_for_rx(timeout_ms);
+}
+
 // ============================================================================
 // SECTION 4: Request Sending
 // ============================================================================
@@ -177,9 +199,8 @@ void RS485Manager::loop() {
 bool RS485Manager::send_read_request(ModbusFunctionCode func, uint16_t start_reg, uint16_t count) {
     // ========== BUS BUSY CHECK ==========
     // If external device is using the bus, wait for it to finish
-    if (is_bus_busy()) {
-        LOGI(TAG, "Cannot send request now: RS485_BUS_BUSY for %lums (external device active)",
-             bus_busy_until_ms_ - millis());
+    if (const char* busy = bus_busy_reason()) {
+        LOGI(TAG, "Cannot send request now: RS485_BUS_BUSY (%s)", busy);
         return false;
     }
     // ========== END BUS BUSY CHECK ==========
@@ -200,12 +221,13 @@ bool RS485Manager::send_read_request(ModbusFunctionCode func, uint16_t start_reg
 
     if (!inverter_link_ok_ && !serial_probe_pending_) {
         LOGW(TAG, "Inverter link down, re-probing serial before processing requests");
-        probe_inverter_serial();
+        request_inverter_serial_probe();
         return false;
     }
 
-    std::vector<uint8_t> packet;
-    if (!InverterProtocol::create_read_request(packet, func, start_reg, count, serial_number_)) {
+    std::vector<uint8_t>& packet = tx_packet_;
+    if (!InverterProtocol::create_read_request(packet, request_template_, func, start_reg,
+                                               count)) {
         return false;
     }
 
@@ -219,13 +241,11 @@ bool RS485Manager::send_read_request(ModbusFunctionCode func, uint16_t start_reg
     return true;
 }
 
-bool RS485Manager::send_write_request(uint16_t start_reg, const std::vector<uint16_t>& values) {
+bool RS485Manager::send_write_request(uint16_t start_reg, const uint16_t* values, size_t count) {
     // ========== BUS BUSY CHECK ==========
     // If external device is using the bus, wait for it to finish
-    if (is_bus_busy()) {
-        LOGW(TAG,
-             "⚠ Cannot send write request now: RS485_BUS_BUSY for %lums (external device active)",
-             bus_busy_until_ms_ - millis());
+    if (const char* busy = bus_busy_reason()) {
+        LOGW(TAG, "⚠ Cannot send write request now: RS485_BUS_BUSY (%s)", busy);
         return false;
     }
     // ========== END BUS BUSY CHECK ==========
@@ -246,37 +266,38 @@ bool RS485Manager::send_write_request(uint16_t start_reg, const std::vector<uint
 
     if (!inverter_link_ok_ && !serial_probe_pending_) {
         LOGW(TAG, "Inverter link down, re-probing serial before processing requests");
-        probe_inverter_serial();
+        request_inverter_serial_probe();
         return false;
     }
 
-    std::vector<uint8_t> packet;
-    if (!InverterProtocol::create_write_request(packet, start_reg, values, serial_number_)) {
+    std::vector<uint8_t>& packet = tx_packet_;
+    if (!InverterProtocol::create_write_request(packet, request_template_, start_reg, values,
+                                                count)) {
         return false;
     }
 
     // Log write request (avoid String concat to keep the TX hot path out of the heap)
-    const char* func_name = (values.size() == 1) ? "WRITE_SINGLE" : "WRITE_MULTI";
-    if (values.size() == 1) {
+    const char* func_name = (count == 1) ? "WRITE_SINGLE" : "WRITE_MULTI";
+    if (count == 1) {
         LOGI(TAG, "→ TX: %s reg=%d val=0x%04X (%d)", func_name, start_reg, values[0], values[0]);
     } else {
         char preview[64];
-        size_t shown = std::min((size_t) 3, values.size());
+        size_t shown = std::min((size_t) 3, count);
         int n = snprintf(preview, sizeof(preview), "[0x%X", values[0]);
         for (size_t i = 1; i < shown && n >= 0 && (size_t) n < sizeof(preview); i++) {
             n += snprintf(preview + n, sizeof(preview) - n, ", 0x%X", values[i]);
         }
         if (n >= 0 && (size_t) n < sizeof(preview)) {
-            snprintf(preview + n, sizeof(preview) - n, "%s", values.size() > 3 ? "...]" : "]");
+            snprintf(preview + n, sizeof(preview) - n, "%s", count > 3 ? "...]" : "]");
         }
         LOGI(TAG, "→ TX: %s regs=%d-%d (%d vals) %s", func_name, start_reg,
-             start_reg + values.size() - 1, values.size(), preview);
+             start_reg + count - 1, count, preview);
     }
 
     expected_function_code_ =
-        (values.size() == 1) ? ModbusFunctionCode::WRITE_SINGLE : ModbusFunctionCode::WRITE_MULTI;
+        (count == 1) ? ModbusFunctionCode::WRITE_SINGLE : ModbusFunctionCode::WRITE_MULTI;
     expected_start_reg_ = start_reg;
-    expected_register_count_ = values.size();
+    expected_register_count_ = count;
     send_packet(packet);
     return true;
 }
@@ -287,28 +308,17 @@ void RS485Manager::send_packet(const std::vector<uint8_t>& packet) {
 
     // Drop stale bytes before starting a new request. The bridge serializes
     // requests, so any RX data here belongs to previous traffic/noise.
-    while (serial_->available() > 0) {
-        serial_->read();
-    }
+    port_->discard_input();
     rx_buffer_.clear();
+    rx_idle_pending_ = false;
+    assembler_ = ResponseAssembler();
 
-    // Switch to transmit mode
-    if (de_pin_ >= 0) {
-        digitalWrite(de_pin_, HIGH);
-        delayMicroseconds(10);
-    }
-
-    // Send packet
-    serial_->write(packet.data(), packet.size());
-    serial_->flush();
-
-    // Switch back to receive mode
-    if (de_pin_ >= 0) {
-        delayMicroseconds(10);
-        digitalWrite(de_pin_, LOW);
-    }
+    // Returns as soon as the frame is queued; loop() restarts the response
+    // timeout once the transmitter reports it has gone out.
+    port_->write(packet.data(), packet.size());
 
     last_tx_time_ = millis();
+    tx_pending_ = true;
     waiting_response_ = true;
     total_requests_++;
 }
@@ -352,58 +362,175 @@ bool RS485Manager::should_ignore_packet(const std::vector<uint8_t>& data) {
 }
 
 void RS485Manager::process_incoming_data() {
+    // Sample the idle boundary before reading: every byte up to that boundary is
+    // already in the UART ring, so the read below cannot truncate the burst.
+    if (port_->take_rx_boundary()) {
+        rx_idle_pending_ = true;
+    }
+
     // Read available bytes
-    const int available = serial_->available();
+    const size_t available = port_->available();
     if (available > 0) {
         const size_t old_size = rx_buffer_.size();
         rx_buffer_.resize(old_size + available);
-        const size_t bytes_read = serial_->readBytes(&rx_buffer_[old_size], available);
+        const size_t bytes_read = port_->read(&rx_buffer_[old_size], available);
         rx_buffer_.resize(old_size + bytes_read);
-
-        if (bytes_read > 0) {
-            last_rx_time_ = millis();
-        }
     }
 
     // Discard buffer if too large (loss of sync)
     if (rx_buffer_.size() > MODBUS_MAX_RX_BUFFER_SIZE) {
         LOGW(TAG, "RX buffer overflow (%d bytes), discarding", rx_buffer_.size());
         rx_buffer_.clear();
+        rx_idle_pending_ = false;
+        assembler_ = ResponseAssembler();
         waiting_response_ = false;
         return;
     }
 
-    // Wait for inter-frame delay before processing
-    if (rx_buffer_.empty() || (millis() - last_rx_time_) <= MODBUS_INTER_FRAME_DELAY_MS) {
+    if (rx_buffer_.empty()) {
+        return;
+    }
+
+    // Our response is complete and CRC-valid: no need to wait for line silence
+    if (waiting_response_ && assemble_expected_response()) {
+        early_completions_++;
+        handle_response(rx_buffer_.data(), rx_buffer_.size());
+        end_rx_transaction();
+        return;
+    }
+
+    // Foreign traffic is classified as soon as the UART reports the line idle.
+    // While awaiting our response, wait the full inter-frame delay so traffic
+    // around our reply is merged into one buffer (early completion covers the
+    // common case of our response arriving on its own).
+    const bool line_idle = rx_idle_pending_ && !waiting_response_;
+    if (!line_idle && (millis() - port_->last_rx_ms()) <= MODBUS_INTER_FRAME_DELAY_MS) {
         return;
     }
 
     // Try to process the accumulated data
     if (should_ignore_packet(rx_buffer_)) {
         rx_buffer_.clear();
+        rx_idle_pending_ = false;
+        assembler_ = ResponseAssembler();
         return;
     }
 
     const bool starts_with_response =
         InverterProtocol::is_valid_response(rx_buffer_.data(), rx_buffer_.size());
-    bool contains_response = starts_with_response;
-    if (!contains_response) {
-        std::vector<FrameInfo> frames = InverterProtocol::parse_all_frames(rx_buffer_);
-        contains_response = std::any_of(frames.begin(), frames.end(),
-                                        [](const FrameInfo& frame) { return !frame.is_request; });
-    }
+    const bool contains_response =
+        starts_with_response || InverterProtocol::contains_response(
+                                    rx_buffer_.data(), rx_buffer_.size(), response_serial_filter());
 
     if (contains_response) {
-        handle_response(rx_buffer_);
+        handle_response(rx_buffer_.data(), rx_buffer_.size());
     } else {
         handle_invalid_frame();
     }
 
+    end_rx_transaction();
+}
+
+void RS485Manager::end_rx_transaction() {
     rx_buffer_.clear();
+    rx_idle_pending_ = false;
+    assembler_ = ResponseAssembler();
     waiting_response_ = false;
     last_transaction_end_ms_ = millis();
 }
 
+/**
+ * @brief Incrementally look for our complete response in the RX buffer
+ *
+ * Called on every loop while waiting. Finds [0x01][expected func], takes
+ * the frame length from the header (byte count for reads) and folds only
+ * newly arrived bytes into the CRC, so the transaction can complete on the
+ * last CRC byte instead of after MODBUS_INTER_FRAME_DELAY_MS of silence.
+ * Exceptions and anything unexpected are left to the silence-based path.
+ */
+bool RS485Manager::assemble_expected_response() {
+    static constexpr size_t READ_HEADER_SIZE = InverterProtocolOffsets::COUNT_OR_VALUE + 1;
+
+    ResponseAssembler& a = assembler_;
+    const uint8_t* data = rx_buffer_.data();
+    const size_t size = rx_buffer_.size();
+    const uint8_t func = static_cast<uint8_t>(expected_function_code_);
+
+    while (true) {
+        if (!a.has_candidate) {
+            while (a.scan_offset + 2 <= size &&
+                   !(data[a.scan_offset] == MODBUS_DEVICE_ADDR_RESPONSE &&
+                     data[a.scan_offset + 1] == func)) {
+                a.scan_offset++;
+            }
+            if (a.scan_offset + 2 > size) {
+                return false;
+            }
+            a.has_candidate = true;
+            a.frame_length = 0;
+            a.crc = CRC16::init();
+            a.crc_end = a.scan_offset;
+        }
+
+        const size_t start = a.scan_offset;
+        const uint8_t* frame = data + start;
+
+        if (a.frame_length == 0) {
+            a.frame_length = InverterProtocol::calculate_frame_length(frame, size - start,
+                                                                      response_serial_filter());
+            if (a.frame_length == 0) {
+                if (size - start < READ_HEADER_SIZE) {
+                    return false; // Byte count not received yet
+                }
+                a.has_candidate = false;
+                a.scan_offset++;
+                continue;
+            }
+        }
+
+        // Fold only the bytes that arrived since the last call
+        const size_t crc_offset = start + a.frame_length - 2;
+        const size_t fold_end = std::min(size, crc_offset);
+        if (fold_end > a.crc_end) {
+            a.crc = CRC16::update(a.crc, data + a.crc_end, fold_end - a.crc_end);
+            a.crc_end = fold_end;
+        }
+
+        if (size < start + a.frame_length) {
+            return false;
+        }
+
+        const uint16_t received_crc =
+            InverterProtocol::parse_little_endian_uint16(data, crc_offset);
+        const bool crc_ok = CRC16::finalize(a.crc) == received_crc;
+        if (crc_ok && is_expected_response_header(frame)) {
+            return true;
+        }
+
+        // Not ours: skip a whole CRC-valid frame, otherwise resync one byte on
+        a.scan_offset = crc_ok ? start + a.frame_length : start + 1;
+        a.has_candidate = false;
+    }
+}
+
+bool RS485Manager::is_expected_response_header(const uint8_t* frame) const {
+    if (InverterProtocol::parse_little_endian_uint16(frame, InverterProtocolOffsets::START_REG) !=
+        expected_start_reg_) {
+        return false;
+    }
+
+    switch (expected_function_code_) {
+        case ModbusFunctionCode::READ_HOLDING:
+        case ModbusFunctionCode::READ_INPUT:
+            return frame[InverterProtocolOffsets::COUNT_OR_VALUE] / 2 == expected_register_count_;
+        case ModbusFunctionCode::WRITE_MULTI:
+            return InverterProtocol::parse_little_endian_uint16(
+                       frame, InverterProtocolOffsets::COUNT_OR_VALUE) == expected_register_count_;
+        default:
+            return true;
+    }
+}
+
 void RS485Manager::handle_invalid_frame() {
     LOGW(TAG, "RX [%d bytes] - INVALID: %s", rx_buffer_.size(),
          InverterProtocol::format_hex(rx_buffer_.data(), rx_buffer_.size()).c_str());
@@ -412,21 +539,23 @@ void RS485Manager::handle_invalid_frame() {
     last_result_.success = false;
     last_result_.function_code = expected_function_code_;
     last_result_.start_address = expected_start_reg_;
-    last_result_.error_message = "Invalid response frame";
+    last_result_.error = ParseError::INVALID_FRAME;
     last_raw_response_ = rx_buffer_;
 
-    // Try to recover by finding valid response start (0x01)
-    for (size_t i = 1; i < rx_buffer_.size() - 1; i++) {
-        if (rx_buffer_[i] == 0x01) {
-            uint8_t func = rx_buffer_[i + 1];
-            bool valid_func = (func == 0x03 || func == 0x04 || func == 0x06 || func == 0x10 ||
-                               (func >= 0x83 && func <= 0x90));
-            if (valid_func) {
-                LOGW(TAG, "Found potential valid response at offset %d, discarding %d bytes", i, i);
-                rx_buffer_.erase(rx_buffer_.begin(), rx_buffer_.begin() + i);
-                return;
-            }
-        }
+    // Same pre-filter as the frame scanner: report where a frame seems to start,
+    // ignoring the learned serial (a mismatch may mean the inverter changed).
+    const size_t candidate =
+        InverterProtocol::find_frame_candidate(rx_buffer_.data(), rx_buffer_.size(), 0);
+    if (candidate < rx_buffer_.size()) {
+        const size_t frame_len = InverterProtocol::calculate_frame_length(
+            rx_buffer_.data() + candidate, rx_buffer_.size() - candidate);
+        LOGW(TAG, "Potential frame at offset %d (%d of %d bytes)", candidate,
+             rx_buffer_.size() - candidate, frame_len);
+    }
+
+    if (response_serial_known_) {
+        LOGW(TAG, "Dropping learned response serial filter");
+        response_serial_known_ = false;
     }
 
     failed_responses_++;
@@ -439,55 +568,66 @@ void RS485Manager::handle_invalid_frame() {
 // SECTION 6: Response Processing
 // ============================================================================
 
-void RS485Manager::handle_response(const std::vector<uint8_t>& data) {
-    LOGD(TAG, "   RX raw [%d bytes]: %s", data.size(),
-         InverterProtocol::format_hex(data.data(), data.size()).c_str());
-
-    // Parse all frames (handles concatenated traffic from multiple masters)
-    std::vector<FrameInfo> frames = InverterProtocol::parse_all_frames(data);
+void RS485Manager::handle_response(const uint8_t* data, size_t length) {
+    LOGD(TAG, "   RX raw [%d bytes]: %s", length, InverterProtocol::format_hex(data, length).c_str());
+
+    // Walk all frames (handles concatenated traffic from multiple masters) without
+    // decoding registers; only the frame matching our request is fully parsed.
+    FrameIterator frames(data, length, response_serial_filter());
+    FrameView frame;
+    FrameView our_frame;
+    bool found = false;
+    size_t req_count = 0, resp_count = 0;
+
+    while (frames.next(frame)) {
+        frame.is_request() ? req_count++ : resp_count++;
+        LOGD(TAG, "Frame: %s at offset %d, len=%d, func=0x%02X, start=%d, regs=%d%s",
+             frame.is_request() ? "REQUEST" : "RESPONSE", frame.offset, frame.length,
+             frame.function_code, frame.start_address, frame.register_count,
+             frame.crc_valid ? "" : " (CRC mismatch)");
+
+        if (!found && InverterProtocol::is_matching_response(frame, expected_function_code_,
+                                                             expected_start_reg_,
+                                                             expected_register_count_)) {
+            our_frame = frame;
+            found = true;
+        }
+    }
 
-    if (frames.empty()) {
+    if (req_count + resp_count == 0) {
         last_result_.success = false;
-        last_result_.error_message = "No valid frames found in response";
-        last_raw_response_ = data;
-        LOGW(TAG, "No valid frames found in %d bytes", data.size());
+        last_result_.error = ParseError::NO_FRAMES;
+        last_raw_response_.assign(data, data + length);
+        LOGW(TAG, "No valid frames found in %d bytes", length);
+        response_serial_known_ = false; // Relearn in case the inverter changed
         failed_responses_++;
         return;
     }
 
     // Log summary if multiple frames
-    if (frames.size() > 1) {
-        size_t req_count = 0, resp_count = 0;
-        for (const auto& f : frames) {
-            f.is_request ? req_count++ : resp_count++;
-        }
-        LOGI(TAG, "Found %d frames: %d requests, %d responses", frames.size(), req_count,
+    if (req_count + resp_count > 1) {
+        LOGI(TAG, "Found %d frames: %d requests, %d responses", req_count + resp_count, req_count,
              resp_count);
     }
 
-    // Find our response
-    int idx = InverterProtocol::find_matching_response_index(
-        frames, expected_function_code_, expected_start_reg_, expected_register_count_);
-
-    if (idx >= 0) {
-        const FrameInfo& our_frame = frames[idx];
+    if (found) {
         if (our_frame.offset > 0) {
             LOGI(TAG, "Found our response at offset %d (skipped %d bytes)", our_frame.offset,
                  our_frame.offset);
         }
-        last_result_ = our_frame.result;
-        last_raw_response_.assign(data.data() + our_frame.offset,
-                                  data.data() + our_frame.offset + our_frame.length);
+        const uint8_t* frame_start = data + our_frame.offset;
+        last_result_ = InverterProtocol::parse_response(frame_start, our_frame.length);
+        last_raw_response_.assign(frame_start, frame_start + our_frame.length);
     } else {
-        handle_response_not_found(frames);
+        handle_response_not_found(data, length);
     }
 
-    process_response_result(data);
+    process_response_result();
 }
 
-void RS485Manager::handle_response_not_found(const std::vector<FrameInfo>& frames) {
+void RS485Manager::handle_response_not_found(const uint8_t* data, size_t length) {
     last_result_.success = false;
-    last_result_.error_message = "Response not found (traffic from other master?)";
+    last_result_.error = ParseError::RESPONSE_NOT_FOUND;
     last_result_.function_code = expected_function_code_;
     last_result_.start_address = expected_start_reg_;
     last_result_.register_count = expected_register_count_;
@@ -496,16 +636,18 @@ void RS485Manager::handle_response_not_found(const std::vector<FrameInfo>& frame
          static_cast<uint8_t>(expected_function_code_), expected_start_reg_,
          expected_register_count_);
 
-    for (const auto& f : frames) {
-        if (!f.is_request) {
-            LOGW(TAG, "   Found: func=0x%02X start=%d count=%d (not ours)",
-                 static_cast<uint8_t>(f.result.function_code), f.result.start_address,
-                 f.result.register_count);
+    FrameIterator frames(data, length, response_serial_filter());
+    FrameView frame;
+    while (frames.next(frame)) {
+        if (!frame.is_request()) {
+            LOGW(TAG, "   Found: func=0x%02X start=%d count=%d (not ours%s)", frame.function_code,
+                 frame.start_address, frame.register_count,
+                 frame.crc_valid ? "" : ", CRC mismatch");
         }
     }
 }
 
-void RS485Manager::process_response_result(const std::vector<uint8_t>& data) {
+void RS485Manager::process_response_result() {
     const bool is_serial_probe = serial_probe_pending_ &&
                                  last_result_.function_code == ModbusFunctionCode::READ_INPUT &&
                                  last_result_.start_address == MODBUS_INVERTER_SN_START_REG &&
@@ -514,16 +656,21 @@ void RS485Manager::process_response_result(const std::vector<uint8_t>& data) {
     if (last_result_.success) {
         log_successful_response();
 
+        // Later scans only accept response frames carrying this serial
+        memcpy(response_serial_, last_result_.serial_number, MODBUS_SERIAL_NUMBER_LENGTH);
+        response_serial_known_ = true;
+
         if (is_serial_probe) {
-            extract_inverter_serial(data);
+            extract_inverter_serial(last_raw_response_);
         }
         successful_responses_++;
     } else {
-        LOGE(TAG, "← RX: FAIL | %s", last_result_.error_message.c_str());
+        const char* error = InverterProtocol::error_to_string(last_result_.error);
+        LOGE(TAG, "← RX: FAIL | %s", error);
         failed_responses_++;
 
         if (is_serial_probe) {
-            handle_probe_failure(last_result_.error_message.c_str());
+            handle_probe_failure(error);
         }
     }
 
@@ -559,17 +706,20 @@ void RS485Manager::log_successful_response() {
     LOGI(TAG, "← RX: %s OK | %d regs%s", func_name, last_result_.register_count, value_preview);
 }
 
-void RS485Manager::extract_inverter_serial(const std::vector<uint8_t>& data) {
+void RS485Manager::extract_inverter_serial(const std::vector<uint8_t>& frame) {
     const size_t data_offset = InverterProtocolOffsets::COUNT_OR_VALUE + 1;
-    const size_t available = (data.size() > data_offset) ? data.size() - data_offset : 0;
+    const size_t available = (frame.size() > data_offset) ? frame.size() - data_offset : 0;
 
     uint8_t serial_bytes[MODBUS_SERIAL_NUMBER_LENGTH] = {0};
     size_t copy_len = std::min(available, static_cast<size_t>(MODBUS_SERIAL_NUMBER_LENGTH));
-    memcpy(serial_bytes, &data[data_offset], copy_len);
+    if (copy_len > 0) {
+        memcpy(serial_bytes, &frame[data_offset], copy_len);
+    }
 
     inverter_serial_detected_ =
         SerialUtils::format_serial(serial_bytes, MODBUS_SERIAL_NUMBER_LENGTH);
     serial_number_ = inverter_serial_detected_;
+    request_template_.set_serial(serial_number_);
 
     LOGI(TAG, "Inverter serial (regs %d-%d): %s", MODBUS_INVERTER_SN_START_REG,
          MODBUS_INVERTER_SN_START_REG + MODBUS_INVERTER_SN_REG_COUNT - 1,
@@ -598,15 +748,19 @@ void RS485Manager::handle_timeout() {
          successful_responses_);
 
     waiting_response_ = false;
+    tx_pending_ = false;
     last_transaction_end_ms_ = millis();
     last_result_.success = false;
-    last_result_.error_message = "Timeout";
+    last_result_.error = ParseError::TIMEOUT;
     last_raw_response_.clear();
 
+    // Leave the bus alone briefly without blocking the worker; loop() ends it
+    timeout_quiet_until_ms_ = millis() + RS485_TIMEOUT_QUIET_MS;
+    timeout_quiet_ = true;
+
     if (serial_probe_pending_) {
         handle_probe_failure("timeout");
     }
-    vTaskDelay(pdMS_TO_TICKS(10));
 }
 
 void RS485Manager::handle_probe_failure(const char* reason) {
@@ -12,8 +12,9 @@
 #pragma once
 
 #include "inverter_protocol.h"
+#include "rs485_port_interface.h"
 
-#include <HardwareSerial.h>
+#include <atomic>
 
 // Note: RS485_PROBE_BACKOFF_BASE_MS and RS485_PROBE_BACKOFF_MAX_MS are defined in config.h
 
@@ -36,17 +37,20 @@ class RS485Manager {
     static RS485Manager& getInstance();
 
     // ========== Lifecycle ==========
-    void begin(HardwareSerial& serial, int8_t tx_pin, int8_t rx_pin, int8_t de_pin = -1,
-               uint32_t baud_rate = 19200);
+    void begin(RS485Port& port); // UartRS485Port on the ESP32, a fake on the host
     void loop();
-    void probe_inverter_serial();
+    void probe_inverter_serial(); // Safe from any task; runs on the next loop()
+    bool wait_for_activity(uint32_t timeout_ms);
 
     // ========== Communication ==========
     bool send_read_request(ModbusFunctionCode func, uint16_t start_reg, uint16_t count);
-    bool send_write_request(uint16_t start_reg, const std::vector<uint16_t>& values);
+    bool send_write_request(uint16_t start_reg, const uint16_t* values, size_t count);
 
     // ========== Configuration ==========
-    void set_serial_number(const String& serial) { serial_number_ = serial; }
+    void set_serial_number(const String& serial) {
+        serial_number_ = serial;
+        request_template_.set_serial(serial);
+    }
     void set_response_timeout(uint32_t timeout_ms) { response_timeout_ms_ = timeout_ms; }
 
     // ========== Status ==========
@@ -64,6 +68,7 @@ class RS485Manager {
     uint32_t get_timeout_count() const { return timeout_count_; }
     uint32_t get_ignored_packets() const { return ignored_packets_; }
     uint32_t get_external_requests_detected() const { return external_requests_detected_; }
+    uint32_t get_early_completions() const { return early_completions_; }
 
   private:
     RS485Manager() = default;
@@ -78,14 +83,17 @@ class RS485Manager {
     // ========== Data Reception ==========
     void process_incoming_data();
     bool should_ignore_packet(const std::vector<uint8_t>& data);
+    bool assemble_expected_response();
+    bool is_expected_response_header(const uint8_t* frame) const;
+    void end_rx_transaction();
     void handle_invalid_frame();
 
     // ========== Response Processing ==========
-    void handle_response(const std::vector<uint8_t>& data);
-    void handle_response_not_found(const std::vector<FrameInfo>& frames);
-    void process_response_result(const std::vector<uint8_t>& data);
+    void handle_response(const uint8_t* data, size_t length);
+    void handle_response_not_found(const uint8_t* data, size_t length);
+    void process_response_result();
     void log_successful_response();
-    void extract_inverter_serial(const std::vector<uint8_t>& data);
+    void extract_inverter_serial(const std::vector<uint8_t>& frame);
 
     // ========== Timeout & Error Handling ==========
     void handle_timeout();
@@ -94,14 +102,18 @@ class RS485Manager {
     // ========== Utilities ==========
     static const char* function_code_to_string(ModbusFunctionCode func);
     bool is_bus_busy() const;
+    const char* bus_busy_reason() const; // nullptr when the bus is free
+    const uint8_t* response_serial_filter() const {
+        return response_serial_known_ ? response_serial_ : nullptr;
+    }
 
     // ========== Hardware ==========
-    HardwareSerial* serial_ = nullptr;
-    int8_t de_pin_ = -1;
+    RS485Port* port_ = nullptr;
     bool initialized_ = false;
 
     // ========== Configuration ==========
     String serial_number_;
+    RequestTemplate request_template_; // Prefix/CRC state for serial_number_
     uint32_t response_timeout_ms_ = MODBUS_RESPONSE_TIMEOUT_MS;
 
     // ========== State ==========
@@ -109,18 +121,37 @@ class RS485Manager {
     ModbusFunctionCode expected_function_code_ = ModbusFunctionCode::READ_INPUT;
     uint16_t expected_start_reg_ = 0;
     uint16_t expected_register_count_ = 0;
-    unsigned long last_tx_time_ = 0;
-    unsigned long last_rx_time_ = 0;
+    unsigned long last_tx_time_ = 0; // TX start, then TX end once the frame has gone out
+    bool tx_pending_ = false;        // Frame queued, transmitter not drained yet
+    bool rx_idle_pending_ = false; // UART reported an idle line after the buffered bytes
     unsigned long last_transaction_end_ms_ = 0;
+    uint32_t timeout_quiet_until_ms_ = 0; // Bus left alone until then after a timeout
+    bool timeout_quiet_ = false;
 
     // ========== Buffers ==========
+    // Reserved once in begin() so the TX/RX path does not allocate per request.
+    std::vector<uint8_t> tx_packet_;
     std::vector<uint8_t> rx_buffer_;
     std::vector<uint8_t> last_raw_response_;
     ParseResult last_result_;
 
+    // ========== Early Completion ==========
+    // Progress of assemble_expected_response() over rx_buffer_ (reset with it)
+    struct ResponseAssembler {
+        size_t scan_offset = 0;  // Candidate frame start
+        size_t frame_length = 0; // 0 = not known yet
+        size_t crc_end = 0;      // Bytes folded into crc
+        uint16_t crc = CRC16::INITIAL_VALUE;
+        bool has_candidate = false;
+    };
+    ResponseAssembler assembler_;
+
     // ========== Inverter State ==========
     String inverter_serial_detected_;
+    uint8_t response_serial_[MODBUS_SERIAL_NUMBER_LENGTH] = {0}; // Serial seen in responses
+    bool response_serial_known_ = false;
     bool serial_probe_pending_ = false;
+    std::atomic<bool> probe_requested_{false}; // Set by probe_inverter_serial()
     bool inverter_link_ok_ = false;
     uint32_t next_serial_probe_ms_ = 0;
     uint32_t serial_probe_backoff_ms_ = 0;
@@ -131,6 +162,7 @@ class RS485Manager {
     uint32_t failed_responses_ = 0;
     uint32_t timeout_count_ = 0;
     uint32_t ignored_packets_ = 0;
+    uint32_t early_completions_ = 0; // Responses completed before line silence
 
     uint32_t external_requests_detected_ = 0;
     uint32_t bus_busy_until_ms_ = 0;
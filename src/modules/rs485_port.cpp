@@ -0,0 +1,137 @@
+/**
+ * @file rs485_port.cpp
+ * @brief ESP32 UART implementation of RS485Port
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#include "rs485_port.h"
+
+#include "../config.h"
+#include "logger.h"
+
+static const char* TAG = "rs485";
+
+// HardwareSerial does not expose its UART number; the driver calls need it.
+static uart_port_t uart_port_of(const HardwareSerial& serial) {
+#if SOC_UART_NUM > 2
+    if (&serial == &Serial2) {
+        return 2;
+    }
+#endif
+    return &serial == &Serial1 ? 1 : 0;
+}
+
+void UartRS485Port::begin(HardwareSerial& serial, int8_t tx_pin, int8_t rx_pin, int8_t de_pin,
+                          uint32_t baud_rate) {
+    LOGI(TAG, "  TX Pin: GPIO%d", tx_pin);
+    LOGI(TAG, "  RX Pin: GPIO%d", rx_pin);
+    if (de_pin >= 0) {
+        LOGI(TAG, "  DE/RE Pin: GPIO%d (UART RTS, half-duplex)", de_pin);
+    }
+    LOGI(TAG, "  Baud Rate: %d", baud_rate);
+
+    serial_ = &serial;
+    uart_num_ = uart_port_of(serial);
+
+    if (rx_event_ == nullptr) {
+        rx_event_ = xSemaphoreCreateBinary();
+    }
+
+    // A 125-register Lux response is ~267 bytes, so the default UART ring
+    // can overflow if the consumer is busy for a single large frame.
+    serial_->setRxBufferSize(RS485_UART_RX_BUFFER_SIZE);
+    // A TX ring lets write() hand off even a 127-register write-multi at once
+    serial_->setTxBufferSize(RS485_UART_TX_BUFFER_SIZE);
+
+    // Short stream timeout: reads never ask for more than available()
+    serial_->begin(baud_rate, SERIAL_8N1, rx_pin, tx_pin);
+    serial_->setTimeout(15);
+
+    // Hardware RX timeout marks frame boundaries; the callback runs in the
+    // UART driver event task, only when the line has gone idle after data.
+    serial_->setRxTimeout(RS485_RX_IDLE_SYMBOLS);
+    serial_->onReceive([this]() { on_rx_idle(); }, true);
+
+    // DE/RE is driven by the UART as RTS: asserted only while bits shift out
+    if (de_pin >= 0) {
+        serial_->setPins(rx_pin, tx_pin, -1, de_pin);
+        if (!serial_->setMode(UART_MODE_RS485_HALF_DUPLEX)) {
+            LOGE(TAG, "UART%d: RS485 half-duplex mode not available", (int) uart_num_);
+        }
+    }
+}
+
+void UartRS485Port::on_rx_idle() {
+    // Everything buffered now belongs to the burst that just ended. Loading
+    // the consumed count first can only place the end too early, which makes
+    // read() treat the tail as fresh (the conservative choice).
+    const uint32_t consumed = rx_consumed_.load();
+    rx_boundary_end_.store(consumed + static_cast<uint32_t>(available()));
+    last_rx_ms_.store(millis());
+    rx_boundaries_.fetch_add(1);
+    xSemaphoreGive(rx_event_);
+}
+
+// ============================================================================
+// RX
+// ============================================================================
+
+size_t UartRS485Port::available() {
+    const int count = serial_->available();
+    return count > 0 ? static_cast<size_t>(count) : 0;
+}
+
+size_t UartRS485Port::read(uint8_t* dest, size_t max_length) {
+    const size_t bytes_read = serial_->readBytes(dest, max_length);
+    if (bytes_read == 0) {
+        return 0;
+    }
+
+    // Bytes up to the last idle boundary keep its timestamp, the accurate end
+    // of that burst; only bytes past it are mid-burst and as recent as "now".
+    // Independent of take_rx_boundary(), which callers may sample first.
+    const uint32_t consumed = rx_consumed_.fetch_add(bytes_read) + bytes_read;
+    if (static_cast<int32_t>(consumed - rx_boundary_end_.load()) > 0) {
+        last_rx_ms_.store(millis());
+    }
+    return bytes_read;
+}
+
+void UartRS485Port::discard_input() {
+    while (serial_->available() > 0) {
+        serial_->read();
+        rx_consumed_.fetch_add(1);
+    }
+    take_rx_boundary();
+    xSemaphoreTake(rx_event_, 0);
+}
+
+bool UartRS485Port::take_rx_boundary() {
+    const uint32_t boundaries = rx_boundaries_.load();
+    const bool pending = boundaries != rx_boundaries_taken_;
+    rx_boundaries_taken_ = boundaries;
+    return pending;
+}
+
+bool UartRS485Port::wait_for_rx(uint32_t timeout_ms) {
+    return xSemaphoreTake(rx_event_, pdMS_TO_TICKS(timeout_ms)) == pdTRUE;
+}
+
+// ============================================================================
+// TX
+// ============================================================================
+
+size_t UartRS485Port::write(const uint8_t* data, size_t length) {
+    const size_t written = serial_->write(data, length);
+    tx_pending_ = written > 0;
+    return written;
+}
+
+bool UartRS485Port::tx_busy() {
+    if (tx_pending_ && uart_wait_tx_done(uart_num_, 0) == ESP_OK) {
+        tx_pending_ = false;
+    }
+    return tx_pending_;
+}
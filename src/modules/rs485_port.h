@@ -0,0 +1,69 @@
+/**
+ * @file rs485_port.h
+ * @brief ESP32 UART implementation of the RS485Port interface
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include "rs485_port_interface.h"
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <driver/uart.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include <atomic>
+
+// ============================================================================
+// UartRS485Port Class
+// ============================================================================
+
+/**
+ * @brief RS485Port on an ESP32 UART with optional DE/RE pin
+ *
+ * RX is event driven: the UART hardware RX timeout (RS485_RX_IDLE_SYMBOLS
+ * character times of silence) raises a driver event, whose task records
+ * the line timestamp and the frame boundary and wakes any waiter. Bytes
+ * stay in the driver ring until read().
+ *
+ * TX is asynchronous: frames go to the driver TX ring and write() returns
+ * at once. With a DE/RE pin the UART runs in RS485 half-duplex mode and
+ * drives it as RTS, so no CPU time is spent toggling direction or waiting
+ * for the shift register; tx_busy() polls the driver's TX-done state.
+ */
+class UartRS485Port : public RS485Port {
+  public:
+    void begin(HardwareSerial& serial, int8_t tx_pin, int8_t rx_pin, int8_t de_pin,
+               uint32_t baud_rate);
+
+    size_t available() override;
+    size_t read(uint8_t* dest, size_t max_length) override;
+    void discard_input() override;
+    uint32_t last_rx_ms() const override { return last_rx_ms_.load(); }
+    bool take_rx_boundary() override;
+    bool wait_for_rx(uint32_t timeout_ms) override;
+    size_t write(const uint8_t* data, size_t length) override;
+    bool tx_busy() override;
+
+  private:
+    void on_rx_idle(); // UART driver event task context
+
+    HardwareSerial* serial_ = nullptr;
+    uart_port_t uart_num_ = 0;
+    bool tx_pending_ = false;
+    SemaphoreHandle_t rx_event_ = nullptr;
+
+    // Written by the UART event task, read by the RS485 side
+    std::atomic<uint32_t> last_rx_ms_{0};
+    std::atomic<uint32_t> rx_boundaries_{0};
+    uint32_t rx_boundaries_taken_ = 0;
+
+    // Stream positions (bytes since begin) that tell whether read() got past
+    // the last boundary; only bytes after it are newer than its timestamp
+    std::atomic<uint32_t> rx_consumed_{0};     // Written by the reader
+    std::atomic<uint32_t> rx_boundary_end_{0}; // Written by the UART event task
+};
@@ -0,0 +1,52 @@
+/**
+ * @file rs485_port_interface.h
+ * @brief RS485 line access behind an interface
+ *
+ * RS485Manager only talks to an RS485Port, so the bus timing logic does
+ * not depend on the ESP32 UART driver and can be driven by a fake port.
+ * This header stays free of ESP-IDF includes so host builds can use it.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// ============================================================================
+// RS485Port Interface
+// ============================================================================
+
+/**
+ * @brief Byte-level access to the RS485 line
+ *
+ * Besides plain read/write, a port reports line timing: when bytes were
+ * last seen and when the line went idle after a burst (frame boundary).
+ */
+class RS485Port {
+  public:
+    virtual ~RS485Port() = default;
+
+    // ========== RX ==========
+    virtual size_t available() = 0;
+    virtual size_t read(uint8_t* dest, size_t max_length) = 0;
+    virtual void discard_input() = 0;
+
+    /// millis() of the latest RX activity seen on the line
+    virtual uint32_t last_rx_ms() const = 0;
+
+    /// True if the line went idle after received bytes since the last call
+    virtual bool take_rx_boundary() = 0;
+
+    /// Block the caller until RX activity or timeout; true when woken by RX
+    virtual bool wait_for_rx(uint32_t timeout_ms) = 0;
+
+    // ========== TX ==========
+    /// Queue a frame for transmission; returns without waiting for it to go out
+    virtual size_t write(const uint8_t* data, size_t length) = 0;
+
+    /// True until the last queued byte has left the transmitter
+    virtual bool tx_busy() = 0;
+};
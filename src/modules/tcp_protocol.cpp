@@ -50,7 +50,7 @@ void build_rs485_write_multi(TcpParseResult& result) {
     }
 
     size_t rs485_size = InverterProtocolOffsets::DATA_START + (result.register_count * 2) + 2;
-    if (rs485_size > MODBUS_MAX_RX_BUFFER_SIZE) {
+    if (rs485_size > result.rs485_packet.capacity()) {
         LOGE(TAG, "build_rs485_write_multi: rs485_size=%u exceeds buffer", (unsigned) rs485_size);
         return;
     }
@@ -98,22 +98,22 @@ void build_rs485_read(TcpParseResult& result) {
 // Parse WiFi Request
 // ============================================================================
 
-TcpParseResult TcpProtocol::parse_request(const uint8_t* data, size_t length) {
-    TcpParseResult result;
+bool TcpProtocol::parse_request(const uint8_t* data, size_t length, TcpParseResult& result) {
+    result = TcpParseResult();
 
     // Check minimum size
     if (length < TCP_PROTO_MIN_REQUEST_SIZE) {
-        result.error_message = "Packet too small";
-        LOGW(TAG, "%s: got %d, expected %d", result.error_message.c_str(), length,
+        result.error = TcpParseError::PACKET_TOO_SMALL;
+        LOGW(TAG, "%s: got %d, expected %d", error_to_string(result.error), length,
              TCP_PROTO_MIN_REQUEST_SIZE);
-        return result;
+        return false;
     }
 
     // Check prefix (A1 1A)
     if (data[0] != TCP_PROTO_PREFIX[0] || data[1] != TCP_PROTO_PREFIX[1]) {
-        result.error_message = "Invalid prefix (expected A1 1A)";
-        LOGW(TAG, "%s: got %02X %02X", result.error_message.c_str(), data[0], data[1]);
-        return result;
+        result.error = TcpParseError::INVALID_PREFIX;
+        LOGW(TAG, "%s: got %02X %02X", error_to_string(result.error), data[0], data[1]);
+        return false;
     }
 
     // Parse header
@@ -129,18 +129,18 @@ TcpParseResult TcpProtocol::parse_request(const uint8_t* data, size_t length) {
     // A malformed/malicious client could declare a huge frame_length; reject before any parsing.
     if (frame_length < TCP_PROTO_REQUEST_FRAME_LENGTH ||
         static_cast<size_t>(6) + frame_length > length) {
-        result.error_message = "Invalid frame_length";
-        LOGW(TAG, "%s: frame_length=%u, packet length=%u", result.error_message.c_str(),
+        result.error = TcpParseError::INVALID_FRAME_LENGTH;
+        LOGW(TAG, "%s: frame_length=%u, packet length=%u", error_to_string(result.error),
              frame_length, (unsigned) length);
-        return result;
+        return false;
     }
 
     // Check TCP function
     if (tcp_function != TCP_PROTO_FUNC_TRANSLATED) {
-        result.error_message = "Unsupported TCP function";
-        LOGW(TAG, "%s: got %d, expected %d", result.error_message.c_str(), tcp_function,
+        result.error = TcpParseError::UNSUPPORTED_FUNCTION;
+        LOGW(TAG, "%s: got %d, expected %d", error_to_string(result.error), tcp_function,
              TCP_PROTO_FUNC_TRANSLATED);
-        return result;
+        return false;
     }
 
     // Extract dongle serial
@@ -166,8 +166,8 @@ TcpParseResult TcpProtocol::parse_request(const uint8_t* data, size_t length) {
             data_frame_size = TCP_PROTO_REQUEST_DATA_LENGTH;
             size_t min_len = TcpProtocolOffsets::DATA_FRAME + data_frame_size;
             if (length < min_len) {
-                result.error_message = "Write single packet too small";
-                return result;
+                result.error = TcpParseError::WRITE_SINGLE_TOO_SMALL;
+                return false;
             }
 
             uint16_t register_value =
@@ -186,27 +186,27 @@ TcpParseResult TcpProtocol::parse_request(const uint8_t* data, size_t length) {
 
             // Validate register count (max 127 for new inverters)
             if (result.register_count == 0 || result.register_count > TCP_PROTO_MAX_REGISTERS) {
-                result.error_message = "Invalid register count for write";
-                LOGE(TAG, "%s: %d (max %d)", result.error_message.c_str(), result.register_count,
+                result.error = TcpParseError::INVALID_WRITE_COUNT;
+                LOGE(TAG, "%s: %d (max %d)", error_to_string(result.error), result.register_count,
                      TCP_PROTO_MAX_REGISTERS);
-                return result;
+                return false;
             }
 
             // Byte_count must match register_count*2 to avoid confused-deputy parsing
             // (trust only one of the two declared sizes)
             if (byte_count != result.register_count * 2) {
-                result.error_message = "byte_count / register_count mismatch";
-                LOGE(TAG, "%s: byte_count=%u, expected %u", result.error_message.c_str(),
+                result.error = TcpParseError::BYTE_COUNT_MISMATCH;
+                LOGE(TAG, "%s: byte_count=%u, expected %u", error_to_string(result.error),
                      byte_count, (unsigned) (result.register_count * 2));
-                return result;
+                return false;
             }
 
             data_frame_size = TcpProtocolOffsets::VALUES_START + byte_count; // fixed header + data
 
             size_t min_len = TcpProtocolOffsets::DATA_FRAME + data_frame_size;
             if (length < min_len) {
-                result.error_message = "Write multiple packet too small";
-                return result;
+                result.error = TcpParseError::WRITE_MULTI_TOO_SMALL;
+                return false;
             }
 
             // Parse register values (little-endian, 2 bytes each)
@@ -232,10 +232,10 @@ TcpParseResult TcpProtocol::parse_request(const uint8_t* data, size_t length) {
 
     // Validate register count (max 127 for new inverters)
     if (result.register_count == 0 || result.register_count > TCP_PROTO_MAX_REGISTERS) {
-        result.error_message = "Invalid register count";
-        LOGE(TAG, "%s: %d (max %d)", result.error_message.c_str(), result.register_count,
+        result.error = TcpParseError::INVALID_REGISTER_COUNT;
+        LOGE(TAG, "%s: %d (max %d)", error_to_string(result.error), result.register_count,
              TCP_PROTO_MAX_REGISTERS);
-        return result;
+        return false;
     }
 
     // Verify CRC of data frame
@@ -246,10 +246,10 @@ TcpParseResult TcpProtocol::parse_request(const uint8_t* data, size_t length) {
     uint16_t received_crc = parse_little_endian_uint16(data, crc_offset);
 
     if (calculated_crc != received_crc) {
-        result.error_message = "CRC mismatch";
-        LOGW(TAG, "%s: calculated=0x%04X, received=0x%04X", result.error_message.c_str(),
+        result.error = TcpParseError::CRC_MISMATCH;
+        LOGW(TAG, "%s: calculated=0x%04X, received=0x%04X", error_to_string(result.error),
              calculated_crc, received_crc);
-        return result;
+        return false;
     }
 
     // Build RS485 packet from the data frame
@@ -275,7 +275,7 @@ TcpParseResult TcpProtocol::parse_request(const uint8_t* data, size_t length) {
              result.start_register, result.register_count);
     }
 
-    return result;
+    return true;
 }
 
 // ============================================================================
@@ -443,6 +443,35 @@ void TcpProtocol::copy_serial(const String& str, uint8_t* serial) {
     SerialUtils::write_serial(serial, TCP_PROTO_DONGLE_SERIAL_LEN, str);
 }
 
+const char* TcpProtocol::error_to_string(TcpParseError error) {
+    switch (error) {
+        case TcpParseError::NONE:
+            return "OK";
+        case TcpParseError::PACKET_TOO_SMALL:
+            return "Packet too small";
+        case TcpParseError::INVALID_PREFIX:
+            return "Invalid prefix (expected A1 1A)";
+        case TcpParseError::INVALID_FRAME_LENGTH:
+            return "Invalid frame_length";
+        case TcpParseError::UNSUPPORTED_FUNCTION:
+            return "Unsupported TCP function";
+        case TcpParseError::WRITE_SINGLE_TOO_SMALL:
+            return "Write single packet too small";
+        case TcpParseError::INVALID_WRITE_COUNT:
+            return "Invalid register count for write";
+        case TcpParseError::BYTE_COUNT_MISMATCH:
+            return "byte_count / register_count mismatch";
+        case TcpParseError::WRITE_MULTI_TOO_SMALL:
+            return "Write multiple packet too small";
+        case TcpParseError::INVALID_REGISTER_COUNT:
+            return "Invalid register count";
+        case TcpParseError::CRC_MISMATCH:
+            return "CRC mismatch";
+        default:
+            return "Unknown error";
+    }
+}
+
 String TcpProtocol::format_hex(const uint8_t* data, size_t length) {
     String result;
     result.reserve(length * 3);
@@ -7,6 +7,8 @@
  */
 #pragma once
 
+#include "utils/fixed_vector.h"
+
 #include <Arduino.h>
 
 #include <cstring>
@@ -36,6 +38,10 @@ static constexpr size_t TCP_PROTO_MIN_RESPONSE_SIZE = 37;
 static constexpr uint16_t TCP_PROTO_REQUEST_FRAME_LENGTH = 32;
 static constexpr uint16_t TCP_PROTO_REQUEST_DATA_LENGTH = 18;
 static constexpr size_t TCP_PROTO_MAX_REGISTERS = 127; // Max registers per request (new inverters)
+static constexpr size_t TCP_PROTO_MAX_RS485_PACKET_SIZE =
+    17 + (TCP_PROTO_MAX_REGISTERS * 2) + 2; // Largest RS485 request (write multi)
+static constexpr size_t TCP_PROTO_MAX_RESPONSE_SIZE =
+    20 + 17 + 255; // Header(20) + largest RS485 read response (255 data bytes)
 
 // TCP Packet structure offsets
 // Format:
@@ -126,12 +132,32 @@ struct TcpProtocolResponseHeader {
     // Data frame starts at [20]
 } __attribute__((packed));
 
+/**
+ * @brief Reason a WiFi request was rejected
+ */
+enum class TcpParseError : uint8_t {
+    NONE = 0,
+    PACKET_TOO_SMALL,
+    INVALID_PREFIX,
+    INVALID_FRAME_LENGTH,
+    UNSUPPORTED_FUNCTION,
+    WRITE_SINGLE_TOO_SMALL,
+    INVALID_WRITE_COUNT,
+    BYTE_COUNT_MISMATCH,
+    WRITE_MULTI_TOO_SMALL,
+    INVALID_REGISTER_COUNT,
+    CRC_MISMATCH,
+};
+
 /**
  * @brief Parse result for WiFi protocol packets
+ *
+ * Uses inline storage only, so a parsed request can be queued and handed
+ * to the RS485 worker without heap allocations.
  */
 struct TcpParseResult {
     bool success = false;
-    String error_message;
+    TcpParseError error = TcpParseError::NONE;
 
     // Request fields
     uint8_t dongle_serial[TCP_PROTO_DONGLE_SERIAL_LEN];
@@ -142,10 +168,11 @@ struct TcpParseResult {
 
     // For write operations (0x06 and 0x10)
     bool is_write_operation = false;
-    std::vector<uint16_t> write_values; // Values to write (for 0x06: 1 value, for 0x10: multiple)
+    // Values to write (for 0x06: 1 value, for 0x10: multiple)
+    FixedVector<uint16_t, TCP_PROTO_MAX_REGISTERS> write_values;
 
     // For building RS485 packet
-    std::vector<uint8_t> rs485_packet;
+    FixedVector<uint8_t, TCP_PROTO_MAX_RS485_PACKET_SIZE> rs485_packet;
 
     TcpParseResult() {
         memset(dongle_serial, 0, TCP_PROTO_DONGLE_SERIAL_LEN);
@@ -161,8 +188,8 @@ struct TcpParseResult {
  */
 class TcpProtocol {
   public:
-    // Parse WiFi request packet and extract RS485 data
-    static TcpParseResult parse_request(const uint8_t* data, size_t length);
+    // Parse WiFi request packet and extract RS485 data (result.success mirrors return value)
+    static bool parse_request(const uint8_t* data, size_t length, TcpParseResult& result);
 
     // Build WiFi response packet from RS485 response
     static bool build_response(std::vector<uint8_t>& wifi_packet, const uint8_t* rs485_response,
@@ -179,6 +206,7 @@ class TcpProtocol {
     static String format_serial(const uint8_t* serial);
     static void copy_serial(const String& str, uint8_t* serial);
     static String format_hex(const uint8_t* data, size_t length);
+    static const char* error_to_string(TcpParseError error);
 
     // Byte order helpers (little-endian)
     static uint16_t parse_little_endian_uint16(const uint8_t* data, size_t offset);
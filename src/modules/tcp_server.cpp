@@ -217,8 +217,8 @@ bool TCPServer::send_to_all_clients(const uint8_t* data, size_t length) {
 
 String TCPServer::describe_clients() const {
     String out;
-    // Reserve more space: ~50 chars per client + header
-    out.reserve(64 + clients_.size() * 50);
+    // Reserve more space: ~80 chars per client + header
+    out.reserve(64 + clients_.size() * 80);
     out += "Clients: ";
     out += clients_.size(); // Implicit conversion, no temporary String
     out += "\n";
@@ -247,6 +247,15 @@ String TCPServer::describe_clients() const {
         out += c.is_connected() ? "yes" : "no";
         out += " last_ms=";
         out += c.last_activity;
+        out += " queued=";
+        out += c.bridge_queued;
+        out += " drops=";
+        out += c.bridge_drops;
+        if (c.bridge_patience_ms) {
+            out += " patience=";
+            out += c.bridge_patience_ms;
+            out += "ms";
+        }
         out += "\n";
     }
     return out;
@@ -460,6 +469,19 @@ TCPClient* TCPServer::resolve_client(const AsyncClient* async_client) {
     return c;
 }
 
+size_t TCPServer::copy_client_handles(AsyncClient** out, size_t max_count) const {
+    size_t count = 0;
+    for (const auto& c : clients_) {
+        if (count >= max_count) {
+            break;
+        }
+        if (c.is_connected()) {
+            out[count++] = c.client;
+        }
+    }
+    return count;
+}
+
 TCPClient* TCPServer::find_client(const AsyncClient* client) {
     // Safety check
     if (!client) {
@@ -38,6 +38,10 @@ struct TCPClient {
     uint32_t pending_since_ms = 0;
     uint32_t close_issued_at_ms = 0;
     String close_reason;
+    uint32_t bridge_pending_since_ms = 0; // Oldest unanswered bridge request (0 = none)
+    uint32_t bridge_patience_ms = 0;      // Learned response timeout (0 = not observed yet)
+    uint16_t bridge_queued = 0;           // Requests in the bridge queue (bridge-maintained)
+    uint32_t bridge_drops = 0;            // Requests rejected for a full queue or share
 
     bool is_connected() const {
         return client != nullptr && client->connected() && !pending_removal;
@@ -87,6 +91,10 @@ class TCPServer {
     TCPClient* resolve_client(const AsyncClient* async_client);
     void request_client_close(AsyncClient* async_client, const char* reason);
 
+    // Copy the handles of clients that resolve_client() would accept, for
+    // callers outside this task that only need a liveness check.
+    size_t copy_client_handles(AsyncClient** out, size_t max_count) const;
+
     // Statistics
     uint32_t get_total_connections() const { return total_connections_; }
     uint32_t get_total_bytes_rx() const { return total_bytes_rx_; }
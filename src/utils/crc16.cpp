@@ -8,17 +8,122 @@
 
 #include "crc16.h"
 
+// Reflected CRC16 lookup table for polynomial 0xA001: TABLE[i] is the CRC
+// state after shifting byte value i through the bitwise algorithm.
+const uint16_t CRC16::TABLE[256] = {
+    0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
+    0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
+    0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
+    0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
+    0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
+    0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
+    0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
+    0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
+    0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
+    0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
+    0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
+    0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
+    0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
+    0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
+    0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
+    0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
+    0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
+    0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
+    0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
+    0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
+    0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
+    0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
+    0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
+    0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
+    0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
+    0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
+    0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
+    0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
+    0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
+    0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
+    0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
+    0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040,
+};
+
+// Linear map that advances a CRC state over 16 zero bytes, split by input
+// byte: SPAN16_LO[x & 0xFF] ^ SPAN16_HI[x >> 8] == 16 x update(x, 0).
+const uint16_t CRC16::SPAN16_LO[256] = {
+    0x0000, 0x90C1, 0x6181, 0xF140, 0xC302, 0x53C3, 0xA283, 0x3242,
+    0xC607, 0x56C6, 0xA786, 0x3747, 0x0505, 0x95C4, 0x6484, 0xF445,
+    0xCC0D, 0x5CCC, 0xAD8C, 0x3D4D, 0x0F0F, 0x9FCE, 0x6E8E, 0xFE4F,
+    0x0A0A, 0x9ACB, 0x6B8B, 0xFB4A, 0xC908, 0x59C9, 0xA889, 0x3848,
+    0xD819, 0x48D8, 0xB998, 0x2959, 0x1B1B, 0x8BDA, 0x7A9A, 0xEA5B,
+    0x1E1E, 0x8EDF, 0x7F9F, 0xEF5E, 0xDD1C, 0x4DDD, 0xBC9D, 0x2C5C,
+    0x1414, 0x84D5, 0x7595, 0xE554, 0xD716, 0x47D7, 0xB697, 0x2656,
+    0xD213, 0x42D2, 0xB392, 0x2353, 0x1111, 0x81D0, 0x7090, 0xE051,
+    0xF031, 0x60F0, 0x91B0, 0x0171, 0x3333, 0xA3F2, 0x52B2, 0xC273,
+    0x3636, 0xA6F7, 0x57B7, 0xC776, 0xF534, 0x65F5, 0x94B5, 0x0474,
+    0x3C3C, 0xACFD, 0x5DBD, 0xCD7C, 0xFF3E, 0x6FFF, 0x9EBF, 0x0E7E,
+    0xFA3B, 0x6AFA, 0x9BBA, 0x0B7B, 0x3939, 0xA9F8, 0x58B8, 0xC879,
+    0x2828, 0xB8E9, 0x49A9, 0xD968, 0xEB2A, 0x7BEB, 0x8AAB, 0x1A6A,
+    0xEE2F, 0x7EEE, 0x8FAE, 0x1F6F, 0x2D2D, 0xBDEC, 0x4CAC, 0xDC6D,
+    0xE425, 0x74E4, 0x85A4, 0x1565, 0x2727, 0xB7E6, 0x46A6, 0xD667,
+    0x2222, 0xB2E3, 0x43A3, 0xD362, 0xE120, 0x71E1, 0x80A1, 0x1060,
+    0xA061, 0x30A0, 0xC1E0, 0x5121, 0x6363, 0xF3A2, 0x02E2, 0x9223,
+    0x6666, 0xF6A7, 0x07E7, 0x9726, 0xA564, 0x35A5, 0xC4E5, 0x5424,
+    0x6C6C, 0xFCAD, 0x0DED, 0x9D2C, 0xAF6E, 0x3FAF, 0xCEEF, 0x5E2E,
+    0xAA6B, 0x3AAA, 0xCBEA, 0x5B2B, 0x6969, 0xF9A8, 0x08E8, 0x9829,
+    0x7878, 0xE8B9, 0x19F9, 0x8938, 0xBB7A, 0x2BBB, 0xDAFB, 0x4A3A,
+    0xBE7F, 0x2EBE, 0xDFFE, 0x4F3F, 0x7D7D, 0xEDBC, 0x1CFC, 0x8C3D,
+    0xB475, 0x24B4, 0xD5F4, 0x4535, 0x7777, 0xE7B6, 0x16F6, 0x8637,
+    0x7272, 0xE2B3, 0x13F3, 0x8332, 0xB170, 0x21B1, 0xD0F1, 0x4030,
+    0x5050, 0xC091, 0x31D1, 0xA110, 0x9352, 0x0393, 0xF2D3, 0x6212,
+    0x9657, 0x0696, 0xF7D6, 0x6717, 0x5555, 0xC594, 0x34D4, 0xA415,
+    0x9C5D, 0x0C9C, 0xFDDC, 0x6D1D, 0x5F5F, 0xCF9E, 0x3EDE, 0xAE1F,
+    0x5A5A, 0xCA9B, 0x3BDB, 0xAB1A, 0x9958, 0x0999, 0xF8D9, 0x6818,
+    0x8849, 0x1888, 0xE9C8, 0x7909, 0x4B4B, 0xDB8A, 0x2ACA, 0xBA0B,
+    0x4E4E, 0xDE8F, 0x2FCF, 0xBF0E, 0x8D4C, 0x1D8D, 0xECCD, 0x7C0C,
+    0x4444, 0xD485, 0x25C5, 0xB504, 0x8746, 0x1787, 0xE6C7, 0x7606,
+    0x8243, 0x1282, 0xE3C2, 0x7303, 0x4141, 0xD180, 0x20C0, 0xB001,
+};
+
+const uint16_t CRC16::SPAN16_HI[256] = {
+    0x0000, 0x00C1, 0x0182, 0x0143, 0x0304, 0x03C5, 0x0286, 0x0247,
+    0x0608, 0x06C9, 0x078A, 0x074B, 0x050C, 0x05CD, 0x048E, 0x044F,
+    0x0C10, 0x0CD1, 0x0D92, 0x0D53, 0x0F14, 0x0FD5, 0x0E96, 0x0E57,
+    0x0A18, 0x0AD9, 0x0B9A, 0x0B5B, 0x091C, 0x09DD, 0x089E, 0x085F,
+    0x1820, 0x18E1, 0x19A2, 0x1963, 0x1B24, 0x1BE5, 0x1AA6, 0x1A67,
+    0x1E28, 0x1EE9, 0x1FAA, 0x1F6B, 0x1D2C, 0x1DED, 0x1CAE, 0x1C6F,
+    0x1430, 0x14F1, 0x15B2, 0x1573, 0x1734, 0x17F5, 0x16B6, 0x1677,
+    0x1238, 0x12F9, 0x13BA, 0x137B, 0x113C, 0x11FD, 0x10BE, 0x107F,
+    0x3040, 0x3081, 0x31C2, 0x3103, 0x3344, 0x3385, 0x32C6, 0x3207,
+    0x3648, 0x3689, 0x37CA, 0x370B, 0x354C, 0x358D, 0x34CE, 0x340F,
+    0x3C50, 0x3C91, 0x3DD2, 0x3D13, 0x3F54, 0x3F95, 0x3ED6, 0x3E17,
+    0x3A58, 0x3A99, 0x3BDA, 0x3B1B, 0x395C, 0x399D, 0x38DE, 0x381F,
+    0x2860, 0x28A1, 0x29E2, 0x2923, 0x2B64, 0x2BA5, 0x2AE6, 0x2A27,
+    0x2E68, 0x2EA9, 0x2FEA, 0x2F2B, 0x2D6C, 0x2DAD, 0x2CEE, 0x2C2F,
+    0x2470, 0x24B1, 0x25F2, 0x2533, 0x2774, 0x27B5, 0x26F6, 0x2637,
+    0x2278, 0x22B9, 0x23FA, 0x233B, 0x217C, 0x21BD, 0x20FE, 0x203F,
+    0x6080, 0x6041, 0x6102, 0x61C3, 0x6384, 0x6345, 0x6206, 0x62C7,
+    0x6688, 0x6649, 0x670A, 0x67CB, 0x658C, 0x654D, 0x640E, 0x64CF,
+    0x6C90, 0x6C51, 0x6D12, 0x6DD3, 0x6F94, 0x6F55, 0x6E16, 0x6ED7,
+    0x6A98, 0x6A59, 0x6B1A, 0x6BDB, 0x699C, 0x695D, 0x681E, 0x68DF,
+    0x78A0, 0x7861, 0x7922, 0x79E3, 0x7BA4, 0x7B65, 0x7A26, 0x7AE7,
+    0x7EA8, 0x7E69, 0x7F2A, 0x7FEB, 0x7DAC, 0x7D6D, 0x7C2E, 0x7CEF,
+    0x74B0, 0x7471, 0x7532, 0x75F3, 0x77B4, 0x7775, 0x7636, 0x76F7,
+    0x72B8, 0x7279, 0x733A, 0x73FB, 0x71BC, 0x717D, 0x703E, 0x70FF,
+    0x50C0, 0x5001, 0x5142, 0x5183, 0x53C4, 0x5305, 0x5246, 0x5287,
+    0x56C8, 0x5609, 0x574A, 0x578B, 0x55CC, 0x550D, 0x544E, 0x548F,
+    0x5CD0, 0x5C11, 0x5D52, 0x5D93, 0x5FD4, 0x5F15, 0x5E56, 0x5E97,
+    0x5AD8, 0x5A19, 0x5B5A, 0x5B9B, 0x59DC, 0x591D, 0x585E, 0x589F,
+    0x48E0, 0x4821, 0x4962, 0x49A3, 0x4BE4, 0x4B25, 0x4A66, 0x4AA7,
+    0x4EE8, 0x4E29, 0x4F6A, 0x4FAB, 0x4DEC, 0x4D2D, 0x4C6E, 0x4CAF,
+    0x44F0, 0x4431, 0x4572, 0x45B3, 0x47F4, 0x4735, 0x4676, 0x46B7,
+    0x42F8, 0x4239, 0x437A, 0x43BB, 0x41FC, 0x413D, 0x407E, 0x40BF,
+};
+
 uint16_t CRC16::calculate(const uint8_t* data, size_t length) {
-    uint16_t crc = 0xFFFF;
+    return finalize(update(init(), data, length));
+}
+
+uint16_t CRC16::update(uint16_t crc, const uint8_t* data, size_t length) {
     for (size_t i = 0; i < length; i++) {
-        crc ^= data[i];
-        for (int j = 0; j < 8; j++) {
-            if (crc & 0x0001) {
-                crc = (crc >> 1) ^ 0xA001;
-            } else {
-                crc >>= 1;
-            }
-        }
+        crc = update(crc, data[i]);
     }
     return crc;
 }
@@ -15,13 +15,68 @@
  * @brief CRC16-Modbus (poly 0xA001) calculator.
  *
  * Used by both TCP and RS485 protocol packets.
+ *
+ * Table-driven (one lookup per byte). Besides the one-shot calculate(),
+ * an incremental init/update/finalize API lets callers fold bytes into
+ * the CRC as they arrive instead of rescanning whole buffers:
+ *
+ *     uint16_t crc = CRC16::init();
+ *     crc = CRC16::update(crc, header, header_len);
+ *     crc = CRC16::update(crc, payload, payload_len);
+ *     uint16_t value = CRC16::finalize(crc);
  */
 class CRC16 {
   public:
+    static constexpr uint16_t INITIAL_VALUE = 0xFFFF;
+
     /**
      * @param data Pointer to the buffer
      * @param length Number of bytes to process
      * @return CRC16 value
      */
     static uint16_t calculate(const uint8_t* data, size_t length);
+
+    /// Start a new running CRC.
+    static uint16_t init() { return INITIAL_VALUE; }
+
+    /// Fold a single byte into a running CRC.
+    static uint16_t update(uint16_t crc, uint8_t byte) {
+        return static_cast<uint16_t>((crc >> 8) ^ TABLE[(crc ^ byte) & 0xFF]);
+    }
+
+    /// Fold a buffer into a running CRC.
+    static uint16_t update(uint16_t crc, const uint8_t* data, size_t length);
+
+    /// Compile-time equivalent of update(crc, byte) for constexpr frame builders.
+    static constexpr uint16_t fold(uint16_t crc, uint8_t byte) {
+        return shift_bits(static_cast<uint16_t>(crc ^ byte), 8);
+    }
+
+    /// Final CRC value (Modbus has no output XOR; kept for API symmetry).
+    static uint16_t finalize(uint16_t crc) { return crc; }
+
+    /**
+     * @brief CRC of a 16-byte span from two prefix states (O(1), no byte loop)
+     *
+     * A prefix state is update() folded over data[0..k) starting from 0
+     * instead of init(). Since the CRC is linear, the CRC of data[j..j+16)
+     * follows from the prefix states at j and j+16, so a scanner can
+     * validate many overlapping fixed-size candidates from one pass.
+     */
+    static uint16_t span16_from_prefix(uint16_t prefix_begin, uint16_t prefix_end) {
+        const uint16_t x = INITIAL_VALUE ^ prefix_begin;
+        return static_cast<uint16_t>(SPAN16_LO[x & 0xFF] ^ SPAN16_HI[x >> 8] ^ prefix_end);
+    }
+
+  private:
+    static constexpr uint16_t shift_bits(uint16_t crc, int bits) {
+        return bits == 0 ? crc
+                         : shift_bits(static_cast<uint16_t>((crc & 1) ? (crc >> 1) ^ 0xA001
+                                                                      : (crc >> 1)),
+                                      bits - 1);
+    }
+
+    static const uint16_t TABLE[256];
+    static const uint16_t SPAN16_LO[256];
+    static const uint16_t SPAN16_HI[256];
 };
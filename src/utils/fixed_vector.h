@@ -0,0 +1,87 @@
+/**
+ * @file fixed_vector.h
+ * @brief Fixed-capacity vector with inline storage
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Vector-like container with compile-time capacity and no heap use.
+ *
+ * Intended for trivially copyable element types (register values, packet
+ * bytes). Only the used part of the storage is copied on assignment, so a
+ * nearly-empty container stays cheap to move between queues.
+ */
+template <typename T, size_t Capacity>
+class FixedVector {
+  public:
+    FixedVector() = default;
+
+    FixedVector(const FixedVector& other) { copy_from(other); }
+
+    FixedVector& operator=(const FixedVector& other) {
+        if (this != &other) {
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    bool full() const { return size_ >= Capacity; }
+
+    T* data() { return items_; }
+    const T* data() const { return items_; }
+    T* begin() { return items_; }
+    T* end() { return items_ + size_; }
+    const T* begin() const { return items_; }
+    const T* end() const { return items_ + size_; }
+
+    T& operator[](size_t index) { return items_[index]; }
+    const T& operator[](size_t index) const { return items_[index]; }
+
+    void clear() { size_ = 0; }
+
+    /// Append one element; returns false (and drops it) when full.
+    bool push_back(const T& value) {
+        if (size_ >= Capacity) {
+            return false;
+        }
+        items_[size_++] = value;
+        return true;
+    }
+
+    /// Change the logical size; new elements are left uninitialized.
+    bool resize(size_t count) {
+        if (count > Capacity) {
+            return false;
+        }
+        size_ = count;
+        return true;
+    }
+
+    /// Replace contents with a copy of [values, values + count).
+    bool assign(const T* values, size_t count) {
+        if (count > Capacity) {
+            return false;
+        }
+        for (size_t i = 0; i < count; i++) {
+            items_[i] = values[i];
+        }
+        size_ = count;
+        return true;
+    }
+
+  private:
+    void copy_from(const FixedVector& other) { assign(other.items_, other.size_); }
+
+    T items_[Capacity];
+    size_t size_ = 0;
+};
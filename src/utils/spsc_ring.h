@@ -0,0 +1,74 @@
+/**
+ * @file spsc_ring.h
+ * @brief Bounded lock-free single-producer/single-consumer ring
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+/**
+ * @brief Fixed-capacity ring shared by exactly one producer and one consumer task.
+ *
+ * Slots are filled and drained in place: the producer writes into
+ * begin_push() and publishes with commit_push(); the consumer reads front()
+ * and releases the slot with pop(). No locks and no heap use.
+ */
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "SpscRing capacity must be a power of two");
+
+  public:
+    static constexpr size_t capacity() { return Capacity; }
+
+    // Safe from any task: head is loaded first, so the result never underflows
+    size_t size() const {
+        const size_t head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+    bool empty() const { return size() == 0; }
+    bool full() const { return size() >= Capacity; }
+
+    // ========== Producer ==========
+    /// Free slot to fill, or nullptr when full. Not visible until commit_push().
+    T* begin_push() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) >= Capacity) {
+            return nullptr;
+        }
+        return &items_[tail & (Capacity - 1)];
+    }
+
+    void commit_push() {
+        tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    // ========== Consumer ==========
+    /// Oldest published slot, or nullptr when empty.
+    T* front() {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return &items_[head & (Capacity - 1)];
+    }
+
+    void pop() {
+        head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    /// index-th published slot counted from front(); valid for index < size()
+    T* at(size_t index) {
+        return &items_[(head_.load(std::memory_order_relaxed) + index) & (Capacity - 1)];
+    }
+
+  private:
+    T items_[Capacity];
+    std::atomic<size_t> head_{0}; // Written by the consumer only
+    std::atomic<size_t> tail_{0}; // Written by the producer only
+};
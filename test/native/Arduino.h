@@ -0,0 +1,191 @@
+/**
+ * @file Arduino.h
+ * @brief Minimal Arduino core for native (host) test builds
+ *
+ * Only what the portable OpenLux modules use: String, timing on the
+ * virtual HostClock, random and a few pin helpers.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+#include "HardwareSerial.h"
+#include "freertos/FreeRTOS.h"
+
+#define HEX 16
+#define DEC 10
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define LOW 0x0
+#define HIGH 0x1
+
+// Mixed-type min/max: size_t is 64 bits here but 32 bits on the ESP32, where
+// calls such as min(count, buffer.size()) deduce a single type
+template <typename A, typename B>
+constexpr typename std::common_type<A, B>::type min(const A& a, const B& b) {
+    return b < a ? b : a;
+}
+template <typename A, typename B>
+constexpr typename std::common_type<A, B>::type max(const A& a, const B& b) {
+    return a < b ? b : a;
+}
+
+// ============================================================================
+// String
+// ============================================================================
+
+class String {
+  public:
+    String() = default;
+    String(const char* s) : s_(s ? s : "") {}
+    String(const std::string& s) : s_(s) {}
+    explicit String(char c) : s_(1, c) {}
+    String(int value, unsigned char base = DEC) : s_(format(value, base)) {}
+    String(unsigned int value, unsigned char base = DEC) : s_(format(value, base)) {}
+    String(long value, unsigned char base = DEC) : s_(format(value, base)) {}
+    String(unsigned long value, unsigned char base = DEC) : s_(format(value, base)) {}
+    String(unsigned char value, unsigned char base = DEC)
+        : s_(format(static_cast<unsigned long>(value), base)) {}
+    String(float value, unsigned int decimals = 2) : s_(format_float(value, decimals)) {}
+    String(double value, unsigned int decimals = 2) : s_(format_float(value, decimals)) {}
+
+    const char* c_str() const { return s_.c_str(); }
+    unsigned int length() const { return static_cast<unsigned int>(s_.size()); }
+    bool reserve(unsigned int size) {
+        s_.reserve(size);
+        return true;
+    }
+    char operator[](unsigned int index) const { return index < s_.size() ? s_[index] : 0; }
+    char charAt(unsigned int index) const { return (*this)[index]; }
+
+    String& operator+=(const String& rhs) {
+        s_ += rhs.s_;
+        return *this;
+    }
+    String& operator+=(const char* rhs) {
+        s_ += rhs ? rhs : "";
+        return *this;
+    }
+    String& operator+=(char c) {
+        s_ += c;
+        return *this;
+    }
+    String& operator+=(int value) { return *this += String(value); }
+    String& operator+=(unsigned int value) { return *this += String(value); }
+    String& operator+=(long value) { return *this += String(value); }
+    String& operator+=(unsigned long value) { return *this += String(value); }
+    String& operator+=(unsigned char value) { return *this += String(value); }
+    String& operator+=(unsigned short value) { return *this += String((unsigned int) value); }
+    String& operator+=(float value) { return *this += String(value); }
+    String& operator+=(double value) { return *this += String(value); }
+
+    friend String operator+(const String& lhs, const String& rhs) { return String(lhs.s_ + rhs.s_); }
+    friend String operator+(const String& lhs, const char* rhs) {
+        return String(lhs.s_ + (rhs ? rhs : ""));
+    }
+    friend String operator+(const char* lhs, const String& rhs) {
+        return String((lhs ? lhs : "") + rhs.s_);
+    }
+
+    bool operator==(const String& rhs) const { return s_ == rhs.s_; }
+    bool operator==(const char* rhs) const { return s_ == (rhs ? rhs : ""); }
+    bool operator!=(const String& rhs) const { return s_ != rhs.s_; }
+    bool operator!=(const char* rhs) const { return !(*this == rhs); }
+    bool operator<(const String& rhs) const { return s_ < rhs.s_; }
+
+    bool equals(const String& rhs) const { return s_ == rhs.s_; }
+    bool equalsIgnoreCase(const String& rhs) const {
+        return strcasecmp(s_.c_str(), rhs.s_.c_str()) == 0;
+    }
+    bool startsWith(const String& prefix) const { return s_.compare(0, prefix.s_.size(), prefix.s_) == 0; }
+    bool endsWith(const String& suffix) const {
+        return s_.size() >= suffix.s_.size() &&
+               s_.compare(s_.size() - suffix.s_.size(), suffix.s_.size(), suffix.s_) == 0;
+    }
+    int indexOf(char c, unsigned int from = 0) const {
+        const size_t pos = s_.find(c, from);
+        return pos == std::string::npos ? -1 : static_cast<int>(pos);
+    }
+    int indexOf(const String& str, unsigned int from = 0) const {
+        const size_t pos = s_.find(str.s_, from);
+        return pos == std::string::npos ? -1 : static_cast<int>(pos);
+    }
+    String substring(unsigned int from) const {
+        return from < s_.size() ? String(s_.substr(from)) : String();
+    }
+    String substring(unsigned int from, unsigned int to) const {
+        if (from > to) {
+            std::swap(from, to);
+        }
+        return from < s_.size() ? String(s_.substr(from, to - from)) : String();
+    }
+    void remove(unsigned int index, unsigned int count) {
+        if (index < s_.size()) {
+            s_.erase(index, count);
+        }
+    }
+    void trim() {
+        const size_t first = s_.find_first_not_of(" \t\r\n");
+        const size_t last = s_.find_last_not_of(" \t\r\n");
+        s_ = first == std::string::npos ? std::string() : s_.substr(first, last - first + 1);
+    }
+    void toUpperCase() {
+        for (char& c : s_) {
+            c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+        }
+    }
+    void toLowerCase() {
+        for (char& c : s_) {
+            c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+        }
+    }
+    long toInt() const { return atol(s_.c_str()); }
+
+  private:
+    template <typename T> static std::string format(T value, unsigned char base) {
+        char buffer[40];
+        if (base == HEX) {
+            snprintf(buffer, sizeof(buffer), "%lx", static_cast<unsigned long>(value));
+        } else if (static_cast<long long>(value) < 0) {
+            snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(value));
+        } else {
+            snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(value));
+        }
+        return buffer;
+    }
+    static std::string format_float(double value, unsigned int decimals) {
+        char buffer[48];
+        snprintf(buffer, sizeof(buffer), "%.*f", static_cast<int>(decimals), value);
+        return buffer;
+    }
+
+    std::string s_;
+};
+
+// ============================================================================
+// Timing, random and pins
+// ============================================================================
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+uint32_t esp_random();
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
@@ -0,0 +1,144 @@
+/**
+ * @file AsyncTCP.h
+ * @brief Host stand-in for the AsyncTCP library
+ *
+ * Servers keep their connect callback and clients keep their data and
+ * disconnect callbacks, so a test can open connections, feed request bytes
+ * and read back everything the firmware wrote, all on the calling thread.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+#include <functional>
+#include <vector>
+
+class AsyncClient;
+
+typedef std::function<void(void*, AsyncClient*)> AcConnectHandler;
+typedef std::function<void(void*, AsyncClient*, void* data, size_t len)> AcDataHandler;
+typedef std::function<void(void*, AsyncClient*, int8_t error)> AcErrorHandler;
+typedef std::function<void(void*, AsyncClient*, uint32_t time)> AcTimeoutHandler;
+
+// ============================================================================
+// AsyncClient
+// ============================================================================
+
+class AsyncClient {
+  public:
+    AsyncClient() : id_(next_id()) {}
+
+    // ========== Library API used by TCPServer ==========
+    bool connected() const { return connected_; }
+    bool free() const { return !connected_; }
+    size_t space() const { return 5744; }
+    size_t write(const char* data, size_t length) {
+        if (!connected_) {
+            return 0;
+        }
+        writes_.emplace_back(data, data + length);
+        return length;
+    }
+    void close(bool = false) {
+        if (!connected_) {
+            return;
+        }
+        connected_ = false;
+        if (on_disconnect_) {
+            on_disconnect_(on_disconnect_arg_, this);
+        }
+    }
+    IPAddress remoteIP() const { return IPAddress(10, 0, 0, static_cast<uint8_t>(id_)); }
+    uint16_t remotePort() const { return static_cast<uint16_t>(50000 + id_); }
+
+    void onData(AcDataHandler handler, void* arg = nullptr) {
+        on_data_ = handler;
+        on_data_arg_ = arg;
+    }
+    void onDisconnect(AcConnectHandler handler, void* arg = nullptr) {
+        on_disconnect_ = handler;
+        on_disconnect_arg_ = arg;
+    }
+    void onError(AcErrorHandler, void* = nullptr) {}
+    void onTimeout(AcTimeoutHandler, void* = nullptr) {}
+
+    // ========== Host-only controls ==========
+    /// Deliver bytes as if they arrived from the remote peer
+    void host_receive(const uint8_t* data, size_t length) {
+        if (connected_ && on_data_) {
+            on_data_(on_data_arg_, this, const_cast<uint8_t*>(data), length);
+        }
+    }
+
+    /// Everything written to this client, one entry per write() call
+    const std::vector<std::vector<uint8_t>>& host_writes() const { return writes_; }
+    void host_clear_writes() { writes_.clear(); }
+
+  private:
+    static uint16_t next_id() {
+        static uint16_t id = 0;
+        return ++id;
+    }
+
+    uint16_t id_;
+    bool connected_ = true;
+    std::vector<std::vector<uint8_t>> writes_;
+    AcDataHandler on_data_;
+    void* on_data_arg_ = nullptr;
+    AcConnectHandler on_disconnect_;
+    void* on_disconnect_arg_ = nullptr;
+};
+
+// ============================================================================
+// AsyncServer
+// ============================================================================
+
+class AsyncServer {
+  public:
+    explicit AsyncServer(uint16_t port) : port_(port) {}
+    ~AsyncServer() {
+        std::vector<AsyncServer*>& servers = listening();
+        servers.erase(std::remove(servers.begin(), servers.end(), this), servers.end());
+    }
+
+    void onClient(AcConnectHandler handler, void* arg) {
+        on_client_ = handler;
+        on_client_arg_ = arg;
+    }
+    void begin() { listening().push_back(this); }
+    void end() {}
+    void setNoDelay(bool) {}
+
+    // ========== Host-only controls ==========
+    /**
+     * @brief Open a connection to the server listening on @p port
+     *
+     * Ownership passes to the accept callback, as with the real library.
+     * Returns nullptr when nothing listens on the port.
+     */
+    static AsyncClient* host_connect(uint16_t port) {
+        for (AsyncServer* server : listening()) {
+            if (server->port_ == port && server->on_client_) {
+                AsyncClient* client = new AsyncClient();
+                server->on_client_(server->on_client_arg_, client);
+                return client;
+            }
+        }
+        return nullptr;
+    }
+
+  private:
+    static std::vector<AsyncServer*>& listening() {
+        static std::vector<AsyncServer*> servers;
+        return servers;
+    }
+
+    uint16_t port_;
+    AcConnectHandler on_client_;
+    void* on_client_arg_ = nullptr;
+};
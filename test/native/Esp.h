@@ -0,0 +1,41 @@
+/**
+ * @file Esp.h
+ * @brief Host stand-in for the ESP system object
+ *
+ * Heap figures are plain settable values so tests can drive heap-adaptive
+ * limits (queue depth, cache capacity) without real memory pressure.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include <cstdint>
+
+class EspClass {
+  public:
+    uint32_t getFreeHeap() const { return free_heap_; }
+    uint32_t getMinFreeHeap() const { return min_free_heap_; }
+    uint32_t getMaxAllocHeap() const { return max_alloc_heap_; }
+    uint32_t getHeapSize() const { return 320 * 1024; }
+    uint32_t getCpuFreqMHz() const { return 240; }
+    void restart() {}
+
+    // ========== Host-only controls ==========
+    void set_free_heap(uint32_t bytes) {
+        free_heap_ = bytes;
+        max_alloc_heap_ = bytes / 2;
+        if (bytes < min_free_heap_) {
+            min_free_heap_ = bytes;
+        }
+    }
+    void set_max_alloc_heap(uint32_t bytes) { max_alloc_heap_ = bytes; }
+
+  private:
+    uint32_t free_heap_ = 160 * 1024;
+    uint32_t min_free_heap_ = 160 * 1024;
+    uint32_t max_alloc_heap_ = 80 * 1024;
+};
+
+extern EspClass ESP;
@@ -0,0 +1,37 @@
+/**
+ * @file HardwareSerial.h
+ * @brief Host stand-in for the Arduino serial ports (output goes to stdout)
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#define SERIAL_8N1 0x800001c
+
+class HardwareSerial {
+  public:
+    void begin(unsigned long baud, uint32_t config = SERIAL_8N1, int8_t rx_pin = -1,
+               int8_t tx_pin = -1);
+    void end() {}
+    void onReceive(std::function<void(void)> callback, bool only_on_timeout = false) {}
+    int available() { return 0; }
+    int read() { return -1; }
+    size_t readBytes(uint8_t*, size_t) { return 0; }
+    size_t write(uint8_t byte);
+    size_t write(const uint8_t* data, size_t length);
+    void flush();
+    size_t print(const char* text);
+    size_t println(const char* text = "");
+    size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+    operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
@@ -0,0 +1,31 @@
+/**
+ * @file IPAddress.h
+ * @brief Host stand-in for the Arduino IPv4 address type
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+class IPAddress {
+  public:
+    IPAddress() = default;
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : octets_{a, b, c, d} {}
+
+    uint8_t operator[](int index) const { return octets_[index]; }
+    bool operator==(const IPAddress& rhs) const { return memcmp(octets_, rhs.octets_, 4) == 0; }
+    bool operator!=(const IPAddress& rhs) const { return !(*this == rhs); }
+
+    String toString() const {
+        char buffer[16];
+        snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", octets_[0], octets_[1], octets_[2],
+                 octets_[3]);
+        return String(buffer);
+    }
+
+  private:
+    uint8_t octets_[4] = {0, 0, 0, 0};
+};
@@ -0,0 +1,20 @@
+/**
+ * @file Preferences.h
+ * @brief Host stand-in for the ESP32 NVS preferences (nothing is stored)
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include "Arduino.h"
+
+class Preferences {
+  public:
+    bool begin(const char*, bool = false) { return true; }
+    void end() {}
+    bool clear() { return true; }
+    uint8_t getUChar(const char*, uint8_t default_value = 0) { return default_value; }
+    size_t putUChar(const char*, uint8_t) { return 1; }
+};
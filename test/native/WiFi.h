@@ -0,0 +1,55 @@
+/**
+ * @file WiFi.h
+ * @brief Host stand-in for the ESP32 WiFi library
+ *
+ * The station is always "connected" with address 0.0.0.0, which keeps
+ * the TCP listener self-probe out of native tests.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+typedef int WiFiEvent_t;
+typedef int WiFiEventInfo_t;
+
+#define WL_CONNECTED 3
+
+class WiFiClient {
+  public:
+    void setTimeout(uint32_t) {}
+    bool connect(const IPAddress&, uint16_t, int32_t = 0) { return false; }
+    bool connected() { return false; }
+    int available() { return 0; }
+    int read() { return -1; }
+    size_t write(const uint8_t*, size_t length) { return length; }
+    void stop() {}
+    operator bool() { return false; }
+};
+
+class WiFiServer {
+  public:
+    explicit WiFiServer(uint16_t) {}
+    void begin() {}
+    void end() {}
+    bool hasClient() { return false; }
+    WiFiClient available() { return WiFiClient(); }
+};
+
+class WiFiClass {
+  public:
+    int status() const { return WL_CONNECTED; }
+    IPAddress localIP() const { return IPAddress(); }
+    String SSID(int = 0) const { return String("native"); }
+    int RSSI(int = 0) const { return -50; }
+    String macAddress() const { return String("00:00:00:00:00:00"); }
+    String BSSIDstr() const { return String("00:00:00:00:00:00"); }
+    int8_t getTxPower() const { return 0; }
+    uint32_t channel() const { return 1; }
+};
+
+extern WiFiClass WiFi;
@@ -0,0 +1,11 @@
+/**
+ * @file WiFiClient.h
+ * @brief Host stand-in for the ESP32 WiFiClient header
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include "WiFi.h"
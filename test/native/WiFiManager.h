@@ -0,0 +1,9 @@
+/**
+ * @file WiFiManager.h
+ * @brief Empty host stand-in; only included through network_manager.h
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
@@ -0,0 +1,97 @@
+/**
+ * @file fake_rs485_port.h
+ * @brief Scriptable RS485Port for native tests
+ *
+ * Bytes injected by the test are "on the line" at the current virtual
+ * time; end_burst() reports the idle boundary the UART RX timeout would
+ * raise. Transmitted frames are recorded, and the transmitter can be made
+ * to stay busy for a while to model the time a frame takes to go out.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include "modules/rs485_port_interface.h"
+
+#include <Arduino.h>
+
+#include <vector>
+
+class FakeRS485Port : public RS485Port {
+  public:
+    // ========== RX ==========
+    size_t available() override { return rx_.size() - rx_pos_; }
+
+    size_t read(uint8_t* dest, size_t max_length) override {
+        const size_t count = std::min(max_length, available());
+        memcpy(dest, rx_.data() + rx_pos_, count);
+        rx_pos_ += count;
+        if (rx_pos_ == rx_.size()) {
+            rx_.clear();
+            rx_pos_ = 0;
+        }
+        return count;
+    }
+
+    void discard_input() override {
+        rx_.clear();
+        rx_pos_ = 0;
+        boundary_ = false;
+        discards_++;
+    }
+
+    uint32_t last_rx_ms() const override { return last_rx_ms_; }
+
+    bool take_rx_boundary() override {
+        const bool boundary = boundary_;
+        boundary_ = false;
+        return boundary;
+    }
+
+    bool wait_for_rx(uint32_t) override { return available() > 0; }
+
+    // ========== TX ==========
+    size_t write(const uint8_t* data, size_t length) override {
+        tx_frames_.emplace_back(data, data + length);
+        tx_done_ms_ = millis() + tx_drain_ms_;
+        return length;
+    }
+
+    bool tx_busy() override { return (int32_t) (tx_done_ms_ - millis()) > 0; }
+
+    // ========== Test controls ==========
+    /// Bytes arrive on the line now (a burst may be split over several calls)
+    void inject(const std::vector<uint8_t>& bytes) {
+        rx_.insert(rx_.end(), bytes.begin(), bytes.end());
+        last_rx_ms_ = millis();
+    }
+
+    /// The line went idle after the bytes injected so far
+    void end_burst() { boundary_ = true; }
+
+    /// A complete frame: inject() followed by end_burst()
+    void receive_frame(const std::vector<uint8_t>& frame) {
+        inject(frame);
+        end_burst();
+    }
+
+    /// How long each written frame keeps the transmitter busy
+    void set_tx_drain_ms(uint32_t ms) { tx_drain_ms_ = ms; }
+
+    const std::vector<std::vector<uint8_t>>& tx_frames() const { return tx_frames_; }
+    size_t tx_count() const { return tx_frames_.size(); }
+    size_t discard_count() const { return discards_; }
+
+  private:
+    std::vector<uint8_t> rx_;
+    size_t rx_pos_ = 0;
+    uint32_t last_rx_ms_ = 0;
+    bool boundary_ = false;
+    size_t discards_ = 0;
+
+    std::vector<std::vector<uint8_t>> tx_frames_;
+    uint32_t tx_drain_ms_ = 0;
+    uint32_t tx_done_ms_ = 0;
+};
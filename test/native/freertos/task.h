@@ -0,0 +1,24 @@
+/**
+ * @file task.h
+ * @brief Host stand-in for FreeRTOS tasks
+ *
+ * Native tests are single-threaded: task creation fails, so modules fall
+ * back to running from loop(), and vTaskDelay() advances the virtual clock.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include "FreeRTOS.h"
+
+typedef void (*TaskFunction_t)(void*);
+
+#define tskNO_AFFINITY 0x7FFFFFFF
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stack_depth,
+                                   void* parameters, UBaseType_t priority, TaskHandle_t* handle,
+                                   BaseType_t core);
+void vTaskDelay(TickType_t ticks);
+TickType_t xTaskGetTickCount();
@@ -0,0 +1,55 @@
+/**
+ * @file host_bench.h
+ * @brief Wall-clock timing for the native microbenchmarks
+ *
+ * Uses the host's steady clock (millis() is virtual in native builds).
+ * Host numbers only rank implementations; absolute ESP32 timings differ.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include <unity.h>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace HostBench {
+
+/// Results are folded in here so the optimizer cannot drop the timed work
+inline volatile uint32_t& sink() {
+    static volatile uint32_t value = 0;
+    return value;
+}
+
+/// Best-of-five average nanoseconds per call of fn() over @p iterations calls
+template <typename F> double ns_per_call(F fn, uint32_t iterations) {
+    double best = 0;
+    for (int round = 0; round < 5; round++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < iterations; i++) {
+            sink() = sink() + fn();
+        }
+        const auto end = std::chrono::steady_clock::now();
+        const double ns =
+            std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+        if (round == 0 || ns < best) {
+            best = ns;
+        }
+    }
+    return best;
+}
+
+/// Print "<label>: <a> ns vs <b> ns (<ratio>x)" through the test output
+inline void report(const char* label, const char* a_name, double a_ns, const char* b_name,
+                   double b_ns) {
+    char line[160];
+    snprintf(line, sizeof(line), "%s: %s %.1f ns, %s %.1f ns (%.2fx)", label, a_name, a_ns,
+             b_name, b_ns, b_ns / a_ns);
+    TEST_MESSAGE(line);
+}
+
+} // namespace HostBench
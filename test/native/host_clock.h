@@ -0,0 +1,20 @@
+/**
+ * @file host_clock.h
+ * @brief Virtual millisecond clock behind millis() in native tests
+ *
+ * Time only moves when a test advances it (or code under test calls
+ * delay()/vTaskDelay()), so timeouts and deadlines are deterministic.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace HostClock {
+uint32_t now();
+void set(uint32_t ms);
+void advance(uint32_t ms);
+} // namespace HostClock
@@ -0,0 +1,56 @@
+/**
+ * @file host_logger.cpp
+ * @brief Logger for native test builds
+ *
+ * logger.cpp needs the telnet server, NTP and the command manager, so host
+ * builds use this stdout-only version instead. Output is off unless the
+ * OPENLUX_TEST_LOG environment variable is set, since several tests drive
+ * the error paths on purpose.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#include "modules/logger.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+
+static bool host_log_verbose() {
+    static const bool verbose = getenv("OPENLUX_TEST_LOG") != nullptr;
+    return verbose;
+}
+
+Logger::Logger() {}
+
+Logger::~Logger() {}
+
+Logger& Logger::getInstance() {
+    static Logger instance;
+    return instance;
+}
+
+bool Logger::isEnabled(LogLevel, const char*) const { return host_log_verbose(); }
+
+void Logger::log(const char* level, const char*, const char* tag, const char* format,
+                 va_list args) {
+    printf("[%8lu][%s][%s] ", millis(), level, tag);
+    vprintf(format, args);
+    printf("\n");
+}
+
+#define HOST_LOG_METHOD(name, symbol)                             \
+    void Logger::name(const char* tag, const char* format, ...) { \
+        va_list args;                                             \
+        va_start(args, format);                                   \
+        log(symbol, nullptr, tag, format, args);                  \
+        va_end(args);                                             \
+    }
+
+#if OPENLUX_ENABLE_LOGGING
+HOST_LOG_METHOD(debug, SYMBOL_DEBUG)
+HOST_LOG_METHOD(info, SYMBOL_INFO)
+HOST_LOG_METHOD(warning, SYMBOL_WARN)
+#endif
+HOST_LOG_METHOD(error, SYMBOL_ERROR)
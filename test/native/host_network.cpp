@@ -0,0 +1,16 @@
+/**
+ * @file host_network.cpp
+ * @brief NetworkManager for native test builds: always connected, no radio
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#include "modules/network_manager.h"
+
+NetworkManager& NetworkManager::getInstance() {
+    static NetworkManager instance;
+    return instance;
+}
+
+bool NetworkManager::isConnected() { return true; }
@@ -0,0 +1,121 @@
+/**
+ * @file host_runtime.cpp
+ * @brief Arduino, ESP and FreeRTOS runtime for native test builds
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#include "host_clock.h"
+
+#include <Arduino.h>
+#include <Esp.h>
+#include <WiFi.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+
+#include <cstdarg>
+
+HardwareSerial Serial;
+HardwareSerial Serial1;
+HardwareSerial Serial2;
+EspClass ESP;
+WiFiClass WiFi;
+
+// ============================================================================
+// Virtual clock
+// ============================================================================
+
+// Start away from zero: several modules use 0 as "never happened"
+static uint32_t g_host_now_ms = 1000;
+
+uint32_t HostClock::now() { return g_host_now_ms; }
+
+void HostClock::set(uint32_t ms) { g_host_now_ms = ms; }
+
+void HostClock::advance(uint32_t ms) { g_host_now_ms += ms; }
+
+unsigned long millis() { return g_host_now_ms; }
+
+unsigned long micros() { return static_cast<unsigned long>(g_host_now_ms) * 1000UL; }
+
+void delay(uint32_t ms) { HostClock::advance(ms); }
+
+void delayMicroseconds(uint32_t) {}
+
+void yield() {}
+
+// ============================================================================
+// Random (deterministic so test runs are repeatable)
+// ============================================================================
+
+static uint32_t g_random_state = 0x12345678u;
+
+uint32_t esp_random() {
+    // xorshift32
+    g_random_state ^= g_random_state << 13;
+    g_random_state ^= g_random_state >> 17;
+    g_random_state ^= g_random_state << 5;
+    return g_random_state;
+}
+
+void randomSeed(unsigned long seed) { g_random_state = seed ? static_cast<uint32_t>(seed) : 1; }
+
+long random(long howbig) { return howbig <= 0 ? 0 : static_cast<long>(esp_random() % howbig); }
+
+long random(long howsmall, long howbig) {
+    return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall);
+}
+
+// ============================================================================
+// Pins and serial ports
+// ============================================================================
+
+void pinMode(uint8_t, uint8_t) {}
+
+void digitalWrite(uint8_t, uint8_t) {}
+
+void HardwareSerial::begin(unsigned long, uint32_t, int8_t, int8_t) {}
+
+size_t HardwareSerial::write(uint8_t byte) { return fwrite(&byte, 1, 1, stdout); }
+
+size_t HardwareSerial::write(const uint8_t* data, size_t length) {
+    return fwrite(data, 1, length, stdout);
+}
+
+void HardwareSerial::flush() { fflush(stdout); }
+
+size_t HardwareSerial::print(const char* text) { return fputs(text, stdout) < 0 ? 0 : strlen(text); }
+
+size_t HardwareSerial::println(const char* text) { return print(text) + print("\n"); }
+
+size_t HardwareSerial::printf(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    const int written = vprintf(format, args);
+    va_end(args);
+    return written < 0 ? 0 : static_cast<size_t>(written);
+}
+
+// ============================================================================
+// FreeRTOS
+// ============================================================================
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char*, uint32_t, void*, UBaseType_t,
+                                   TaskHandle_t*, BaseType_t) {
+    // No threads on the host: callers keep running their work from loop()
+    return pdFAIL;
+}
+
+void vTaskDelay(TickType_t ticks) { HostClock::advance(ticks * portTICK_PERIOD_MS); }
+
+TickType_t xTaskGetTickCount() { return g_host_now_ms / portTICK_PERIOD_MS; }
+
+SemaphoreHandle_t xSemaphoreCreateMutex() {
+    static int token;
+    return &token;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t, TickType_t) { return pdTRUE; }
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
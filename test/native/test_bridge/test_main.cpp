@@ -0,0 +1,728 @@
+/**
+ * @file test_main.cpp
+ * @brief ProtocolBridge end to end: TCP client -> queue -> RS485 -> reply
+ *
+ * A scripted inverter answers (or ignores, or refuses) every frame the
+ * bridge puts on the fake RS485 port; clients connect through the AsyncTCP
+ * stand-in. Time only moves in step(), so timeouts are exact.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#include "fake_rs485_port.h"
+#include "host_clock.h"
+#include "modules/protocol_bridge.h"
+#include "modules/rs485_manager.h"
+#include "modules/tcp_server.h"
+#include "test_frames.h"
+
+#include <Esp.h>
+#include <unity.h>
+
+#include <functional>
+
+using namespace TestFrames;
+
+static const uint16_t TEST_PORT = 8000;
+
+// ============================================================================
+// Harness
+// ============================================================================
+
+enum class InverterMode { ANSWER, SILENT, REFUSE };
+
+static FakeRS485Port port;
+static RS485Manager& rs485 = RS485Manager::getInstance();
+static TCPServer& tcp_server = TCPServer::getInstance();
+static ProtocolBridge& bridge = ProtocolBridge::getInstance();
+
+static InverterMode inverter_mode = InverterMode::ANSWER;
+static uint8_t refusal_code = 0x02;
+static uint16_t refused_from = UINT16_MAX; // ANSWER mode refuses reads reaching this register
+static size_t frames_seen = 0;
+static std::vector<BusRequest> bus_requests;
+
+/// Answer the newest frame on the bus the way the inverter is scripted to
+static void inverter_step() {
+    if (port.tx_count() == frames_seen) {
+        return;
+    }
+    const BusRequest request = parse_bus_request(port.tx_frames().back());
+    frames_seen = port.tx_count();
+    if (!request.valid) {
+        return;
+    }
+    bus_requests.push_back(request);
+
+    switch (inverter_mode) {
+        case InverterMode::ANSWER:
+            if (request.function_code == 0x06) {
+                port.receive_frame(write_single_ack(request.start, request.count_or_value));
+            } else if (request.function_code == 0x10) {
+                port.receive_frame(write_multi_ack(request.start, request.count_or_value));
+            } else if (request.start + request.count_or_value > refused_from) {
+                port.receive_frame(
+                    exception_response(request.function_code, request.start, refusal_code));
+            } else {
+                port.receive_frame(
+                    read_response(request.function_code, request.start, request.count_or_value));
+            }
+            break;
+        case InverterMode::REFUSE:
+            port.receive_frame(
+                exception_response(request.function_code, request.start, refusal_code));
+            break;
+        case InverterMode::SILENT:
+            break;
+    }
+}
+
+static void step(uint32_t ms = 10) {
+    HostClock::advance(ms);
+    rs485.loop();
+    inverter_step();
+    tcp_server.loop();
+    bridge.loop();
+}
+
+static bool run_until(const std::function<bool()>& done, uint32_t max_ms = 5000) {
+    for (uint32_t waited = 0; waited < max_ms; waited += 10) {
+        if (done()) {
+            return true;
+        }
+        step();
+    }
+    return done();
+}
+
+static TcpReply request_reply(AsyncClient* client, const std::vector<uint8_t>& request) {
+    client->host_clear_writes();
+    client->host_receive(request.data(), request.size());
+    run_until([client] { return !client->host_writes().empty(); });
+    return client->host_writes().empty() ? TcpReply() : parse_tcp_reply(client->host_writes()[0]);
+}
+
+/// Age everything in the shadow past its cache-first and stale windows
+static void age_cache() { HostClock::advance(CACHE_TTL_INPUT_MS * CACHE_SWR_TTL_FACTOR + 1000); }
+
+static AsyncClient* client_a = nullptr;
+static AsyncClient* client_b = nullptr;
+static AsyncClient* client_idle = nullptr; // Only splits the fair queue share three ways
+
+static void send(AsyncClient* client, const std::vector<uint8_t>& request) {
+    client->host_receive(request.data(), request.size());
+}
+
+static TCPClient& tcp_client(AsyncClient* client) { return *tcp_server.resolve_client(client); }
+
+void setUp() {
+    // Every test starts from an idle bridge with nothing cached or refused,
+    // so none depends on what an earlier one left behind
+    TEST_ASSERT_TRUE(run_until([] { return !bridge.is_busy(); }));
+    inverter_mode = InverterMode::ANSWER;
+    refusal_code = 0x02;
+    refused_from = UINT16_MAX;
+
+    // Once the link is up, one answered read (past the shadow's span) so no
+    // test inherits a run of bus timeouts or an open breaker
+    if (rs485.is_inverter_link_up()) {
+        if (bridge.get_breaker_state() == BreakerState::OPEN) {
+            HostClock::advance(BREAKER_OPEN_MS);
+            step(); // Half-open before the read below arrives, so it probes
+        }
+        TEST_ASSERT_TRUE(
+            request_reply(client_b, tcp_read_request(0x04, 2000, 1)).covers(2000, 1));
+    }
+    ESP.set_free_heap(160 * 1024);
+    tcp_client(client_a).bridge_patience_ms = 0;
+    tcp_client(client_b).bridge_patience_ms = 0;
+    bridge.clear_fallback_cache();
+    bridge.clear_negative_cache();
+    client_a->host_clear_writes();
+    client_b->host_clear_writes();
+    bus_requests.clear();
+}
+
+void tearDown() {}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+void test_link_comes_up_from_serial_probe() {
+    TEST_ASSERT_TRUE(run_until([] { return rs485.is_inverter_link_up(); }));
+}
+
+void test_read_goes_to_bus_and_is_answered() {
+    const TcpReply reply = request_reply(client_a, tcp_read_request(0x04, 0, 40));
+
+    TEST_ASSERT_TRUE(reply.covers(0, 40));
+    TEST_ASSERT_EQUAL_UINT32(1, bus_requests.size());
+    TEST_ASSERT_EQUAL_HEX8(0x04, bus_requests[0].function_code);
+    TEST_ASSERT_EQUAL_UINT16(0, bus_requests[0].start);
+    TEST_ASSERT_EQUAL_UINT16(40, bus_requests[0].count_or_value);
+}
+
+void test_fresh_read_is_answered_from_cache() {
+    TEST_ASSERT_TRUE(request_reply(client_a, tcp_read_request(0x04, 0, 40)).covers(0, 40));
+    bus_requests.clear();
+    const uint32_t hits_before = bridge.get_cache_first_hits();
+
+    const TcpReply reply = request_reply(client_a, tcp_read_request(0x04, 10, 20));
+
+    TEST_ASSERT_TRUE(reply.covers(10, 20));
+    TEST_ASSERT_EQUAL_UINT32(0, bus_requests.size());
+    TEST_ASSERT_EQUAL_UINT32(hits_before + 1, bridge.get_cache_first_hits());
+}
+
+void test_queued_reads_from_two_clients_are_served_in_turn() {
+    const std::vector<uint8_t> read_a = tcp_read_request(0x03, 80, 40);
+    const std::vector<uint8_t> read_b = tcp_read_request(0x04, 160, 40);
+    client_a->host_clear_writes();
+    client_b->host_clear_writes();
+
+    // Both arrive before the worker runs: one waits in the queue
+    client_a->host_receive(read_a.data(), read_a.size());
+    client_b->host_receive(read_b.data(), read_b.size());
+    TEST_ASSERT_TRUE(run_until([] {
+        return !client_a->host_writes().empty() && !client_b->host_writes().empty();
+    }));
+
+    TEST_ASSERT_TRUE(parse_tcp_reply(client_a->host_writes()[0]).covers(80, 40));
+    TEST_ASSERT_TRUE(parse_tcp_reply(client_b->host_writes()[0]).covers(160, 40));
+    TEST_ASSERT_EQUAL_UINT32(2, bus_requests.size());
+}
+
+void test_read_identical_to_one_in_flight_shares_its_bus_read() {
+    const uint32_t coalesced_before = bridge.get_coalesced_requests();
+    send(client_a, tcp_read_request(0x04, 200, 40));
+    TEST_ASSERT_TRUE(run_until([] { return !bus_requests.empty(); }));
+
+    // Client B asks for the same range before the answer is in
+    send(client_b, tcp_read_request(0x04, 200, 40));
+    TEST_ASSERT_TRUE(run_until([] { return !bridge.is_busy(); }));
+
+    TEST_ASSERT_EQUAL_UINT32(1, bus_requests.size());
+    TEST_ASSERT_EQUAL_UINT32(coalesced_before + 1, bridge.get_coalesced_requests());
+    TEST_ASSERT_TRUE(parse_tcp_reply(client_a->host_writes().back()).covers(200, 40));
+    TEST_ASSERT_TRUE(parse_tcp_reply(client_b->host_writes().back()).covers(200, 40));
+}
+
+void test_write_is_acknowledged_with_its_value() {
+    const TcpReply reply = request_reply(client_a, tcp_write_single_request(21, 0x0102));
+
+    TEST_ASSERT_TRUE(reply.valid);
+    TEST_ASSERT_EQUAL_HEX8(0x06, reply.function_code);
+    TEST_ASSERT_EQUAL_UINT16(21, reply.start);
+    TEST_ASSERT_EQUAL_HEX16(0x0102, reply.values[0]);
+    TEST_ASSERT_EQUAL_UINT32(1, bus_requests.size());
+}
+
+void test_timeout_falls_back_to_cached_registers() {
+    TEST_ASSERT_TRUE(request_reply(client_a, tcp_read_request(0x04, 0, 40)).covers(0, 40));
+    age_cache();
+    inverter_mode = InverterMode::SILENT;
+    const uint32_t timeouts_before = rs485.get_timeout_count();
+
+    const TcpReply reply = request_reply(client_a, tcp_read_request(0x04, 0, 40));
+
+    TEST_ASSERT_TRUE(reply.covers(0, 40));
+    TEST_ASSERT_EQUAL_UINT32(timeouts_before + 1, rs485.get_timeout_count());
+    TEST_ASSERT_EQUAL_STRING("CACHE_FALLBACK", bridge.get_last_terminal_state_name());
+}
+
+void test_timeout_without_cached_data_returns_gateway_exception() {
+    inverter_mode = InverterMode::SILENT;
+
+    const TcpReply reply = request_reply(client_a, tcp_read_request(0x04, 400, 10));
+
+    TEST_ASSERT_TRUE(reply.is_exception());
+    TEST_ASSERT_EQUAL_HEX8(0x84, reply.function_code);
+    TEST_ASSERT_EQUAL_HEX8(0x0B, reply.exception_code);
+}
+
+void test_inverter_exception_is_forwarded() {
+    inverter_mode = InverterMode::REFUSE;
+    refusal_code = 0x02;
+
+    const TcpReply reply = request_reply(client_a, tcp_read_request(0x03, 600, 40));
+
+    TEST_ASSERT_TRUE(reply.is_exception());
+    TEST_ASSERT_EQUAL_HEX8(0x83, reply.function_code);
+    TEST_ASSERT_EQUAL_UINT16(600, reply.start);
+    TEST_ASSERT_EQUAL_HEX8(0x02, reply.exception_code);
+    TEST_ASSERT_EQUAL_UINT32(1, bus_requests.size());
+}
+
+void test_exception_on_cached_range_is_forwarded_and_remembered() {
+    // Cached, but too old for cache-first: only the fallback could answer it
+    TEST_ASSERT_TRUE(request_reply(client_a, tcp_read_request(0x04, 240, 40)).covers(240, 40));
+    age_cache();
+    inverter_mode = InverterMode::REFUSE;
+    refusal_code = 0x02;
+    bus_requests.clear();
+
+    TcpReply reply = request_reply(client_a, tcp_read_request(0x04, 240, 40));
+    TEST_ASSERT_TRUE(reply.is_exception());
+    TEST_ASSERT_EQUAL_HEX8(0x84, reply.function_code);
+    TEST_ASSERT_EQUAL_HEX8(0x02, reply.exception_code);
+    TEST_ASSERT_EQUAL_UINT32(1, bus_requests.size());
+
+    // The repeat is answered from the negative cache without the bus
+    const uint32_t hits_before = bridge.get_negative_cache_hits();
+    reply = request_reply(client_a, tcp_read_request(0x04, 240, 40));
+    TEST_ASSERT_TRUE(reply.is_exception());
+    TEST_ASSERT_EQUAL_HEX8(0x02, reply.exception_code);
+    TEST_ASSERT_EQUAL_UINT32(1, bus_requests.size());
+    TEST_ASSERT_EQUAL_UINT32(hits_before + 1, bridge.get_negative_cache_hits());
+}
+
+/// Both clients send their read before the worker runs, so the reads can merge
+static void poll_both(const std::vector<uint8_t>& read_a, const std::vector<uint8_t>& read_b) {
+    client_a->host_clear_writes();
+    client_b->host_clear_writes();
+    client_a->host_receive(read_a.data(), read_a.size());
+    client_b->host_receive(read_b.data(), read_b.size());
+    TEST_ASSERT_TRUE(run_until([] {
+        return !client_a->host_writes().empty() && !client_b->host_writes().empty();
+    }));
+}
+
+void test_refused_bank_aligned_read_is_remembered_for_client_range() {
+    inverter_mode = InverterMode::REFUSE;
+    refusal_code = 0x02;
+
+    // Aligned to 1200-1239 first, refused, then re-read as requested
+    TcpReply reply = request_reply(client_a, tcp_read_request(0x04, 1210, 10));
+    TEST_ASSERT_TRUE(reply.is_exception());
+    TEST_ASSERT_EQUAL_UINT16(1210, reply.start);
+    TEST_ASSERT_EQUAL_UINT32(2, bus_requests.size());
+    TEST_ASSERT_EQUAL_UINT16(1200, bus_requests[0].start);
+    TEST_ASSERT_EQUAL_UINT16(1210, bus_requests[1].start);
+
+    const uint32_t hits_before = bridge.get_negative_cache_hits();
+    reply = request_reply(client_a, tcp_read_request(0x04, 1210, 10));
+    TEST_ASSERT_TRUE(reply.is_exception());
+    TEST_ASSERT_EQUAL_UINT32(2, bus_requests.size());
+    TEST_ASSERT_EQUAL_UINT32(hits_before + 1, bridge.get_negative_cache_hits());
+}
+
+void test_refused_merged_read_is_split_per_client() {
+    refused_from = 1040; // 1000-1039 reads fine, anything reaching 1040 is refused
+    refusal_code = 0x02;
+    const std::vector<uint8_t> read_a = tcp_read_request(0x04, 1000, 40);
+    const std::vector<uint8_t> read_b = tcp_read_request(0x04, 1040, 40);
+    const uint32_t refusals_before = bridge.get_merge_refusals();
+
+    // One merged bus read, refused, then each client's range read on its own
+    poll_both(read_a, read_b);
+    TEST_ASSERT_EQUAL_UINT32(refusals_before + 1, bridge.get_merge_refusals());
+    TEST_ASSERT_EQUAL_UINT32(3, bus_requests.size());
+    TEST_ASSERT_EQUAL_UINT16(80, bus_requests[0].count_or_value);
+    TEST_ASSERT_EQUAL_UINT32(1000 + 1040, bus_requests[1].start + bus_requests[2].start);
+    TEST_ASSERT_EQUAL_UINT16(40, bus_requests[1].count_or_value);
+    TEST_ASSERT_EQUAL_UINT16(40, bus_requests[2].count_or_value);
+    TEST_ASSERT_TRUE(parse_tcp_reply(client_a->host_writes()[0]).covers(1000, 40));
+    TEST_ASSERT_TRUE(parse_tcp_reply(client_b->host_writes()[0]).is_exception());
+    TEST_ASSERT_EQUAL_UINT16(1040, parse_tcp_reply(client_b->host_writes()[0]).start);
+
+    // The refused union is not merged again: client A's range is read alone...
+    age_cache();
+    bus_requests.clear();
+    const uint32_t hits_before = bridge.get_negative_cache_hits();
+    poll_both(read_a, read_b);
+    TEST_ASSERT_TRUE(parse_tcp_reply(client_a->host_writes()[0]).covers(1000, 40));
+    TEST_ASSERT_TRUE(parse_tcp_reply(client_b->host_writes()[0]).is_exception());
+    TEST_ASSERT_EQUAL_UINT32(1, bus_requests.size());
+    TEST_ASSERT_EQUAL_UINT16(1000, bus_requests[0].start);
+    TEST_ASSERT_EQUAL_UINT16(40, bus_requests[0].count_or_value);
+
+    // ...and client B's range is answered locally
+    TEST_ASSERT_EQUAL_UINT32(hits_before + 1, bridge.get_negative_cache_hits());
+}
+
+/// Put an unanswered read from @p client on the bus, so requests sent next queue behind it
+static void occupy_bus(AsyncClient* client, uint16_t start) {
+    inverter_mode = InverterMode::SILENT;
+    send(client, tcp_read_request(0x04, start, 10));
+    const size_t seen = bus_requests.size();
+    TEST_ASSERT_TRUE(run_until([seen] { return bus_requests.size() > seen; }));
+}
+
+static void run_for(uint32_t ms) {
+    for (uint32_t elapsed = 0; elapsed < ms; elapsed += 10) {
+        step();
+    }
+}
+
+void test_writes_and_small_reads_go_before_bank_polls() {
+    const uint32_t reordered_before = bridge.get_reordered_requests();
+
+    // Queued in the opposite order to how they should reach the bus
+    occupy_bus(client_b, 400);
+    inverter_mode = InverterMode::ANSWER;
+    send(client_a, tcp_read_request(0x04, 200, 40));
+    step();
+    send(client_a, tcp_read_request(0x03, 300, 2));
+    step();
+    send(client_a, tcp_write_single_request(21, 0x0102));
+    TEST_ASSERT_TRUE(run_until([] { return client_a->host_writes().size() == 3; }));
+
+    TEST_ASSERT_EQUAL_UINT32(4, bus_requests.size());
+    TEST_ASSERT_EQUAL_HEX8(0x06, bus_requests[1].function_code);
+    TEST_ASSERT_EQUAL_HEX8(0x03, bus_requests[2].function_code);
+    TEST_ASSERT_EQUAL_HEX8(0x04, bus_requests[3].function_code);
+    TEST_ASSERT_EQUAL_UINT16(200, bus_requests[3].start);
+    TEST_ASSERT_EQUAL_UINT32(reordered_before + 2, bridge.get_reordered_requests());
+}
+
+void test_patience_is_learned_per_client() {
+    // Client A's read waits behind client B's, and A re-sends it unanswered
+    const std::vector<uint8_t> read_a = tcp_read_request(0x04, 500, 10);
+    occupy_bus(client_b, 400);
+    send(client_a, read_a);
+    run_for(1200);
+    TEST_ASSERT_TRUE(client_a->host_writes().empty());
+    send(client_a, read_a);
+    TEST_ASSERT_TRUE(run_until([] { return !bridge.is_busy(); }));
+
+    const uint32_t patience = tcp_client(client_a).bridge_patience_ms;
+    TEST_ASSERT_TRUE(patience >= (3 * CLIENT_PATIENCE_MS + 1100) / 4);
+    TEST_ASSERT_TRUE(patience <= (3 * CLIENT_PATIENCE_MS + 1300) / 4);
+    TEST_ASSERT_EQUAL_UINT32(0, tcp_client(client_b).bridge_patience_ms);
+}
+
+void test_request_past_its_deadline_is_answered_busy() {
+    tcp_client(client_a).bridge_patience_ms = CLIENT_PATIENCE_MIN_MS;
+    const uint32_t drops_before = bridge.get_deadline_drops();
+
+    // Client B's read times out on the bus; client A's, queued behind it, is
+    // out of time by then and is told the gateway is busy without the bus
+    occupy_bus(client_b, 400);
+    send(client_a, tcp_read_request(0x04, 500, 10));
+    TEST_ASSERT_TRUE(run_until([] { return !client_a->host_writes().empty(); }));
+    const TcpReply reply = parse_tcp_reply(client_a->host_writes()[0]);
+    TEST_ASSERT_TRUE(reply.is_exception());
+    TEST_ASSERT_EQUAL_HEX8(0x06, reply.exception_code);
+    TEST_ASSERT_EQUAL_UINT16(500, reply.start);
+    TEST_ASSERT_EQUAL_UINT32(1, bus_requests.size());
+    TEST_ASSERT_EQUAL_UINT32(drops_before + 1, bridge.get_deadline_drops());
+
+    // Client B keeps the default patience, so the same wait is fine for it
+    TEST_ASSERT_TRUE(run_until([] { return !bridge.is_busy(); }));
+    occupy_bus(client_a, 400);
+    inverter_mode = InverterMode::ANSWER;
+    client_b->host_clear_writes();
+    TEST_ASSERT_TRUE(request_reply(client_b, tcp_read_request(0x04, 500, 10)).covers(500, 10));
+    TEST_ASSERT_EQUAL_UINT32(drops_before + 1, bridge.get_deadline_drops());
+}
+
+void test_client_over_its_share_is_told_busy_but_may_still_write() {
+    // Client B's read holds the bus while client A fills its third of the
+    // read slots, which with three clients is as much as a write would get
+    occupy_bus(client_b, 400);
+    const uint16_t share = (BRIDGE_QUEUE_MAX_DEPTH - 1) / 3;
+    TEST_ASSERT_EQUAL_UINT16(BRIDGE_QUEUE_MAX_DEPTH / 3, share);
+    for (uint16_t i = 0; i < share; i++) {
+        send(client_a, tcp_read_request(0x04, 40 * i, 40));
+        step();
+    }
+    TEST_ASSERT_TRUE(client_a->host_writes().empty());
+
+    // One read more is refused at once with a busy exception...
+    send(client_a, tcp_read_request(0x03, 300, 2));
+    step();
+    TEST_ASSERT_EQUAL_UINT32(1, client_a->host_writes().size());
+    const TcpReply busy = parse_tcp_reply(client_a->host_writes()[0]);
+    TEST_ASSERT_TRUE(busy.is_exception());
+    TEST_ASSERT_EQUAL_HEX8(0x83, busy.function_code);
+    TEST_ASSERT_EQUAL_HEX8(0x06, busy.exception_code);
+
+    // ...but a write is queued, and is the first thing on the bus after B's read
+    client_a->host_clear_writes();
+    inverter_mode = InverterMode::ANSWER;
+    send(client_a, tcp_write_single_request(21, 0x0102));
+    TEST_ASSERT_TRUE(run_until([] { return !bridge.is_busy(); }));
+    TEST_ASSERT_EQUAL_HEX8(0x06, bus_requests[1].function_code);
+    TEST_ASSERT_EQUAL_HEX16(0x0102, bus_requests[1].count_or_value);
+}
+
+void test_writes_from_two_clients_keep_arrival_order() {
+    // Client B was served longest ago, but client A wrote the register first
+    occupy_bus(client_a, 400);
+    send(client_a, tcp_write_single_request(21, 0x0001));
+    step();
+    send(client_b, tcp_write_single_request(21, 0x0002));
+    inverter_mode = InverterMode::ANSWER;
+    TEST_ASSERT_TRUE(run_until([] { return !bridge.is_busy(); }));
+
+    // The later value is the one the inverter keeps; each client gets its own
+    TEST_ASSERT_EQUAL_HEX8(0x06, bus_requests.back().function_code);
+    TEST_ASSERT_EQUAL_HEX16(0x0002, bus_requests.back().count_or_value);
+    TEST_ASSERT_EQUAL_HEX16(0x0001, parse_tcp_reply(client_a->host_writes().back()).values[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0002, parse_tcp_reply(client_b->host_writes().back()).values[0]);
+}
+
+void test_superseded_write_is_acked_with_the_value_it_carried() {
+    const uint32_t superseded_before = bridge.get_superseded_writes();
+    occupy_bus(client_b, 400);
+    send(client_a, tcp_write_single_request(21, 0x0001));
+    step();
+    send(client_a, tcp_write_single_request(21, 0x0003));
+    inverter_mode = InverterMode::ANSWER;
+    TEST_ASSERT_TRUE(run_until([] { return !bridge.is_busy(); }));
+
+    // Only the last value goes to the bus; both writes are acknowledged
+    TEST_ASSERT_EQUAL_UINT32(2, bus_requests.size());
+    TEST_ASSERT_EQUAL_HEX8(0x06, bus_requests[1].function_code);
+    TEST_ASSERT_EQUAL_HEX16(0x0003, bus_requests[1].count_or_value);
+    TEST_ASSERT_EQUAL_UINT32(superseded_before + 1, bridge.get_superseded_writes());
+    TEST_ASSERT_EQUAL_UINT32(2, client_a->host_writes().size());
+    TEST_ASSERT_EQUAL_HEX16(0x0001, parse_tcp_reply(client_a->host_writes()[0]).values[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0003, parse_tcp_reply(client_a->host_writes()[1]).values[0]);
+}
+
+/// Queue single writes to registers 21 and 22 from clients A and B behind a busy bus
+static void queue_neighbouring_writes() {
+    occupy_bus(client_a, 400);
+    send(client_a, tcp_write_single_request(21, 0x0101));
+    step();
+    send(client_b, tcp_write_single_request(22, 0x0202));
+    step();
+}
+
+void test_contiguous_writes_reach_the_bus_as_one_frame() {
+    const uint32_t combined_before = bridge.get_combined_writes();
+    queue_neighbouring_writes();
+    inverter_mode = InverterMode::ANSWER;
+    TEST_ASSERT_TRUE(run_until([] { return !bridge.is_busy(); }));
+
+    TEST_ASSERT_EQUAL_UINT32(2, bus_requests.size());
+    TEST_ASSERT_EQUAL_HEX8(0x10, bus_requests[1].function_code);
+    TEST_ASSERT_EQUAL_UINT16(21, bus_requests[1].start);
+    TEST_ASSERT_EQUAL_UINT16(2, bus_requests[1].count_or_value);
+    TEST_ASSERT_EQUAL_UINT32(2, bus_requests[1].values.size());
+    TEST_ASSERT_EQUAL_HEX16(0x0101, bus_requests[1].values[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0202, bus_requests[1].values[1]);
+    TEST_ASSERT_EQUAL_UINT32(combined_before + 1, bridge.get_combined_writes());
+
+    // Each client is acknowledged once, as if its own single write had gone out
+    TEST_ASSERT_EQUAL_UINT32(2, client_a->host_writes().size()); // After the occupying read
+    TEST_ASSERT_EQUAL_UINT32(1, client_b->host_writes().size());
+    const TcpReply ack_a = parse_tcp_reply(client_a->host_writes().back());
+    const TcpReply ack_b = parse_tcp_reply(client_b->host_writes().back());
+    TEST_ASSERT_EQUAL_HEX8(0x06, ack_a.function_code);
+    TEST_ASSERT_EQUAL_UINT16(21, ack_a.start);
+    TEST_ASSERT_EQUAL_HEX16(0x0101, ack_a.values[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x06, ack_b.function_code);
+    TEST_ASSERT_EQUAL_UINT16(22, ack_b.start);
+    TEST_ASSERT_EQUAL_HEX16(0x0202, ack_b.values[0]);
+}
+
+void test_refused_combined_write_answers_every_client() {
+    queue_neighbouring_writes();
+    inverter_mode = InverterMode::REFUSE;
+    refusal_code = 0x04;
+    TEST_ASSERT_TRUE(run_until([] { return !bridge.is_busy(); }));
+
+    TEST_ASSERT_EQUAL_UINT32(2, bus_requests.size());
+    TEST_ASSERT_EQUAL_HEX8(0x10, bus_requests[1].function_code);
+    TEST_ASSERT_EQUAL_UINT32(2, client_a->host_writes().size());
+    TEST_ASSERT_EQUAL_UINT32(1, client_b->host_writes().size());
+    const TcpReply refused_a = parse_tcp_reply(client_a->host_writes().back());
+    const TcpReply refused_b = parse_tcp_reply(client_b->host_writes().back());
+    TEST_ASSERT_EQUAL_HEX8(0x86, refused_a.function_code);
+    TEST_ASSERT_EQUAL_UINT16(21, refused_a.start);
+    TEST_ASSERT_EQUAL_HEX8(0x04, refused_a.exception_code);
+    TEST_ASSERT_EQUAL_HEX8(0x86, refused_b.function_code);
+    TEST_ASSERT_EQUAL_UINT16(22, refused_b.start);
+    TEST_ASSERT_EQUAL_HEX8(0x04, refused_b.exception_code);
+}
+
+void test_combined_write_is_written_through_to_cache() {
+    const uint32_t updates_before = bridge.get_cache_write_updates();
+    queue_neighbouring_writes();
+    inverter_mode = InverterMode::ANSWER;
+    TEST_ASSERT_TRUE(run_until([] { return !bridge.is_busy(); }));
+    TEST_ASSERT_EQUAL_UINT32(updates_before + 2, bridge.get_cache_write_updates());
+
+    // Both written values are served back without another bus read
+    const size_t bus_before = bus_requests.size();
+    const TcpReply read = request_reply(client_a, tcp_read_request(0x03, 21, 2));
+    TEST_ASSERT_EQUAL_UINT32(bus_before, bus_requests.size());
+    TEST_ASSERT_EQUAL_HEX8(0x03, read.function_code);
+    TEST_ASSERT_EQUAL_UINT32(2, read.values.size());
+    TEST_ASSERT_EQUAL_HEX16(0x0101, read.values[0]);
+    TEST_ASSERT_EQUAL_HEX16(0x0202, read.values[1]);
+}
+
+void test_stale_read_is_refreshed_once_without_a_phantom_client() {
+    TEST_ASSERT_TRUE(request_reply(client_a, tcp_read_request(0x04, 0, 40)).covers(0, 40));
+    HostClock::advance(CACHE_TTL_INPUT_MS + 500); // Past the TTL, within the hard TTL
+    const uint32_t refreshes_before = bridge.get_stale_refreshes();
+    const uint32_t gone_before = bridge.get_client_gone_count();
+
+    // Both stale reads are answered from the cache at once; the refresh they
+    // trigger is queued behind client B's read only once
+    occupy_bus(client_b, 400);
+    client_a->host_clear_writes();
+    for (int i = 0; i < 2; i++) {
+        send(client_a, tcp_read_request(0x04, 0, 40));
+        step();
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, client_a->host_writes().size());
+    TEST_ASSERT_TRUE(parse_tcp_reply(client_a->host_writes()[1]).covers(0, 40));
+    TEST_ASSERT_EQUAL_UINT32(refreshes_before + 1, bridge.get_stale_refreshes());
+
+    // Client B's small uncached read goes first and absorbs the refresh,
+    // which has no client of its own to answer
+    send(client_b, tcp_read_request(0x04, 40, 10));
+    inverter_mode = InverterMode::ANSWER;
+    TEST_ASSERT_TRUE(run_until([] { return !bridge.is_busy(); }));
+    TEST_ASSERT_TRUE(parse_tcp_reply(client_b->host_writes().back()).covers(40, 10));
+    TEST_ASSERT_EQUAL_UINT32(3, bus_requests.size());
+    TEST_ASSERT_EQUAL_UINT16(0, bus_requests[2].start);
+    TEST_ASSERT_EQUAL_UINT16(80, bus_requests[2].count_or_value);
+    TEST_ASSERT_EQUAL_UINT32(gone_before, bridge.get_client_gone_count());
+}
+
+/// Time out BREAKER_TIMEOUT_THRESHOLD uncached reads in a row
+static void time_out_reads() {
+    inverter_mode = InverterMode::SILENT;
+    for (uint16_t i = 0; i < BREAKER_TIMEOUT_THRESHOLD; i++) {
+        const TcpReply reply = request_reply(client_a, tcp_read_request(0x04, 400 + 40 * i, 10));
+        TEST_ASSERT_EQUAL_HEX8(0x0B, reply.exception_code);
+    }
+}
+
+void test_breaker_opens_after_consecutive_timeouts() {
+    const uint32_t opens_before = bridge.get_breaker_opens();
+    inverter_mode = InverterMode::SILENT;
+    for (uint16_t i = 0; i + 1 < BREAKER_TIMEOUT_THRESHOLD; i++) {
+        request_reply(client_a, tcp_read_request(0x04, 400 + 40 * i, 10));
+    }
+    TEST_ASSERT_EQUAL(BreakerState::CLOSED, bridge.get_breaker_state());
+
+    request_reply(client_a, tcp_read_request(0x04, 600, 10));
+    TEST_ASSERT_EQUAL(BreakerState::OPEN, bridge.get_breaker_state());
+    TEST_ASSERT_EQUAL_UINT32(opens_before + 1, bridge.get_breaker_opens());
+}
+
+void test_open_breaker_answers_reads_without_touching_the_bus() {
+    // Past the stale window, so only the fallback copy can answer
+    TEST_ASSERT_TRUE(request_reply(client_a, tcp_read_request(0x04, 0, 40)).covers(0, 40));
+    age_cache();
+    time_out_reads();
+    TEST_ASSERT_EQUAL(BreakerState::OPEN, bridge.get_breaker_state());
+
+    const size_t bus_before = bus_requests.size();
+    const uint32_t fast_fails_before = bridge.get_breaker_fast_fails();
+    TEST_ASSERT_TRUE(request_reply(client_a, tcp_read_request(0x04, 0, 40)).covers(0, 40));
+    const TcpReply refused = request_reply(client_b, tcp_read_request(0x04, 600, 10));
+    TEST_ASSERT_TRUE(refused.is_exception());
+    TEST_ASSERT_EQUAL_HEX8(0x0B, refused.exception_code);
+    TEST_ASSERT_EQUAL_UINT32(bus_before, bus_requests.size());
+    TEST_ASSERT_EQUAL_UINT32(fast_fails_before + 2, bridge.get_breaker_fast_fails());
+}
+
+void test_half_open_probe_reopens_on_timeout_and_closes_on_reply() {
+    time_out_reads();
+    const uint32_t opens_before = bridge.get_breaker_opens();
+    HostClock::advance(BREAKER_OPEN_MS);
+    step();
+    TEST_ASSERT_EQUAL(BreakerState::HALF_OPEN, bridge.get_breaker_state());
+
+    // Only the first of two reads probes the bus; its timeout reopens the
+    // breaker and the second is answered without going out
+    const size_t bus_before = bus_requests.size();
+    client_a->host_clear_writes();
+    send(client_a, tcp_read_request(0x04, 600, 10));
+    step();
+    send(client_b, tcp_read_request(0x04, 640, 10));
+    TEST_ASSERT_TRUE(run_until([] { return !bridge.is_busy(); }));
+    TEST_ASSERT_EQUAL_UINT32(bus_before + 1, bus_requests.size());
+    TEST_ASSERT_EQUAL_HEX8(0x0B, parse_tcp_reply(client_a->host_writes().back()).exception_code);
+    TEST_ASSERT_EQUAL_HEX8(0x0B, parse_tcp_reply(client_b->host_writes().back()).exception_code);
+    TEST_ASSERT_EQUAL(BreakerState::OPEN, bridge.get_breaker_state());
+    TEST_ASSERT_EQUAL_UINT32(opens_before + 1, bridge.get_breaker_opens());
+
+    // The next probe is answered and closes it
+    HostClock::advance(BREAKER_OPEN_MS);
+    step();
+    inverter_mode = InverterMode::ANSWER;
+    TEST_ASSERT_TRUE(request_reply(client_a, tcp_read_request(0x04, 600, 10)).covers(600, 10));
+    TEST_ASSERT_EQUAL_UINT32(bus_before + 2, bus_requests.size());
+    TEST_ASSERT_EQUAL(BreakerState::CLOSED, bridge.get_breaker_state());
+}
+
+void test_cache_capacity_follows_free_heap() {
+    const size_t full = 2 * RegisterShadow::REGISTERS_PER_TABLE;
+    const size_t minimum = 2 * RegisterShadow::MIN_REGISTERS_PER_TABLE;
+    const uint32_t resizes_before = bridge.get_cache_resizes();
+    TEST_ASSERT_EQUAL_UINT32(full, bridge.get_cache_capacity());
+
+    // A bank past the minimum span is dropped when the heap runs low
+    TEST_ASSERT_TRUE(request_reply(client_a, tcp_read_request(0x04, 280, 40)).covers(280, 40));
+    TEST_ASSERT_TRUE(request_reply(client_a, tcp_read_request(0x04, 0, 40)).covers(0, 40));
+    const uint32_t evictions_before = bridge.get_cache_invalidations();
+
+    ESP.set_free_heap(SHADOW_HEAP_RESERVE / 2);
+    HostClock::advance(SHADOW_RESIZE_MS);
+    step();
+    TEST_ASSERT_EQUAL_UINT32(minimum, bridge.get_cache_capacity());
+    TEST_ASSERT_EQUAL_UINT32(resizes_before + 1, bridge.get_cache_resizes());
+    TEST_ASSERT_EQUAL_UINT32(40, bridge.get_cache_size());
+    TEST_ASSERT_EQUAL_UINT32(evictions_before + 40, bridge.get_cache_invalidations());
+
+    // Nothing changes between checks, and the shadow grows back with the heap
+    ESP.set_free_heap(160 * 1024);
+    step();
+    TEST_ASSERT_EQUAL_UINT32(minimum, bridge.get_cache_capacity());
+    HostClock::advance(SHADOW_RESIZE_MS);
+    step();
+    TEST_ASSERT_EQUAL_UINT32(full, bridge.get_cache_capacity());
+    TEST_ASSERT_EQUAL_UINT32(resizes_before + 2, bridge.get_cache_resizes());
+}
+
+int main() {
+    rs485.begin(port);
+    tcp_server.begin(TEST_PORT, TCP_MAX_CLIENTS);
+    tcp_server.accept_connections();
+    bridge.begin(TEST_DONGLE_SERIAL);
+    bridge.set_tcp_server(&tcp_server);
+    bridge.set_rs485_manager(&rs485);
+    tcp_server.set_bridge(&bridge);
+    client_a = AsyncServer::host_connect(TEST_PORT);
+    client_b = AsyncServer::host_connect(TEST_PORT);
+    client_idle = AsyncServer::host_connect(TEST_PORT);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_link_comes_up_from_serial_probe);
+    RUN_TEST(test_read_goes_to_bus_and_is_answered);
+    RUN_TEST(test_fresh_read_is_answered_from_cache);
+    RUN_TEST(test_queued_reads_from_two_clients_are_served_in_turn);
+    RUN_TEST(test_read_identical_to_one_in_flight_shares_its_bus_read);
+    RUN_TEST(test_write_is_acknowledged_with_its_value);
+    RUN_TEST(test_timeout_falls_back_to_cached_registers);
+    RUN_TEST(test_timeout_without_cached_data_returns_gateway_exception);
+    RUN_TEST(test_inverter_exception_is_forwarded);
+    RUN_TEST(test_exception_on_cached_range_is_forwarded_and_remembered);
+    RUN_TEST(test_refused_bank_aligned_read_is_remembered_for_client_range);
+    RUN_TEST(test_refused_merged_read_is_split_per_client);
+    RUN_TEST(test_writes_and_small_reads_go_before_bank_polls);
+    RUN_TEST(test_patience_is_learned_per_client);
+    RUN_TEST(test_request_past_its_deadline_is_answered_busy);
+    RUN_TEST(test_client_over_its_share_is_told_busy_but_may_still_write);
+    RUN_TEST(test_writes_from_two_clients_keep_arrival_order);
+    RUN_TEST(test_superseded_write_is_acked_with_the_value_it_carried);
+    RUN_TEST(test_contiguous_writes_reach_the_bus_as_one_frame);
+    RUN_TEST(test_refused_combined_write_answers_every_client);
+    RUN_TEST(test_combined_write_is_written_through_to_cache);
+    RUN_TEST(test_stale_read_is_refreshed_once_without_a_phantom_client);
+    RUN_TEST(test_breaker_opens_after_consecutive_timeouts);
+    RUN_TEST(test_open_breaker_answers_reads_without_touching_the_bus);
+    RUN_TEST(test_half_open_probe_reopens_on_timeout_and_closes_on_reply);
+    RUN_TEST(test_cache_capacity_follows_free_heap);
+    return UNITY_END();
+}
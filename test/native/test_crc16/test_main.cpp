@@ -0,0 +1,139 @@
+/**
+ * @file test_main.cpp
+ * @brief CRC16-Modbus: table-driven implementation vs. the bitwise reference
+ *
+ * Checks that the lookup table, the incremental API, the constexpr fold and
+ * the 16-byte span shortcut all agree with the classic bit-by-bit loop, then
+ * times table vs. bitwise on a request-sized (18 byte) and a maximum read
+ * response (267 byte) frame.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#include "host_bench.h"
+#include "utils/crc16.h"
+
+#include <unity.h>
+
+#include <vector>
+
+/// The loop CRC16::calculate() used before the lookup table
+static uint16_t crc16_bitwise(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1) ? static_cast<uint16_t>((crc >> 1) ^ 0xA001)
+                            : static_cast<uint16_t>(crc >> 1);
+        }
+    }
+    return crc;
+}
+
+static std::vector<uint8_t> pseudo_random_bytes(size_t length, uint32_t seed) {
+    std::vector<uint8_t> bytes(length);
+    for (size_t i = 0; i < length; i++) {
+        seed = seed * 1103515245u + 12345u;
+        bytes[i] = static_cast<uint8_t>(seed >> 16);
+    }
+    return bytes;
+}
+
+// 18-byte read request and 267-byte read response (15 header + 125 registers + CRC)
+static const size_t REQUEST_FRAME_SIZE = 18;
+static const size_t MAX_RESPONSE_FRAME_SIZE = 267;
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// Equivalence
+// ============================================================================
+
+void test_known_check_value() {
+    const uint8_t check[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    TEST_ASSERT_EQUAL_HEX16(0x4B37, CRC16::calculate(check, sizeof(check)));
+    TEST_ASSERT_EQUAL_HEX16(0x4B37, crc16_bitwise(check, sizeof(check)));
+}
+
+void test_table_matches_bitwise_for_all_lengths() {
+    const std::vector<uint8_t> data = pseudo_random_bytes(MAX_RESPONSE_FRAME_SIZE, 1);
+    for (size_t length = 0; length <= data.size(); length++) {
+        TEST_ASSERT_EQUAL_HEX16(crc16_bitwise(data.data(), length),
+                                CRC16::calculate(data.data(), length));
+    }
+}
+
+void test_incremental_update_matches_one_shot() {
+    const std::vector<uint8_t> data = pseudo_random_bytes(MAX_RESPONSE_FRAME_SIZE, 2);
+    const uint16_t expected = crc16_bitwise(data.data(), data.size());
+
+    uint16_t per_byte = CRC16::init();
+    for (uint8_t byte : data) {
+        per_byte = CRC16::update(per_byte, byte);
+    }
+    TEST_ASSERT_EQUAL_HEX16(expected, CRC16::finalize(per_byte));
+
+    uint16_t chunked = CRC16::init();
+    chunked = CRC16::update(chunked, data.data(), 15);
+    chunked = CRC16::update(chunked, data.data() + 15, data.size() - 15);
+    TEST_ASSERT_EQUAL_HEX16(expected, CRC16::finalize(chunked));
+}
+
+void test_constexpr_fold_matches_table() {
+    for (uint32_t crc = 0; crc <= 0xFFFF; crc += 0x0101) {
+        for (uint32_t byte = 0; byte <= 0xFF; byte++) {
+            TEST_ASSERT_EQUAL_HEX16(CRC16::update(static_cast<uint16_t>(crc), byte),
+                                    CRC16::fold(static_cast<uint16_t>(crc), byte));
+        }
+    }
+}
+
+void test_span16_from_prefix_matches_direct_crc() {
+    const std::vector<uint8_t> data = pseudo_random_bytes(64, 3);
+    std::vector<uint16_t> prefix(data.size() + 1, 0);
+    for (size_t i = 0; i < data.size(); i++) {
+        prefix[i + 1] = CRC16::update(prefix[i], data[i]);
+    }
+    for (size_t start = 0; start + 16 <= data.size(); start++) {
+        TEST_ASSERT_EQUAL_HEX16(crc16_bitwise(data.data() + start, 16),
+                                CRC16::span16_from_prefix(prefix[start], prefix[start + 16]));
+    }
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+static void benchmark_frame(size_t length, const char* label) {
+    const std::vector<uint8_t> frame = pseudo_random_bytes(length, 4);
+    const uint32_t iterations = 2000000 / length;
+
+    const double table_ns = HostBench::ns_per_call(
+        [&frame] { return CRC16::calculate(frame.data(), frame.size()); }, iterations);
+    const double bitwise_ns = HostBench::ns_per_call(
+        [&frame] { return crc16_bitwise(frame.data(), frame.size()); }, iterations);
+
+    HostBench::report(label, "table", table_ns, "bitwise", bitwise_ns);
+    TEST_ASSERT_TRUE_MESSAGE(table_ns < bitwise_ns, "table CRC slower than bitwise");
+}
+
+void test_benchmark_request_frame() { benchmark_frame(REQUEST_FRAME_SIZE, "CRC 18 B"); }
+
+void test_benchmark_max_response_frame() {
+    benchmark_frame(MAX_RESPONSE_FRAME_SIZE, "CRC 267 B");
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_known_check_value);
+    RUN_TEST(test_table_matches_bitwise_for_all_lengths);
+    RUN_TEST(test_incremental_update_matches_one_shot);
+    RUN_TEST(test_constexpr_fold_matches_table);
+    RUN_TEST(test_span16_from_prefix_matches_direct_crc);
+    RUN_TEST(test_benchmark_request_frame);
+    RUN_TEST(test_benchmark_max_response_frame);
+    return UNITY_END();
+}
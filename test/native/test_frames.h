@@ -0,0 +1,211 @@
+/**
+ * @file test_frames.h
+ * @brief Frame builders and parsers shared by the native test suites
+ *
+ * Built by hand from the documented layouts (not through the encoders under
+ * test). Inverter register N always holds 0x1000 + N, so any reply can be
+ * checked against the range it claims to cover.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#pragma once
+
+#include "utils/crc16.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace TestFrames {
+
+static const uint8_t TEST_INVERTER_SERIAL[10] = {'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J'};
+static const char TEST_DONGLE_SERIAL[] = "0123456789";
+
+inline uint16_t register_value(uint16_t reg) { return static_cast<uint16_t>(0x1000 + reg); }
+
+inline void put_le16(std::vector<uint8_t>& frame, uint16_t value) {
+    frame.push_back(static_cast<uint8_t>(value & 0xFF));
+    frame.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+inline uint16_t get_le16(const std::vector<uint8_t>& frame, size_t offset) {
+    return static_cast<uint16_t>(frame[offset] | (frame[offset + 1] << 8));
+}
+
+inline void append_crc(std::vector<uint8_t>& frame, size_t from = 0) {
+    put_le16(frame, CRC16::calculate(frame.data() + from, frame.size() - from));
+}
+
+// ============================================================================
+// Inverter (RS485) side
+// ============================================================================
+
+/// Inverter header: [0x01][func][serial x10][start LE]
+inline std::vector<uint8_t> inverter_header(uint8_t function_code, uint16_t start) {
+    std::vector<uint8_t> frame;
+    frame.push_back(0x01);
+    frame.push_back(function_code);
+    frame.insert(frame.end(), TEST_INVERTER_SERIAL, TEST_INVERTER_SERIAL + 10);
+    put_le16(frame, start);
+    return frame;
+}
+
+/// Read response: header, byte count, registers (little-endian), CRC
+inline std::vector<uint8_t> read_response(uint8_t function_code, uint16_t start,
+                                          uint16_t count) {
+    std::vector<uint8_t> frame = inverter_header(function_code, start);
+    frame.push_back(static_cast<uint8_t>(count * 2));
+    for (uint16_t i = 0; i < count; i++) {
+        put_le16(frame, register_value(static_cast<uint16_t>(start + i)));
+    }
+    append_crc(frame);
+    return frame;
+}
+
+/// Exception response: header with func | 0x80, exception code, CRC
+inline std::vector<uint8_t> exception_response(uint8_t function_code, uint16_t start,
+                                               uint8_t exception_code) {
+    std::vector<uint8_t> frame = inverter_header(function_code | 0x80, start);
+    frame.push_back(exception_code);
+    append_crc(frame);
+    return frame;
+}
+
+/// Write single register acknowledgement: header, value, CRC
+inline std::vector<uint8_t> write_single_ack(uint16_t reg, uint16_t value) {
+    std::vector<uint8_t> frame = inverter_header(0x06, reg);
+    put_le16(frame, value);
+    append_crc(frame);
+    return frame;
+}
+
+/// Write multiple registers acknowledgement: header, register count, CRC
+inline std::vector<uint8_t> write_multi_ack(uint16_t start, uint16_t count) {
+    std::vector<uint8_t> frame = inverter_header(0x10, start);
+    put_le16(frame, count);
+    append_crc(frame);
+    return frame;
+}
+
+/// Request to the inverter: [0x00][func][serial x10][start LE][count/value LE][CRC]
+inline std::vector<uint8_t> bus_request(uint8_t function_code, uint16_t start,
+                                        uint16_t count_or_value,
+                                        const uint8_t* serial = TEST_INVERTER_SERIAL) {
+    std::vector<uint8_t> frame;
+    frame.push_back(0x00);
+    frame.push_back(function_code);
+    frame.insert(frame.end(), serial, serial + 10);
+    put_le16(frame, start);
+    put_le16(frame, count_or_value);
+    append_crc(frame);
+    return frame;
+}
+
+struct BusRequest {
+    bool valid = false;
+    uint8_t function_code = 0;
+    uint16_t start = 0;
+    uint16_t count_or_value = 0;
+    std::vector<uint16_t> values; // Registers written by a 0x10 request
+};
+
+inline BusRequest parse_bus_request(const std::vector<uint8_t>& frame) {
+    BusRequest request;
+    if (frame.size() < 18 || CRC16::calculate(frame.data(), frame.size()) != 0) {
+        return request;
+    }
+    request.valid = true;
+    request.function_code = frame[1];
+    request.start = get_le16(frame, 12);
+    request.count_or_value = get_le16(frame, 14);
+    if (request.function_code == 0x10 && frame.size() >= 19u + frame[16]) {
+        for (size_t i = 0; i + 1 < frame[16]; i += 2) {
+            request.values.push_back(get_le16(frame, 17 + i));
+        }
+    }
+    return request;
+}
+
+// ============================================================================
+// TCP (dongle protocol) side
+// ============================================================================
+
+/// 38-byte dongle request: 20-byte header, data frame, CRC over the data frame
+inline std::vector<uint8_t> tcp_request(uint8_t function_code, uint16_t start,
+                                        uint16_t count_or_value) {
+    std::vector<uint8_t> packet = {0xA1, 0x1A, 0x02, 0x00, 32, 0x00, 0x01, 0xC2};
+    packet.insert(packet.end(), TEST_DONGLE_SERIAL, TEST_DONGLE_SERIAL + 10);
+    put_le16(packet, 18);
+    packet.push_back(0x00); // Action
+    packet.push_back(function_code);
+    packet.insert(packet.end(), TEST_INVERTER_SERIAL, TEST_INVERTER_SERIAL + 10);
+    put_le16(packet, start);
+    put_le16(packet, count_or_value);
+    append_crc(packet, 20);
+    return packet;
+}
+
+inline std::vector<uint8_t> tcp_read_request(uint8_t function_code, uint16_t start,
+                                             uint16_t count) {
+    return tcp_request(function_code, start, count);
+}
+
+inline std::vector<uint8_t> tcp_write_single_request(uint16_t reg, uint16_t value) {
+    return tcp_request(0x06, reg, value);
+}
+
+/// Reply to a client: the inverter frame (without its CRC) starts at offset 20
+struct TcpReply {
+    bool valid = false;
+    uint8_t function_code = 0;
+    uint16_t start = 0;
+    uint8_t exception_code = 0;
+    std::vector<uint16_t> values;
+
+    bool is_exception() const { return (function_code & 0x80) != 0; }
+
+    /// True when the reply carries registers start..start+count-1 with their values
+    bool covers(uint16_t first, uint16_t count) const {
+        if (!valid || is_exception() || start != first || values.size() != count) {
+            return false;
+        }
+        for (uint16_t i = 0; i < count; i++) {
+            if (values[i] != register_value(static_cast<uint16_t>(first + i))) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+inline TcpReply parse_tcp_reply(const std::vector<uint8_t>& packet) {
+    TcpReply reply;
+    if (packet.size() < 37 || packet[0] != 0xA1 || packet[1] != 0x1A) {
+        return reply;
+    }
+    reply.function_code = packet[21];
+    reply.start = get_le16(packet, 32);
+    if (reply.is_exception()) {
+        reply.exception_code = packet[34];
+        reply.valid = true;
+        return reply;
+    }
+    if (reply.function_code == 0x06) {
+        reply.values.push_back(get_le16(packet, 34));
+        reply.valid = true;
+        return reply;
+    }
+    const size_t byte_count = packet[34];
+    if (packet.size() < 35 + byte_count) {
+        return reply;
+    }
+    for (size_t i = 0; i + 1 < byte_count; i += 2) {
+        reply.values.push_back(get_le16(packet, 35 + i));
+    }
+    reply.valid = true;
+    return reply;
+}
+
+} // namespace TestFrames
@@ -0,0 +1,269 @@
+/**
+ * @file test_main.cpp
+ * @brief RegisterShadow word-wise validity vs. the per-register reference
+ *
+ * Replays random store/invalidate/lookup sequences against a copy of the
+ * per-register shadow the word-at-a-time bitset replaced, then times both
+ * on the operations the bridge performs per request: a hit and a miss on a
+ * 40-register bank, a bank store, and a 125-register invalidation. Also
+ * covers resizing the tables to a heap-sized span.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#include "host_bench.h"
+#include "modules/register_shadow.h"
+#include "test_frames.h"
+
+#include <unity.h>
+
+#include <cstring>
+
+using TestFrames::TEST_INVERTER_SERIAL;
+
+/// The shadow table as it was before validity moved to whole-word operations
+class PerRegisterShadow {
+  public:
+    static constexpr uint16_t REGISTERS = RegisterShadow::REGISTERS_PER_TABLE;
+
+    PerRegisterShadow() { memset(valid_, 0, sizeof(valid_)); }
+
+    size_t store(uint16_t start, const uint16_t* values, size_t count, uint32_t now_ms) {
+        if (count == 0 || start >= REGISTERS) {
+            return 0;
+        }
+        if (start + count > REGISTERS) {
+            count = REGISTERS - start;
+        }
+        for (size_t i = 0; i < count; i++) {
+            const uint16_t reg = static_cast<uint16_t>(start + i);
+            values_[reg] = values[i];
+            stored_ms_[reg] = now_ms;
+            set_valid(reg);
+        }
+        return count;
+    }
+
+    size_t invalidate(uint16_t start, uint16_t count) {
+        if (count == 0 || start >= REGISTERS) {
+            return 0;
+        }
+        const uint32_t end = std::min<uint32_t>(static_cast<uint32_t>(start) + count, REGISTERS);
+        size_t dropped = 0;
+        for (uint32_t reg = start; reg < end; reg++) {
+            if (is_valid(reg)) {
+                clear_valid(reg);
+                dropped++;
+            }
+        }
+        return dropped;
+    }
+
+    bool range_age(uint16_t start, uint16_t count, uint32_t now_ms, uint32_t& age_ms) const {
+        if (count == 0 || static_cast<uint32_t>(start) + count > REGISTERS) {
+            return false;
+        }
+        uint32_t oldest = 0;
+        for (uint32_t reg = start; reg < static_cast<uint32_t>(start) + count; reg++) {
+            if (!is_valid(reg)) {
+                return false;
+            }
+            const uint32_t age = now_ms - stored_ms_[reg];
+            if (age > oldest) {
+                oldest = age;
+            }
+        }
+        age_ms = oldest;
+        return true;
+    }
+
+    size_t valid_count() const {
+        size_t count = 0;
+        for (uint32_t reg = 0; reg < REGISTERS; reg++) {
+            count += is_valid(reg);
+        }
+        return count;
+    }
+
+  private:
+    bool is_valid(uint32_t reg) const { return (valid_[reg >> 5] >> (reg & 31)) & 1u; }
+    void set_valid(uint32_t reg) { valid_[reg >> 5] |= 1u << (reg & 31); }
+    void clear_valid(uint32_t reg) { valid_[reg >> 5] &= ~(1u << (reg & 31)); }
+
+    uint16_t values_[REGISTERS];
+    uint32_t stored_ms_[REGISTERS];
+    uint32_t valid_[(REGISTERS + 31) / 32];
+};
+
+static const ModbusFunctionCode FUNC = ModbusFunctionCode::READ_INPUT;
+static const uint16_t BANK_SIZE = 40;
+
+static uint32_t rng_state = 1;
+
+static uint32_t next_random(uint32_t bound) {
+    rng_state = rng_state * 1103515245u + 12345u;
+    return (rng_state >> 8) % bound;
+}
+
+static uint16_t bank_values[MODBUS_MAX_REGISTERS];
+
+void setUp() {
+    for (uint16_t i = 0; i < MODBUS_MAX_REGISTERS; i++) {
+        bank_values[i] = TestFrames::register_value(i);
+    }
+}
+
+void tearDown() {}
+
+// ============================================================================
+// Equivalence
+// ============================================================================
+
+void test_word_wise_matches_per_register_reference() {
+    static RegisterShadow shadow;
+    static PerRegisterShadow reference;
+    const uint16_t limit = RegisterShadow::REGISTERS_PER_TABLE;
+    shadow.clear();
+    rng_state = 1;
+
+    for (uint32_t now = 0; now < 200000; now++) {
+        // Ranges straddle word boundaries and the end of the table
+        const uint16_t start = static_cast<uint16_t>(next_random(limit + 8));
+        const uint16_t count = static_cast<uint16_t>(next_random(MODBUS_MAX_REGISTERS) + 1);
+        switch (next_random(3)) {
+            case 0:
+                TEST_ASSERT_EQUAL_UINT32(
+                    reference.store(start, bank_values, count, now),
+                    shadow.store(FUNC, start, bank_values, count, TEST_INVERTER_SERIAL, now));
+                break;
+            case 1:
+                TEST_ASSERT_EQUAL_UINT32(reference.invalidate(start, count),
+                                         shadow.invalidate(FUNC, start, count));
+                break;
+            default: {
+                uint32_t expected_age = 0;
+                uint32_t age = 0;
+                const bool expected = reference.range_age(start, count, now, expected_age);
+                TEST_ASSERT_EQUAL(expected, shadow.range_age(FUNC, start, count, now, age));
+                if (expected) {
+                    TEST_ASSERT_EQUAL_UINT32(expected_age, age);
+                }
+                break;
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(reference.valid_count(), shadow.valid_count());
+}
+
+void test_resize_drops_registers_past_new_end() {
+    static RegisterShadow shadow;
+    uint32_t age = 0;
+    shadow.store(FUNC, 0, bank_values, BANK_SIZE, TEST_INVERTER_SERIAL, 0);
+    shadow.store(FUNC, 300, bank_values, BANK_SIZE, TEST_INVERTER_SERIAL, 0);
+    TEST_ASSERT_EQUAL_UINT32(2 * RegisterShadow::REGISTERS_PER_TABLE, shadow.capacity());
+
+    TEST_ASSERT_EQUAL_UINT32(BANK_SIZE, shadow.resize(RegisterShadow::MIN_REGISTERS_PER_TABLE));
+    TEST_ASSERT_EQUAL_UINT32(2 * RegisterShadow::MIN_REGISTERS_PER_TABLE, shadow.capacity());
+    TEST_ASSERT_TRUE(shadow.range_age(FUNC, 0, BANK_SIZE, 0, age));
+    TEST_ASSERT_FALSE(shadow.range_age(FUNC, 300, BANK_SIZE, 0, age));
+    TEST_ASSERT_EQUAL_UINT32(0, shadow.store(FUNC, 300, bank_values, BANK_SIZE,
+                                             TEST_INVERTER_SERIAL, 0));
+
+    // Growing adds empty registers; the kept ones stay valid
+    TEST_ASSERT_EQUAL_UINT32(0, shadow.resize(RegisterShadow::REGISTERS_PER_TABLE));
+    TEST_ASSERT_TRUE(shadow.range_age(FUNC, 0, BANK_SIZE, 0, age));
+    TEST_ASSERT_FALSE(shadow.range_age(FUNC, 300, BANK_SIZE, 0, age));
+    TEST_ASSERT_EQUAL_UINT32(BANK_SIZE, shadow.valid_count());
+
+    // Spans are clamped and rounded down to whole validity words
+    shadow.resize(RegisterShadow::MIN_REGISTERS_PER_TABLE + 40);
+    TEST_ASSERT_EQUAL_UINT16(RegisterShadow::MIN_REGISTERS_PER_TABLE + 32,
+                             shadow.registers_per_table());
+    shadow.resize(1);
+    TEST_ASSERT_EQUAL_UINT16(RegisterShadow::MIN_REGISTERS_PER_TABLE,
+                             shadow.registers_per_table());
+    shadow.resize(UINT16_MAX);
+    TEST_ASSERT_EQUAL_UINT16(RegisterShadow::REGISTERS_PER_TABLE, shadow.registers_per_table());
+}
+
+// ============================================================================
+// Benchmark
+// ============================================================================
+
+static const uint32_t ITERATIONS = 200000;
+
+static RegisterShadow bench_shadow;
+static PerRegisterShadow bench_reference;
+
+/// Banks 0..3 stored, with one hole in the last register of bank 3
+static void fill_bench_tables() {
+    bench_shadow.clear();
+    bench_reference = PerRegisterShadow();
+    for (uint16_t start = 0; start < 4 * BANK_SIZE; start += BANK_SIZE) {
+        bench_shadow.store(FUNC, start, bank_values, BANK_SIZE, TEST_INVERTER_SERIAL, 0);
+        bench_reference.store(start, bank_values, BANK_SIZE, 0);
+    }
+    bench_shadow.invalidate(FUNC, 4 * BANK_SIZE - 1, 1);
+    bench_reference.invalidate(4 * BANK_SIZE - 1, 1);
+}
+
+void test_benchmark_bank_hit() {
+    // A hit still scans every timestamp for the age, so this is reported only
+    fill_bench_tables();
+    uint32_t age = 0;
+    const double word_ns = HostBench::ns_per_call(
+        [&age] { return bench_shadow.range_age(FUNC, BANK_SIZE, BANK_SIZE, 1000, age); },
+        ITERATIONS);
+    const double reg_ns = HostBench::ns_per_call(
+        [&age] { return bench_reference.range_age(BANK_SIZE, BANK_SIZE, 1000, age); },
+        ITERATIONS);
+    HostBench::report("Hit 40 regs", "word-wise", word_ns, "per-register", reg_ns);
+}
+
+void test_benchmark_bank_miss() {
+    fill_bench_tables();
+    uint32_t age = 0;
+    const double word_ns = HostBench::ns_per_call(
+        [&age] { return bench_shadow.range_age(FUNC, 3 * BANK_SIZE, BANK_SIZE, 1000, age); },
+        ITERATIONS);
+    const double reg_ns = HostBench::ns_per_call(
+        [&age] { return bench_reference.range_age(3 * BANK_SIZE, BANK_SIZE, 1000, age); },
+        ITERATIONS);
+    HostBench::report("Miss 40 regs", "word-wise", word_ns, "per-register", reg_ns);
+    TEST_ASSERT_TRUE_MESSAGE(word_ns < reg_ns, "word-wise miss slower than per-register");
+}
+
+void test_benchmark_bank_store() {
+    const double word_ns = HostBench::ns_per_call(
+        [] {
+            return bench_shadow.store(FUNC, BANK_SIZE, bank_values, BANK_SIZE,
+                                      TEST_INVERTER_SERIAL, 1000);
+        },
+        ITERATIONS);
+    const double reg_ns = HostBench::ns_per_call(
+        [] { return bench_reference.store(BANK_SIZE, bank_values, BANK_SIZE, 1000); },
+        ITERATIONS);
+    HostBench::report("Store 40 regs", "word-wise", word_ns, "per-register", reg_ns);
+    TEST_ASSERT_TRUE_MESSAGE(word_ns < reg_ns, "word-wise store slower than per-register");
+}
+
+void test_benchmark_max_invalidate() {
+    const double word_ns = HostBench::ns_per_call(
+        [] { return bench_shadow.invalidate(FUNC, 3, MODBUS_MAX_REGISTERS); }, ITERATIONS);
+    const double reg_ns = HostBench::ns_per_call(
+        [] { return bench_reference.invalidate(3, MODBUS_MAX_REGISTERS); }, ITERATIONS);
+    HostBench::report("Invalidate 125 regs", "word-wise", word_ns, "per-register", reg_ns);
+    TEST_ASSERT_TRUE_MESSAGE(word_ns < reg_ns, "word-wise invalidate slower than per-register");
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_word_wise_matches_per_register_reference);
+    RUN_TEST(test_resize_drops_registers_past_new_end);
+    RUN_TEST(test_benchmark_bank_hit);
+    RUN_TEST(test_benchmark_bank_miss);
+    RUN_TEST(test_benchmark_bank_store);
+    RUN_TEST(test_benchmark_max_invalidate);
+    return UNITY_END();
+}
@@ -0,0 +1,160 @@
+/**
+ * @file test_main.cpp
+ * @brief Precomputed request frames vs. the field-by-field builders
+ *
+ * RequestTemplate (serial prefix with a folded CRC state) and the
+ * compile-time InverterFrames must produce exactly the bytes the original
+ * create_read_request()/create_write_request() builders produce, which in
+ * turn must match a frame assembled by hand from the documented layout.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#include "modules/inverter_protocol.h"
+#include "test_frames.h"
+
+#include <unity.h>
+
+#include <vector>
+
+static const ModbusFunctionCode READ_FUNCTIONS[] = {ModbusFunctionCode::READ_HOLDING,
+                                                    ModbusFunctionCode::READ_INPUT};
+
+struct Range {
+    uint16_t start;
+    uint16_t count;
+};
+
+// Serial probe, the standard 40-register banks, and the edges of the count range
+static const Range RANGES[] = {
+    {MODBUS_INVERTER_SN_START_REG, MODBUS_INVERTER_SN_REG_COUNT},
+    {0, 40},
+    {40, 40},
+    {80, 40},
+    {120, 40},
+    {160, 40},
+    {200, 40},
+    {0, 1},
+    {0, MODBUS_MAX_REGISTERS},
+    {0x1234, 7},
+    {0xFFFF, 1},
+};
+
+// Empty (zero serial), exact length, short (padded) and long (truncated)
+static const char* const SERIALS[] = {"", "ABCDEFGHIJ", "BA12345678", "AB1", "ABCDEFGHIJKLMN"};
+
+// Built entirely at compile time, as the firmware's serial probe is
+static constexpr InverterFrames::RequestFrame SERIAL_PROBE =
+    InverterFrames::zero_serial_read_request(ModbusFunctionCode::READ_INPUT,
+                                             MODBUS_INVERTER_SN_START_REG,
+                                             MODBUS_INVERTER_SN_REG_COUNT);
+
+static void assert_same_frame(const std::vector<uint8_t>& expected,
+                              const std::vector<uint8_t>& actual) {
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), actual.size());
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected.data(), actual.data(), expected.size());
+}
+
+void setUp() {}
+
+void tearDown() {}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+void test_legacy_builder_matches_documented_layout() {
+    for (ModbusFunctionCode func : READ_FUNCTIONS) {
+        for (const Range& range : RANGES) {
+            std::vector<uint8_t> legacy;
+            // Same serial bus_request() writes by default
+            TEST_ASSERT_TRUE(InverterProtocol::create_read_request(legacy, func, range.start,
+                                                                   range.count, "ABCDEFGHIJ"));
+            assert_same_frame(
+                TestFrames::bus_request(static_cast<uint8_t>(func), range.start, range.count),
+                legacy);
+        }
+    }
+}
+
+void test_template_read_matches_legacy_builder() {
+    for (const char* serial : SERIALS) {
+        RequestTemplate prefix;
+        prefix.set_serial(serial);
+        for (ModbusFunctionCode func : READ_FUNCTIONS) {
+            for (const Range& range : RANGES) {
+                std::vector<uint8_t> legacy;
+                std::vector<uint8_t> templated;
+                TEST_ASSERT_TRUE(InverterProtocol::create_read_request(
+                    legacy, func, range.start, range.count, serial));
+                TEST_ASSERT_TRUE(InverterProtocol::create_read_request(
+                    templated, prefix, func, range.start, range.count));
+                assert_same_frame(legacy, templated);
+            }
+        }
+    }
+}
+
+void test_template_write_matches_legacy_builder() {
+    const uint16_t single[] = {0x0102};
+    const uint16_t multi[] = {0x0001, 0x0203, 0xFFFF, 0x8000};
+    const Range writes[] = {{21, 1}, {0, 1}, {0xFFFF, 1}, {60, 4}, {0, 2}};
+
+    for (const char* serial : SERIALS) {
+        RequestTemplate prefix;
+        prefix.set_serial(serial);
+        for (const Range& write : writes) {
+            const uint16_t* values = write.count == 1 ? single : multi;
+            std::vector<uint8_t> legacy;
+            std::vector<uint8_t> templated;
+            TEST_ASSERT_TRUE(InverterProtocol::create_write_request(legacy, write.start, values,
+                                                                    write.count, serial));
+            TEST_ASSERT_TRUE(InverterProtocol::create_write_request(templated, prefix,
+                                                                    write.start, values,
+                                                                    write.count));
+            assert_same_frame(legacy, templated);
+        }
+    }
+}
+
+void test_template_follows_serial_change() {
+    RequestTemplate prefix;
+    prefix.set_serial("ABCDEFGHIJ");
+    prefix.set_serial("BA12345678");
+
+    std::vector<uint8_t> legacy;
+    std::vector<uint8_t> templated;
+    InverterProtocol::create_read_request(legacy, ModbusFunctionCode::READ_INPUT, 0, 40,
+                                          "BA12345678");
+    InverterProtocol::create_read_request(templated, prefix, ModbusFunctionCode::READ_INPUT, 0,
+                                          40);
+    assert_same_frame(legacy, templated);
+}
+
+void test_compile_time_frames_match_legacy_builder() {
+    std::vector<uint8_t> legacy;
+    InverterProtocol::create_read_request(legacy, ModbusFunctionCode::READ_INPUT,
+                                          MODBUS_INVERTER_SN_START_REG,
+                                          MODBUS_INVERTER_SN_REG_COUNT);
+    assert_same_frame(legacy, std::vector<uint8_t>(SERIAL_PROBE.begin(), SERIAL_PROBE.end()));
+
+    for (ModbusFunctionCode func : READ_FUNCTIONS) {
+        for (const Range& range : RANGES) {
+            const InverterFrames::RequestFrame frame =
+                InverterFrames::zero_serial_read_request(func, range.start, range.count);
+            InverterProtocol::create_read_request(legacy, func, range.start, range.count);
+            assert_same_frame(legacy, std::vector<uint8_t>(frame.begin(), frame.end()));
+        }
+    }
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_legacy_builder_matches_documented_layout);
+    RUN_TEST(test_template_read_matches_legacy_builder);
+    RUN_TEST(test_template_write_matches_legacy_builder);
+    RUN_TEST(test_template_follows_serial_change);
+    RUN_TEST(test_compile_time_frames_match_legacy_builder);
+    return UNITY_END();
+}
@@ -0,0 +1,189 @@
+/**
+ * @file test_main.cpp
+ * @brief RS485Manager line timing against a fake RS485Port
+ *
+ * Covers when a transaction completes (last CRC byte vs. line silence),
+ * when foreign frames are classified (idle boundary vs. inter-frame
+ * delay), carrier sense, where the response timeout starts, and that a
+ * timeout never stalls the caller.
+ *
+ * @license GPL-3.0
+ * @author OpenLux Contributors
+ */
+
+#include "config.h"
+#include "fake_rs485_port.h"
+#include "host_clock.h"
+#include "modules/rs485_manager.h"
+#include "test_frames.h"
+
+#include <unity.h>
+
+using namespace TestFrames;
+
+static FakeRS485Port port;
+static RS485Manager& rs485 = RS485Manager::getInstance();
+
+static void step(uint32_t ms) {
+    HostClock::advance(ms);
+    rs485.loop();
+}
+
+static bool send_input_read(uint16_t start, uint16_t count) {
+    return rs485.send_read_request(ModbusFunctionCode::READ_INPUT, start, count);
+}
+
+void setUp() {
+    // Let any idle tail and request gap from the previous test run out
+    port.set_tx_drain_ms(0);
+    step(RS485_FOREIGN_IDLE_TAIL_MS + RS485_MIN_REQUEST_GAP_MS);
+}
+
+void tearDown() {}
+
+// ============================================================================
+// Tests
+// ============================================================================
+
+void test_serial_probe_brings_link_up() {
+    rs485.loop();
+    TEST_ASSERT_TRUE(rs485.is_waiting_response());
+    const BusRequest probe = parse_bus_request(port.tx_frames().back());
+    TEST_ASSERT_EQUAL_UINT16(MODBUS_INVERTER_SN_START_REG, probe.start);
+
+    port.receive_frame(read_response(0x04, probe.start, probe.count_or_value));
+    step(5);
+
+    TEST_ASSERT_TRUE(rs485.is_inverter_link_up());
+}
+
+void test_response_completes_on_last_crc_byte() {
+    const uint32_t early_before = rs485.get_early_completions();
+    TEST_ASSERT_TRUE(send_input_read(0, 40));
+
+    // No idle boundary and no silence: only the CRC can end the transaction
+    port.inject(read_response(0x04, 0, 40));
+    step(1);
+
+    TEST_ASSERT_FALSE(rs485.is_waiting_response());
+    TEST_ASSERT_TRUE(rs485.get_last_result().success);
+    TEST_ASSERT_EQUAL_UINT32(early_before + 1, rs485.get_early_completions());
+}
+
+void test_split_response_waits_for_remaining_bytes() {
+    TEST_ASSERT_TRUE(send_input_read(40, 40));
+    const std::vector<uint8_t> response = read_response(0x04, 40, 40);
+    const std::vector<uint8_t> head(response.begin(), response.begin() + 30);
+    const std::vector<uint8_t> tail(response.begin() + 30, response.end());
+
+    port.inject(head);
+    step(1);
+    TEST_ASSERT_TRUE(rs485.is_waiting_response());
+
+    port.inject(tail);
+    step(1);
+    TEST_ASSERT_FALSE(rs485.is_waiting_response());
+    TEST_ASSERT_TRUE(rs485.get_last_result().success);
+    TEST_ASSERT_EQUAL_UINT16(40, rs485.get_last_result().start_address);
+}
+
+void test_foreign_request_is_classified_at_idle_boundary() {
+    const uint32_t foreign_before = rs485.get_external_requests_detected();
+
+    port.receive_frame(bus_request(0x04, 0, 40));
+    step(1);
+
+    // Well inside MODBUS_INTER_FRAME_DELAY_MS: the boundary alone ended the frame
+    TEST_ASSERT_EQUAL_UINT32(foreign_before + 1, rs485.get_external_requests_detected());
+}
+
+void test_foreign_frame_without_boundary_waits_for_silence() {
+    const uint32_t foreign_before = rs485.get_external_requests_detected();
+
+    port.inject(bus_request(0x03, 0, 40));
+    step(MODBUS_INTER_FRAME_DELAY_MS / 2);
+    TEST_ASSERT_EQUAL_UINT32(foreign_before, rs485.get_external_requests_detected());
+
+    step(MODBUS_INTER_FRAME_DELAY_MS);
+    TEST_ASSERT_EQUAL_UINT32(foreign_before + 1, rs485.get_external_requests_detected());
+}
+
+void test_foreign_traffic_holds_the_bus_for_idle_tail() {
+    port.receive_frame(bus_request(0x04, 80, 40));
+    step(1);
+
+    const size_t tx_before = port.tx_count();
+    TEST_ASSERT_FALSE(send_input_read(80, 40));
+    step(RS485_FOREIGN_IDLE_TAIL_MS - 10);
+    TEST_ASSERT_FALSE(send_input_read(80, 40));
+    TEST_ASSERT_EQUAL_UINT32(tx_before, port.tx_count());
+
+    step(20);
+    TEST_ASSERT_TRUE(send_input_read(80, 40));
+    port.inject(read_response(0x04, 80, 40));
+    step(1);
+    TEST_ASSERT_FALSE(rs485.is_waiting_response());
+}
+
+void test_bytes_mid_burst_block_transmission() {
+    const std::vector<uint8_t> foreign = bus_request(0x04, 120, 40);
+    port.inject(std::vector<uint8_t>(foreign.begin(), foreign.begin() + 6));
+    step(1);
+
+    TEST_ASSERT_FALSE(send_input_read(120, 40));
+
+    // Let the fragment age out as unknown traffic
+    step(MODBUS_INTER_FRAME_DELAY_MS + 10);
+}
+
+void test_response_timeout_starts_when_transmission_ends() {
+    static const uint32_t TX_DRAIN_MS = 200;
+    port.set_tx_drain_ms(TX_DRAIN_MS);
+    const uint32_t timeouts_before = rs485.get_timeout_count();
+
+    TEST_ASSERT_TRUE(send_input_read(160, 40));
+    for (uint32_t elapsed = 0; elapsed < MODBUS_RESPONSE_TIMEOUT_MS + TX_DRAIN_MS - 20;
+         elapsed += 10) {
+        step(10);
+    }
+    TEST_ASSERT_TRUE(rs485.is_waiting_response());
+
+    step(40);
+    TEST_ASSERT_FALSE(rs485.is_waiting_response());
+    TEST_ASSERT_EQUAL_UINT32(timeouts_before + 1, rs485.get_timeout_count());
+}
+
+void test_timeout_quiet_time_does_not_block() {
+    TEST_ASSERT_TRUE(send_input_read(200, 40));
+    step(1); // TX drained: the response timeout starts here
+    HostClock::advance(MODBUS_RESPONSE_TIMEOUT_MS + 10);
+
+    // The timeout is handled without sleeping: virtual time only moves in step()
+    const uint32_t before = millis();
+    rs485.loop();
+    TEST_ASSERT_EQUAL_UINT32(before, millis());
+    TEST_ASSERT_FALSE(rs485.is_waiting_response());
+
+    // Quiet time and request gap run out on later loop() calls
+    step(RS485_MIN_REQUEST_GAP_MS + RS485_TIMEOUT_QUIET_MS);
+    TEST_ASSERT_TRUE(send_input_read(200, 40));
+    port.inject(read_response(0x04, 200, 40));
+    step(1);
+    TEST_ASSERT_TRUE(rs485.get_last_result().success);
+}
+
+int main() {
+    rs485.begin(port);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_serial_probe_brings_link_up);
+    RUN_TEST(test_response_completes_on_last_crc_byte);
+    RUN_TEST(test_split_response_waits_for_remaining_bytes);
+    RUN_TEST(test_foreign_request_is_classified_at_idle_boundary);
+    RUN_TEST(test_foreign_frame_without_boundary_waits_for_silence);
+    RUN_TEST(test_foreign_traffic_holds_the_bus_for_idle_tail);
+    RUN_TEST(test_bytes_mid_burst_block_transmission);
+    RUN_TEST(test_response_timeout_starts_when_transmission_ends);
+    RUN_TEST(test_timeout_quiet_time_does_not_block);
+    return UNITY_END();
+}